@@ -8,6 +8,7 @@ include $(CLEAR_VARS)
 LOCAL_CPP_EXTENSION := .cpp
 LOCAL_CPPFLAGS := -std=c++14
 LOCAL_CFLAGS := -Wall -Wextra
+LOCAL_ARM_NEON := true
 
 # NDK_BUILD Build Settings
 LOCAL_MODULE := CppAndroidEngineJNI
@@ -21,6 +22,8 @@ LOCAL_C_INCLUDES := $(LOCAL_PATH)/../src/main/cpp/Engine/ \
 
 LOCAL_SRC_FILES := $(LOCAL_PATH)/../src/main/cpp/Engine/utils.cpp \
                    $(LOCAL_PATH)/../src/main/cpp/Engine/clock.cpp \
+                   $(LOCAL_PATH)/../src/main/cpp/Engine/allocator.cpp \
+                   $(LOCAL_PATH)/../src/main/cpp/Engine/allocation_tracker.cpp \
                    $(LOCAL_PATH)/../src/main/cpp/Engine/touchscreen.cpp \
                    $(LOCAL_PATH)/../src/main/cpp/Engine/graphics_context.cpp \
                    $(LOCAL_PATH)/../src/main/cpp/Engine/asset_manager.cpp \
@@ -28,8 +31,23 @@ LOCAL_SRC_FILES := $(LOCAL_PATH)/../src/main/cpp/Engine/utils.cpp \
                    $(LOCAL_PATH)/../src/main/cpp/Engine/shader_compiler.cpp \
                    $(LOCAL_PATH)/../src/main/cpp/Engine/vertex_buffer.cpp \
                    $(LOCAL_PATH)/../src/main/cpp/Engine/index_buffer.cpp \
+                   $(LOCAL_PATH)/../src/main/cpp/Engine/pixel_ops.cpp \
+                   $(LOCAL_PATH)/../src/main/cpp/Engine/qoi.cpp \
                    $(LOCAL_PATH)/../src/main/cpp/Engine/texture2d.cpp \
+                   $(LOCAL_PATH)/../src/main/cpp/Engine/texture_upload.cpp \
+                   $(LOCAL_PATH)/../src/main/cpp/Engine/texture_cache.cpp \
+                   $(LOCAL_PATH)/../src/main/cpp/Engine/sprite_batch.cpp \
+                   $(LOCAL_PATH)/../src/main/cpp/Engine/sprite_mesh.cpp \
                    $(LOCAL_PATH)/../src/main/cpp/Engine/sprite.cpp \
+                   $(LOCAL_PATH)/../src/main/cpp/Engine/culling.cpp \
+                   $(LOCAL_PATH)/../src/main/cpp/Engine/render_queue.cpp \
+                   $(LOCAL_PATH)/../src/main/cpp/Engine/kinematics.cpp \
+                   $(LOCAL_PATH)/../src/main/cpp/Engine/collision.cpp \
+                   $(LOCAL_PATH)/../src/main/cpp/Engine/collision_mask.cpp \
+                   $(LOCAL_PATH)/../src/main/cpp/Engine/animation.cpp \
+                   $(LOCAL_PATH)/../src/main/cpp/Engine/gpu_sprite_layer.cpp \
+                   $(LOCAL_PATH)/../src/main/cpp/Engine/bitmap_font.cpp \
+                   $(LOCAL_PATH)/../src/main/cpp/Engine/entity_store.cpp \
                    $(LOCAL_PATH)/../src/main/cpp/main.cpp
 
 # Build as shared library
@@ -0,0 +1,40 @@
+attribute vec4 Position;    // Quad origin at spawn time, work resolution units
+attribute vec4 Color;
+attribute vec2 Corner;      // 0 or 1 on each axis
+attribute vec4 Animation;   // Clip, start time, scale (XY)
+attribute vec4 Motion;      // Velocity (XY), spawn time, unused
+
+varying vec4 v_Color;
+varying vec2 v_TexCoord;
+varying float v_TexIndex;
+
+uniform mat4 ModelViewProj;
+uniform vec2 WorkResScale;
+uniform vec2 AtlasSize;
+uniform vec4 Tint;
+uniform float Time;
+
+// Sizes must match g_maxGpuAnimationClips and g_maxGpuAnimationFrames
+uniform vec4 Clips[16];     // First frame, frame count, seconds per frame, 1 when it holds its last frame
+uniform vec4 Frames[48];    // U0 V0 U1 V1
+
+void main()
+{
+    vec4 clip = Clips[int(Animation.x + 0.5)];
+
+    float elapsedFrames = floor(max(Time - Animation.y, 0.0) / clip.z);
+    float frame = (clip.w > 0.5) ? min(elapsedFrames, clip.y - 1.0) : mod(elapsedFrames, clip.y);
+
+    vec4 region = Frames[int(clip.x + frame + 0.5)];
+    vec2 size = (region.zw - region.xy) * AtlasSize * Animation.zw;
+
+    // Straight line from the spawn point, GetGpuSpritePosition mirrors this for the CPU side
+    vec2 origin = Position.xy + Motion.xy * (Time - Motion.z);
+    vec2 position = (origin + Corner * size) * WorkResScale;
+    vec4 color = Color * Tint;
+
+    gl_Position = vec4(position, 0.0, 1.0) * ModelViewProj;
+    v_TexCoord = mix(region.xy, region.zw, Corner);
+    v_TexIndex = 0.0;   // The layer binds its texture to the first unit
+    v_Color = vec4(color.rgb * color.a, color.a);    // Premultiplied like the textures
+}
\ No newline at end of file
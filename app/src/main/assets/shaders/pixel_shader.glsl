@@ -2,16 +2,26 @@ precision mediump float;
 
 varying vec4 v_Color;
 varying vec2 v_TexCoord;
+varying float v_TexIndex;
 
-uniform sampler2D tex2d;
+// GLSL ES 1.0 can't index samplers with a varying, select the unit by hand
+uniform sampler2D Textures[8];
 
-void main()
+vec4 SampleTexture(const float slot)
 {
-    vec4 texColor = texture2D(tex2d, v_TexCoord);
-
-    if (texColor.a < 0.1) {
-        discard;
-    }
+    if (slot < 0.5) return texture2D(Textures[0], v_TexCoord);
+    if (slot < 1.5) return texture2D(Textures[1], v_TexCoord);
+    if (slot < 2.5) return texture2D(Textures[2], v_TexCoord);
+    if (slot < 3.5) return texture2D(Textures[3], v_TexCoord);
+    if (slot < 4.5) return texture2D(Textures[4], v_TexCoord);
+    if (slot < 5.5) return texture2D(Textures[5], v_TexCoord);
+    if (slot < 6.5) return texture2D(Textures[6], v_TexCoord);
+    return texture2D(Textures[7], v_TexCoord);
+}
 
-    gl_FragColor = texColor * v_Color;
+void main()
+{
+    // No discard, it would disable early depth and hidden surface removal on tiled GPUs.
+    // Textures are premultiplied, fully transparent texels blend to nothing.
+    gl_FragColor = SampleTexture(v_TexIndex) * v_Color;
 }
\ No newline at end of file
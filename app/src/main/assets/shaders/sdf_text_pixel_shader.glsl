@@ -0,0 +1,46 @@
+precision mediump float;
+
+varying vec4 v_Color;
+varying vec2 v_TexCoord;
+varying float v_TexIndex;
+
+// GLSL ES 1.0 can't index samplers with a varying, select the unit by hand
+uniform sampler2D Textures[8];
+
+// Distance units, 0.5 is the glyph edge. Derivatives are optional in GLSL ES 1.0,
+// the antialiasing width comes from the draw scale instead
+uniform float Smoothing;
+uniform float OutlineWidth;
+uniform vec4 OutlineColor;
+uniform vec2 ShadowOffset;
+uniform vec4 ShadowColor;
+
+float SampleDistance(const float slot, const vec2 uv)
+{
+    if (slot < 0.5) return texture2D(Textures[0], uv).a;
+    if (slot < 1.5) return texture2D(Textures[1], uv).a;
+    if (slot < 2.5) return texture2D(Textures[2], uv).a;
+    if (slot < 3.5) return texture2D(Textures[3], uv).a;
+    if (slot < 4.5) return texture2D(Textures[4], uv).a;
+    if (slot < 5.5) return texture2D(Textures[5], uv).a;
+    if (slot < 6.5) return texture2D(Textures[6], uv).a;
+    return texture2D(Textures[7], uv).a;
+}
+
+void main()
+{
+    const float edge = 0.5;
+
+    float field = SampleDistance(v_TexIndex, v_TexCoord);
+
+    // Colors are premultiplied, each layer goes under the previous one
+    vec4 fill = v_Color * smoothstep(edge - Smoothing, edge + Smoothing, field);
+
+    float outlineEdge = edge - OutlineWidth;
+    vec4 color = fill + OutlineColor * smoothstep(outlineEdge - Smoothing, outlineEdge + Smoothing, field) * (1.0 - fill.a);
+
+    float shadowDistance = SampleDistance(v_TexIndex, v_TexCoord - ShadowOffset);
+    float shadow = smoothstep(outlineEdge - Smoothing, outlineEdge + Smoothing, shadowDistance);
+
+    gl_FragColor = color + ShadowColor * shadow * (1.0 - color.a);
+}
\ No newline at end of file
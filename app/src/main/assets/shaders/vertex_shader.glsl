@@ -1,9 +1,11 @@
 attribute vec4 Position;
 attribute vec4 Color;
 attribute vec2 TexCoord;
+attribute float TexIndex;
 
 varying vec4 v_Color;
 varying vec2 v_TexCoord;
+varying float v_TexIndex;
 
 uniform mat4 ModelViewProj;
 
@@ -11,5 +13,6 @@ void main()
 {
     gl_Position = Position * ModelViewProj;
     v_TexCoord = TexCoord;
-    v_Color = Color;
+    v_TexIndex = TexIndex;
+    v_Color = vec4(Color.rgb * Color.a, Color.a);    // Premultiplied like the textures
 }
\ No newline at end of file
@@ -0,0 +1,275 @@
+#include "allocation_tracker.h"
+
+#include "utils.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <new>
+#include <pthread.h>
+
+constexpr const size_t g_allocationHeaderSize = 16;     // Keeps the alignment malloc hands out
+
+static AllocationStats g_allocationStats;
+static AllocationFrameStats g_allocationFrame;
+static AllocationTag g_allocationTag = AllocationTag::Engine;
+
+static pthread_t g_allocationFrameThread;
+static bool g_isInAllocationFrame = false;
+static bool g_isSteadyState = false;
+static uint32_t g_steadyStateFrame = 0;
+
+static const char* const g_allocationTagNames[(uint32_t)AllocationTag::Count] = {
+    "Engine", "Textures", "Entities", "Game", "Render"
+};
+
+inline bool IsAllocationFrameThread()
+{
+    return g_isInAllocationFrame && pthread_equal(pthread_self(), g_allocationFrameThread);
+}
+
+inline void TrackFrameAllocation(const size_t size, const void* site)
+{
+    AllocationFrameStats& frame = g_allocationFrame;
+    AllocationCounters& tag = frame.Tags[(uint32_t)g_allocationTag];
+
+    frame.Heap.Allocations++;
+    frame.Heap.Bytes += size;
+
+    tag.Allocations++;
+    tag.Bytes += size;
+
+    for (uint32_t index = 0; index < frame.SiteCount; ++index)
+    {
+        if (frame.Sites[index].Address == site) {
+            frame.Sites[index].Allocations++;
+            frame.Sites[index].Bytes += size;
+            return;
+        }
+    }
+
+    if (frame.SiteCount < g_maxAllocationSites) {
+        frame.Sites[frame.SiteCount++] = { site, 1, size };
+    }
+}
+
+inline void CountAllocation(const size_t size, const void* site)
+{
+    __atomic_fetch_add(&g_allocationStats.Total.Allocations, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&g_allocationStats.Total.Bytes, (uint64_t)size, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&g_allocationStats.LiveAllocations, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&g_allocationStats.LiveBytes, (uint64_t)size, __ATOMIC_RELAXED);
+
+    if (IsAllocationFrameThread()) {
+        TrackFrameAllocation(size, site);
+    }
+}
+
+inline void CountFree(const size_t size)
+{
+    __atomic_fetch_add(&g_allocationStats.Total.Frees, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&g_allocationStats.LiveAllocations, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&g_allocationStats.LiveBytes, (uint64_t)size, __ATOMIC_RELAXED);
+
+    if (IsAllocationFrameThread()) {
+        g_allocationFrame.Heap.Frees++;
+        g_allocationFrame.Tags[(uint32_t)g_allocationTag].Frees++;
+    }
+}
+
+#if TRACK_ALLOCATIONS == 1
+
+inline void* TrackedAllocate(const size_t size, const void* site)
+{
+    uint8_t* block = (uint8_t*)malloc(size + g_allocationHeaderSize);
+
+    if (!block) {
+        return nullptr;
+    }
+
+    // Size in front of the block, delete doesn't get told how big it was
+    memcpy(block, &size, sizeof(size));
+    CountAllocation(size, site);
+
+    return block + g_allocationHeaderSize;
+}
+
+inline void TrackedFree(void* memory)
+{
+    if (!memory) {
+        return;
+    }
+
+    uint8_t* block = (uint8_t*)memory - g_allocationHeaderSize;
+
+    size_t size;
+    memcpy(&size, block, sizeof(size));
+
+    CountFree(size);
+    free(block);
+}
+
+// Built without exceptions, running out of memory ends the process like an uncaught bad_alloc would
+inline void* TrackedAllocateOrAbort(const size_t size, const void* site)
+{
+    void* memory = TrackedAllocate(size, site);
+
+    if (!memory) {
+        LogError("gfxError: Out of memory allocating %d bytes :: operator new()", (int32_t)size);
+        abort();
+    }
+
+    return memory;
+}
+
+void* operator new(size_t size)
+{
+    return TrackedAllocateOrAbort(size, __builtin_return_address(0));
+}
+
+void* operator new[](size_t size)
+{
+    return TrackedAllocateOrAbort(size, __builtin_return_address(0));
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return TrackedAllocate(size, __builtin_return_address(0));
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return TrackedAllocate(size, __builtin_return_address(0));
+}
+
+void operator delete(void* memory) noexcept
+{
+    TrackedFree(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    TrackedFree(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    TrackedFree(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    TrackedFree(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    TrackedFree(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+    TrackedFree(memory);
+}
+
+#endif
+
+void BeginAllocationFrame()
+{
+    memset(&g_allocationFrame, 0, sizeof(g_allocationFrame));
+
+    g_allocationTag = AllocationTag::Engine;
+    g_allocationFrameThread = pthread_self();
+    g_isInAllocationFrame = true;
+}
+
+void EndAllocationFrame()
+{
+    g_isInAllocationFrame = false;
+    g_allocationTag = AllocationTag::Engine;
+
+    g_allocationStats.LastFrame = g_allocationFrame;
+    g_allocationStats.FrameIndex++;
+
+    const bool isChecked = g_isSteadyState && g_allocationStats.FrameIndex >= g_steadyStateFrame;
+
+    if (isChecked && g_allocationFrame.Heap.Allocations > 0)
+    {
+        LogError("gfxError: Steady state frame %d allocated on the heap :: EndAllocationFrame()", g_allocationStats.FrameIndex);
+        LogAllocationFrame(g_allocationFrame);
+
+        assert(g_allocationFrame.Heap.Allocations == 0 && "Heap allocation in the steady state frame loop");
+    }
+}
+
+AllocationTag SetAllocationTag(const AllocationTag& tag)
+{
+    const AllocationTag previous = g_allocationTag;
+    g_allocationTag = tag;
+
+    return previous;
+}
+
+void SetAllocationSteadyState(const bool isSteady)
+{
+    g_isSteadyState = isSteady;
+    g_steadyStateFrame = g_allocationStats.FrameIndex + g_allocationWarmupFrames;
+}
+
+void TrackHeapAllocation(const uint32_t size, const void* site)
+{
+    CountAllocation(size, site);
+}
+
+void TrackHeapFree(const uint32_t size)
+{
+    CountFree(size);
+}
+
+void TrackArenaAllocation(const uint32_t size, const bool overflowed)
+{
+    if (!IsAllocationFrameThread()) {
+        return;
+    }
+
+    g_allocationFrame.ArenaAllocations++;
+    g_allocationFrame.ArenaBytes += size;
+    g_allocationFrame.ArenaOverflows += overflowed ? 1 : 0;
+}
+
+const AllocationStats& GetAllocationStats()
+{
+    return g_allocationStats;
+}
+
+void LogAllocationFrame(const AllocationFrameStats& stats)
+{
+    LogDebug("Heap: %d allocations, %d frees, %d bytes. Arenas: %d allocations, %d bytes, %d overflows",
+             stats.Heap.Allocations, stats.Heap.Frees, (int32_t)stats.Heap.Bytes,
+             stats.ArenaAllocations, (int32_t)stats.ArenaBytes, stats.ArenaOverflows);
+
+    for (uint32_t tag = 0; tag < (uint32_t)AllocationTag::Count; ++tag)
+    {
+        const AllocationCounters& counters = stats.Tags[tag];
+
+        if (counters.Allocations > 0 || counters.Frees > 0) {
+            LogDebug("  %s: %d allocations, %d frees, %d bytes", g_allocationTagNames[tag],
+                     counters.Allocations, counters.Frees, (int32_t)counters.Bytes);
+        }
+    }
+
+    // Offsets are into the shared library, addr2line resolves the ones without an exported symbol
+    for (uint32_t index = 0; index < stats.SiteCount; ++index)
+    {
+        const AllocationSite& site = stats.Sites[index];
+
+        Dl_info info;
+        const bool isResolved = dladdr(site.Address, &info) != 0;
+
+        const char* symbol = (isResolved && info.dli_sname) ? info.dli_sname : "?";
+        const uintptr_t offset = isResolved ? (uintptr_t)site.Address - (uintptr_t)info.dli_fbase : (uintptr_t)site.Address;
+
+        LogDebug("  %s (+0x%x): %d allocations, %d bytes", symbol, (uint32_t)offset, site.Allocations, (int32_t)site.Bytes);
+    }
+}
\ No newline at end of file
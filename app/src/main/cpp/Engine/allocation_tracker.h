@@ -0,0 +1,81 @@
+#ifndef ALLOCATION_TRACKER_H
+#define ALLOCATION_TRACKER_H
+
+#include <cstdint>
+
+// Replaces the global operator new / delete with counting versions, every block pays a small size header.
+// On by default in debug builds only, pass -DTRACK_ALLOCATIONS=0 or 1 to override.
+// malloc'd memory (stb_image, decoded texels) isn't seen either way
+#ifndef TRACK_ALLOCATIONS
+#ifndef NDEBUG
+#define TRACK_ALLOCATIONS 1
+#else
+#define TRACK_ALLOCATIONS 0
+#endif
+#endif
+
+constexpr const uint32_t g_maxAllocationSites = 16;
+constexpr const uint32_t g_allocationWarmupFrames = 60;    // Frames between enabling the steady state and checking it
+
+typedef enum class ALLOCATION_TAG : uint32_t {
+    Engine,         // Anything outside the tagged stages of the frame
+    Textures,
+    Entities,
+    Game,
+    Render,
+    Count
+} AllocationTag;
+
+typedef struct {
+    uint32_t Allocations;
+    uint32_t Frees;
+    uint64_t Bytes;         // Requested by the allocations
+} AllocationCounters;
+
+typedef struct {
+    const void* Address;    // Return address into the caller of operator new
+    uint32_t Allocations;
+    uint64_t Bytes;
+} AllocationSite;
+
+// Heap traffic of the thread running the frame, other threads only show up in the totals
+typedef struct {
+    AllocationCounters Heap;
+    AllocationCounters Tags[(uint32_t)AllocationTag::Count];
+    AllocationSite Sites[g_maxAllocationSites];     // The first distinct call sites of the frame
+    uint32_t SiteCount;
+    uint32_t ArenaAllocations;      // Served by the engine arenas, overflows are counted as heap allocations too
+    uint64_t ArenaBytes;
+    uint32_t ArenaOverflows;
+} AllocationFrameStats;
+
+typedef struct {
+    AllocationCounters Total;       // Every thread since startup
+    uint64_t LiveBytes;
+    uint32_t LiveAllocations;
+    uint32_t FrameIndex;
+    AllocationFrameStats LastFrame;
+} AllocationStats;
+
+// Frames are counted on the calling thread, allocations of other threads never make it into a frame
+void BeginAllocationFrame();
+
+// Once the steady state is reached, a frame with heap allocations is logged with its call sites
+// and asserts in debug builds
+void EndAllocationFrame();
+
+// Returns the previous tag, allocations of the frame are charged to the current one
+AllocationTag SetAllocationTag(const AllocationTag& tag);
+
+// Checks start g_allocationWarmupFrames after enabling, so lazily created resources can settle first
+void SetAllocationSteadyState(const bool isSteady);
+
+// Engine allocator instrumentation, the heap allocator reports its blocks whether operator new is replaced or not
+void TrackHeapAllocation(const uint32_t size, const void* site);
+void TrackHeapFree(const uint32_t size);
+void TrackArenaAllocation(const uint32_t size, const bool overflowed);
+
+const AllocationStats& GetAllocationStats();
+void LogAllocationFrame(const AllocationFrameStats& stats);
+
+#endif // ALLOCATION_TRACKER_H
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include "allocator.h"
+
+#include "allocation_tracker.h"
+#include "utils.h"
+
+#include <cstdlib>
+
+SCRATCH_SCOPE::SCRATCH_SCOPE(LinearArena& arena) : Arena(arena), Marker(arena.Offset), Fallbacks(arena.Fallbacks)
+{
+}
+
+SCRATCH_SCOPE::~SCRATCH_SCOPE()
+{
+    RewindLinearArena(Arena, Marker, Fallbacks);
+}
+
+// In front of every heap allocator block, frees are reported to the tracker with their size
+typedef struct {
+    uint32_t Size;
+    uint32_t Offset;        // From the start of the block
+} HeapBlockHeader;
+
+void* HeapAllocate(void*, const uint32_t size, const uint32_t alignment)
+{
+    // new[] only promises 8 bytes on 32-bit ARM. The header takes a whole alignment step so the memory keeps it
+    const uint32_t blockAlignment = (alignment > g_defaultAllocationAlignment) ? alignment : g_defaultAllocationAlignment;
+    void* block = nullptr;
+
+    if (posix_memalign(&block, blockAlignment, blockAlignment + size) != 0) {
+        LogError("gfxError: Out of memory allocating %u bytes :: HeapAllocate()", size);
+        return nullptr;
+    }
+
+    uint8_t* memory = (uint8_t*)block + blockAlignment;
+    *((HeapBlockHeader*)memory - 1) = { size, blockAlignment };
+
+    TrackHeapAllocation(size, __builtin_return_address(0));
+    return memory;
+}
+
+void HeapFree(void*, void* memory)
+{
+    if (!memory) {
+        return;
+    }
+
+    const HeapBlockHeader header = *((const HeapBlockHeader*)memory - 1);
+
+    TrackHeapFree(header.Size);
+    free((uint8_t*)memory - header.Offset);
+}
+
+inline void ReleaseArenaFallbacks(LinearArena& arena, const ArenaFallback* until)
+{
+    while (arena.Fallbacks && arena.Fallbacks != until)
+    {
+        ArenaFallback* fallback = arena.Fallbacks;
+
+        arena.Fallbacks = fallback->Next;
+        HeapFree(nullptr, fallback->Block);
+    }
+}
+
+void CreateLinearArena(LinearArena& arena, const uint32_t capacity)
+{
+    arena.Base      = new uint8_t[capacity];
+    arena.Capacity  = capacity;
+    arena.Offset    = 0;
+    arena.HighWater = 0;
+    arena.Overflows = 0;
+    arena.Fallbacks = nullptr;
+}
+
+void DestroyLinearArena(LinearArena& arena)
+{
+    ReleaseArenaFallbacks(arena, nullptr);
+    delete[] arena.Base;
+
+    arena.Base     = nullptr;
+    arena.Capacity = 0;
+    arena.Offset   = 0;
+}
+
+void* ArenaAllocate(LinearArena& arena, const uint32_t size, const uint32_t alignment)
+{
+    // Aligned on the address, the base itself only has the alignment of new[]
+    const uintptr_t address = (uintptr_t)(arena.Base + arena.Offset);
+    const uintptr_t aligned = (address + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    const uint32_t offset = arena.Offset + (uint32_t)(aligned - address);
+
+    if (offset > arena.Capacity || size > arena.Capacity - offset) {
+        return nullptr;
+    }
+
+    arena.Offset = offset + size;
+
+    if (arena.Offset > arena.HighWater) {
+        arena.HighWater = arena.Offset;
+    }
+
+    return arena.Base + offset;
+}
+
+void ResetLinearArena(LinearArena& arena)
+{
+    ReleaseArenaFallbacks(arena, nullptr);
+    arena.Offset = 0;
+}
+
+void RewindLinearArena(LinearArena& arena, const uint32_t marker, const ArenaFallback* fallbacks)
+{
+    ReleaseArenaFallbacks(arena, fallbacks);
+
+    if (marker <= arena.Offset) {
+        arena.Offset = marker;
+    }
+}
+
+bool IsArenaMemory(const LinearArena& arena, const void* memory)
+{
+    return (const uint8_t*)memory >= arena.Base && (const uint8_t*)memory < arena.Base + arena.Capacity;
+}
+
+inline void* ArenaAllocatorAllocate(void* user, const uint32_t size, const uint32_t alignment)
+{
+    LinearArena& arena = *(LinearArena*)user;
+    void* memory = ArenaAllocate(arena, size, alignment);
+
+    TrackArenaAllocation(size, memory == nullptr);
+
+    if (memory) {
+        return memory;
+    }
+
+    LogDebug("LinearArena overflow, %d bytes from the heap", size);
+
+    // The list link goes in front of the memory, padded so the memory keeps its alignment
+    const uint32_t padding = ((uint32_t)sizeof(ArenaFallback) + alignment - 1) & ~(alignment - 1);
+    uint8_t* block = (uint8_t*)HeapAllocate(nullptr, padding + size, alignment);
+
+    if (!block) {
+        return nullptr;
+    }
+
+    ArenaFallback* fallback = (ArenaFallback*)(block + padding) - 1;
+
+    fallback->Next  = arena.Fallbacks;
+    fallback->Block = block;
+
+    arena.Fallbacks = fallback;
+    arena.Overflows++;
+
+    return block + padding;
+}
+
+inline void ArenaAllocatorFree(void* user, void* memory)
+{
+    LinearArena& arena = *(LinearArena*)user;
+
+    if (IsArenaMemory(arena, memory)) {
+        return;
+    }
+
+    const ArenaFallback* fallback = (const ArenaFallback*)memory - 1;
+
+    for (ArenaFallback** link = &arena.Fallbacks; *link; link = &(*link)->Next)
+    {
+        if (*link == fallback) {
+            *link = fallback->Next;
+            HeapFree(nullptr, fallback->Block);
+            return;
+        }
+    }
+}
+
+Allocator GetArenaAllocator(LinearArena& arena)
+{
+    return { ArenaAllocatorAllocate, ArenaAllocatorFree, &arena };
+}
\ No newline at end of file
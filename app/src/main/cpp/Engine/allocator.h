@@ -0,0 +1,82 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <cstdint>
+
+constexpr const uint32_t g_defaultAllocationAlignment = 16;
+constexpr const uint32_t g_frameArenaSize = 256 * 1024;            // Bytes
+constexpr const uint32_t g_scratchArenaSize = 2 * 1024 * 1024;     // Bytes, fits the game atlas load without mipmaps
+
+// Engine functions with temporaries take one of these instead of calling new, the caller picks where they live.
+// Only for trivially constructible data, nothing is constructed or destroyed
+typedef struct {
+    void* (*Allocate)(void* user, const uint32_t size, const uint32_t alignment);
+    void (*Free)(void* user, void* memory);
+    void* User;
+} Allocator;
+
+// Heap block of an allocation that didn't fit, stored right in front of the memory handed out
+typedef struct ARENA_FALLBACK {
+    struct ARENA_FALLBACK* Next;
+    void* Block;
+} ArenaFallback;
+
+// Bump allocator, individual frees are no-ops and everything goes away on reset or rewind.
+// Allocations that don't fit fall back to the heap instead of failing, reset and rewind release those too
+typedef struct {
+    uint8_t* Base;
+    uint32_t Capacity;
+    uint32_t Offset;
+    uint32_t HighWater;     // Largest offset reached since creation
+    uint32_t Overflows;     // Allocations sent to the heap since creation
+    ArenaFallback* Fallbacks;   // Newest first
+} LinearArena;
+
+// Rewinds the arena to where it was on construction, so scopes have to nest
+typedef struct SCRATCH_SCOPE {
+    explicit SCRATCH_SCOPE(LinearArena& arena);
+    ~SCRATCH_SCOPE();
+
+    SCRATCH_SCOPE(const SCRATCH_SCOPE&) = delete;
+    SCRATCH_SCOPE& operator=(const SCRATCH_SCOPE&) = delete;
+
+    LinearArena& Arena;
+    uint32_t Marker;
+    ArenaFallback* Fallbacks;
+} ScratchScope;
+
+void* HeapAllocate(void* user, const uint32_t size, const uint32_t alignment);
+void HeapFree(void* user, void* memory);
+
+// Aligned malloc / free, the default of every function taking an allocator
+constexpr const Allocator g_heapAllocator = { HeapAllocate, HeapFree, nullptr };
+
+void CreateLinearArena(LinearArena& arena, const uint32_t capacity);
+void DestroyLinearArena(LinearArena& arena);
+
+// nullptr when the arena is full, GetArenaAllocator handles the fallback
+void* ArenaAllocate(LinearArena& arena, const uint32_t size, const uint32_t alignment = g_defaultAllocationAlignment);
+void ResetLinearArena(LinearArena& arena);
+
+// Heap fallbacks made after the given list head are released as well
+void RewindLinearArena(LinearArena& arena, const uint32_t marker, const ArenaFallback* fallbacks);
+bool IsArenaMemory(const LinearArena& arena, const void* memory);
+
+// Free releases heap fallbacks right away and ignores arena memory, the rest waits for the reset or rewind
+Allocator GetArenaAllocator(LinearArena& arena);
+
+template<typename T>
+inline T* AllocateArray(const Allocator& allocator, const uint32_t count)
+{
+    const uint32_t alignment = (alignof(T) > g_defaultAllocationAlignment) ? (uint32_t)alignof(T) : g_defaultAllocationAlignment;
+    return (T*)allocator.Allocate(allocator.User, count * (uint32_t)sizeof(T), alignment);
+}
+
+inline void FreeArray(const Allocator& allocator, void* memory)
+{
+    if (memory) {
+        allocator.Free(allocator.User, memory);
+    }
+}
+
+#endif // ALLOCATOR_H
\ No newline at end of file
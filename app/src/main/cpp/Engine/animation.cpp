@@ -0,0 +1,140 @@
+#include "animation.h"
+
+#include "utils.h"
+
+#include <cstring>
+
+// On disk records, little endian like every target
+typedef struct {
+    char Name[g_animationClipNameLength];
+    uint16_t FirstFrame;
+    uint16_t FrameCount;
+    float FrameTime;
+    uint32_t Mode;
+} AnimationClipRecord;
+
+typedef struct {
+    uint16_t X;
+    uint16_t Y;
+    uint16_t Width;
+    uint16_t Height;
+} AnimationFrameRecord;
+
+void CreateAnimationLibrary(Asset& asset, AnimationLibrary& library, const Allocator& scratch)
+{
+    library.Frames     = nullptr;
+    library.FrameCount = 0;
+    library.Clips      = nullptr;
+    library.ClipCount  = 0;
+
+    uint32_t header[6] = { 0, 0, 0, 0, 0, 0 };     // Magic, version, clip count, frame count, atlas width, atlas height
+
+    if (asset.GetLength() < sizeof(header)) {
+        LogError("gfxError: Animation file is too small :: CreateAnimationLibrary()");
+        return;
+    }
+
+    asset.Read((char*)header, sizeof(header));
+
+    if (header[0] != g_animationMagic || header[1] != g_animationVersion) {
+        LogError("gfxError: Unknown animation file format :: CreateAnimationLibrary()");
+        return;
+    }
+
+    const uint32_t clipCount  = header[2];
+    const uint32_t frameCount = header[3];
+
+    // Clips with invalid ranges fall back to frame 0, which has to exist
+    if (frameCount == 0) {
+        LogError("gfxError: Animation file has no frames :: CreateAnimationLibrary()");
+        return;
+    }
+
+    // 64-bit so huge counts in a corrupt header can't wrap around and pass
+    const uint64_t recordsSize = (uint64_t)clipCount * sizeof(AnimationClipRecord) + (uint64_t)frameCount * sizeof(AnimationFrameRecord);
+
+    if (asset.GetLength() < sizeof(header) + recordsSize) {
+        LogError("gfxError: Truncated animation file :: CreateAnimationLibrary()");
+        return;
+    }
+
+    AnimationClipRecord* clipRecords = AllocateArray<AnimationClipRecord>(scratch, clipCount);
+    AnimationFrameRecord* frameRecords = AllocateArray<AnimationFrameRecord>(scratch, frameCount);
+
+    asset.Read((char*)clipRecords, clipCount * sizeof(AnimationClipRecord));
+    asset.Read((char*)frameRecords, frameCount * sizeof(AnimationFrameRecord));
+
+    library.Clips  = new AnimationClip[clipCount];
+    library.Frames = new AnimationFrame[frameCount];
+
+    library.ClipCount  = clipCount;
+    library.FrameCount = frameCount;
+
+    // UVs are normalized once here, nothing divides by the atlas size per frame afterwards
+    const float invWidth  = 1.0f / (float)header[4];
+    const float invHeight = 1.0f / (float)header[5];
+
+    for (uint32_t index = 0; index < frameCount; ++index)
+    {
+        const AnimationFrameRecord& record = frameRecords[index];
+        AnimationFrame& frame = library.Frames[index];
+
+        frame.Region = { (float)record.X, (float)record.Y, record.Width, record.Height };
+
+        frame.UV[0] = record.X * invWidth;
+        frame.UV[1] = record.Y * invHeight;
+        frame.UV[2] = (record.X + record.Width) * invWidth;
+        frame.UV[3] = (record.Y + record.Height) * invHeight;
+    }
+
+    for (uint32_t index = 0; index < clipCount; ++index)
+    {
+        const AnimationClipRecord& record = clipRecords[index];
+        AnimationClip& clip = library.Clips[index];
+
+        memcpy(clip.Name, record.Name, g_animationClipNameLength);
+        clip.Name[g_animationClipNameLength - 1] = '\0';
+
+        clip.FirstFrame = record.FirstFrame;
+        clip.FrameCount = record.FrameCount;
+        clip.FrameTime  = (record.FrameTime > 0.0f) ? record.FrameTime : 1.0f;
+        clip.Mode       = (record.Mode == (uint32_t)AnimationMode::Once) ? AnimationMode::Once : AnimationMode::Loop;
+
+        // A clip reaching outside the pool is kept but shows nothing but its first valid frame
+        if (clip.FrameCount == 0 || clip.FirstFrame + clip.FrameCount > frameCount)
+        {
+            LogError("gfxError: Animation clip %s has invalid frames :: CreateAnimationLibrary()", clip.Name);
+
+            clip.FirstFrame = 0;
+            clip.FrameCount = 1;
+        }
+
+        clip.Duration = clip.FrameTime * clip.FrameCount;
+    }
+
+    FreeArray(scratch, frameRecords);
+    FreeArray(scratch, clipRecords);
+}
+
+void DestroyAnimationLibrary(AnimationLibrary& library)
+{
+    delete[] library.Frames;
+    delete[] library.Clips;
+
+    library.Frames     = nullptr;
+    library.Clips      = nullptr;
+    library.FrameCount = 0;
+    library.ClipCount  = 0;
+}
+
+uint32_t FindAnimationClip(const AnimationLibrary& library, const char* name)
+{
+    for (uint32_t index = 0; index < library.ClipCount; ++index)
+    {
+        if (strncmp(library.Clips[index].Name, name, g_animationClipNameLength) == 0) {
+            return index;
+        }
+    }
+
+    return g_invalidAnimationClip;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include "allocator.h"
+#include "asset.h"
+#include "gfx_math.h"
+
+#include <cstdint>
+
+// Generated offline by tools/anim_packer, keep the record layout in sync with it
+constexpr const uint32_t g_animationMagic = 0x4D494E41;    // "ANIM"
+constexpr const uint32_t g_animationVersion = 1;
+constexpr const uint32_t g_animationClipNameLength = 16;
+constexpr const uint32_t g_invalidAnimationClip = 0xFFFFFFFF;
+
+typedef enum class ANIMATION_MODE : uint32_t {
+    Loop,
+    Once        // Holds the last frame once the clip is over
+} AnimationMode;
+
+typedef enum class ANIMATION_EVENT_TYPE : uint32_t {
+    Looped,
+    Finished
+} AnimationEventType;
+
+typedef struct {
+    Rect2D Region;          // Texels, also the key of the sprite mesh and collision mask lookups
+    float UV[4];            // Region normalized to the atlas, U0 V0 U1 V1
+} AnimationFrame;
+
+typedef struct {
+    char Name[g_animationClipNameLength];
+    uint32_t FirstFrame;    // Into the library frame pool
+    uint32_t FrameCount;
+    float FrameTime;        // Seconds per frame
+    float Duration;
+    AnimationMode Mode;
+} AnimationClip;
+
+// Frames of every clip sit back to back in a single pool
+typedef struct {
+    AnimationFrame* Frames;
+    uint32_t FrameCount;
+    AnimationClip* Clips;
+    uint32_t ClipCount;
+} AnimationLibrary;
+
+// File records are read into scratch memory, the clips and frames are kept on the heap
+void CreateAnimationLibrary(Asset& asset, AnimationLibrary& library, const Allocator& scratch = g_heapAllocator);
+void DestroyAnimationLibrary(AnimationLibrary& library);
+
+// Returns g_invalidAnimationClip when there's no clip with that name
+uint32_t FindAnimationClip(const AnimationLibrary& library, const char* name);
+
+// Frame shown at a time into the clip, Once clips hold their last frame
+inline uint32_t GetAnimationClipFrame(const AnimationClip& clip, const float time)
+{
+    // Range checked as a float, converting a negative or out of range value to uint32_t is undefined
+    const float frame = time / clip.FrameTime;
+
+    if (!(frame > 0.0f)) {
+        return 0;
+    } return (frame < (float)clip.FrameCount) ? (uint32_t)frame : clip.FrameCount - 1;
+}
+
+#endif // ANIMATION_H
\ No newline at end of file
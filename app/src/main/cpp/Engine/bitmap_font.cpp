@@ -0,0 +1,790 @@
+#include "bitmap_font.h"
+
+#include "utils.h"
+
+#include <cstring>
+
+constexpr const uint32_t g_replacementCodepoint = 0xFFFD;
+constexpr const uint64_t g_fnvOffsetBasis = 0xCBF29CE484222325ull;
+constexpr const uint64_t g_fnvPrime = 0x100000001B3ull;
+
+/// FONT
+
+inline bool IsFontLine(const char* line, const char* tag)
+{
+    const size_t length = strlen(tag);
+    return strncmp(line, tag, length) == 0 && (line[length] == ' ' || line[length] == '\t');
+}
+
+// Values are looked up as " key=", the tag at the start of the line never matches
+inline int32_t ReadFontValue(const char* line, const char* end, const char* key, const int32_t fallback = 0)
+{
+    const size_t length = strlen(key);
+
+    for (const char* cursor = line; cursor + length + 1 < end; ++cursor)
+    {
+        if ((*cursor == ' ' || *cursor == '\t') && strncmp(cursor + 1, key, length) == 0 && cursor[length + 1] == '=') {
+            return (int32_t)strtol(cursor + length + 2, nullptr, 10);
+        }
+    }
+
+    return fallback;
+}
+
+void CreateBitmapFont(Asset& asset, const Texture2D& texture, BitmapFont& font, const Allocator& scratch)
+{
+    font.Glyphs         = nullptr;
+    font.GlyphCount     = 0;
+    font.Kernings       = nullptr;
+    font.KerningCount   = 0;
+    font.FallbackGlyph  = g_invalidFontGlyph;
+    font.LineHeight     = 0.0f;
+    font.Base           = 0.0f;
+    font.DistanceSpread = 0.0f;
+    font.Texture        = &texture;
+
+    for (uint16_t& glyph : font.AsciiGlyphs) {
+        glyph = g_invalidFontGlyph;
+    }
+
+    const uint32_t length = asset.GetLength();
+
+    char* source = AllocateArray<char>(scratch, length + 1);
+    asset.Read(source, length);
+    source[length] = '\0';
+
+    // Counted first, the count attributes of the descriptor aren't trusted
+    uint32_t glyphCount = 0;
+    uint32_t kerningCount = 0;
+
+    for (const char* line = source; line != nullptr; )
+    {
+        glyphCount   += IsFontLine(line, "char") ? 1 : 0;
+        kerningCount += IsFontLine(line, "kerning") ? 1 : 0;
+
+        line = strchr(line, '\n');
+        line = line ? line + 1 : nullptr;
+    }
+
+    font.Glyphs   = new FontGlyph[glyphCount];
+    font.Kernings = (kerningCount > 0) ? new FontKerning[kerningCount] : nullptr;
+
+    float invWidth  = 1.0f / (float)texture.Width;
+    float invHeight = 1.0f / (float)texture.Height;
+
+    for (const char* line = source; line < source + length; )
+    {
+        const char* newline = strchr(line, '\n');
+        const char* end = newline ? newline : source + length;
+
+        if (IsFontLine(line, "common"))
+        {
+            font.LineHeight = (float)ReadFontValue(line, end, "lineHeight");
+            font.Base       = (float)ReadFontValue(line, end, "base");
+
+            // The page size the metrics were made against, the texture may be a rescaled copy
+            const int32_t scaleW = ReadFontValue(line, end, "scaleW");
+            const int32_t scaleH = ReadFontValue(line, end, "scaleH");
+
+            if (scaleW > 0 && scaleH > 0) {
+                invWidth  = 1.0f / (float)scaleW;
+                invHeight = 1.0f / (float)scaleH;
+            }
+
+            if (ReadFontValue(line, end, "pages", 1) > 1) {
+                LogError("gfxError: Only the first page of the font is used :: CreateBitmapFont()");
+            }
+        }
+
+        else if (IsFontLine(line, "sdf")) {
+            font.DistanceSpread = (float)ReadFontValue(line, end, "spread");
+        }
+
+        else if (IsFontLine(line, "char") && ReadFontValue(line, end, "page") == 0)
+        {
+            FontGlyph& glyph = font.Glyphs[font.GlyphCount++];
+
+            const int32_t x = ReadFontValue(line, end, "x");
+            const int32_t y = ReadFontValue(line, end, "y");
+            const int32_t width  = ReadFontValue(line, end, "width");
+            const int32_t height = ReadFontValue(line, end, "height");
+
+            glyph.Codepoint = (uint32_t)ReadFontValue(line, end, "id");
+            glyph.Region    = { (float)x, (float)y, (uint32_t)width, (uint32_t)height };
+            glyph.OffsetX   = (float)ReadFontValue(line, end, "xoffset");
+            glyph.OffsetY   = (float)ReadFontValue(line, end, "yoffset");
+            glyph.Advance   = (float)ReadFontValue(line, end, "xadvance");
+
+            glyph.UV[0] = x * invWidth;
+            glyph.UV[1] = y * invHeight;
+            glyph.UV[2] = (x + width) * invWidth;
+            glyph.UV[3] = (y + height) * invHeight;
+        }
+
+        else if (IsFontLine(line, "kerning"))
+        {
+            const uint64_t first  = (uint64_t)(uint32_t)ReadFontValue(line, end, "first");
+            const uint64_t second = (uint64_t)(uint32_t)ReadFontValue(line, end, "second");
+
+            font.Kernings[font.KerningCount++] = { (first << 32) | second, (float)ReadFontValue(line, end, "amount") };
+        }
+
+        line = newline ? newline + 1 : end;
+    }
+
+    FreeArray(scratch, source);
+
+    font.TexelSize = { invWidth, invHeight };
+
+    // Generators write ascending ids already, insertion sort only walks them once then
+    for (uint32_t index = 1; index < font.GlyphCount; ++index)
+    {
+        const FontGlyph glyph = font.Glyphs[index];
+        uint32_t position = index;
+
+        for (; position > 0 && font.Glyphs[position - 1].Codepoint > glyph.Codepoint; --position) {
+            font.Glyphs[position] = font.Glyphs[position - 1];
+        }
+
+        font.Glyphs[position] = glyph;
+    }
+
+    for (uint32_t index = 1; index < font.KerningCount; ++index)
+    {
+        const FontKerning kerning = font.Kernings[index];
+        uint32_t position = index;
+
+        for (; position > 0 && font.Kernings[position - 1].Pair > kerning.Pair; --position) {
+            font.Kernings[position] = font.Kernings[position - 1];
+        }
+
+        font.Kernings[position] = kerning;
+    }
+
+    for (uint32_t index = 0; index < font.GlyphCount && font.Glyphs[index].Codepoint < g_fontAsciiGlyphs; ++index) {
+        font.AsciiGlyphs[font.Glyphs[index].Codepoint] = (uint16_t)index;
+    }
+
+    font.FallbackGlyph = font.AsciiGlyphs['?'];
+
+    if (font.GlyphCount == 0) {
+        LogError("gfxError: Font has no glyphs :: CreateBitmapFont()");
+    }
+}
+
+void DestroyBitmapFont(BitmapFont& font)
+{
+    delete[] font.Glyphs;
+    delete[] font.Kernings;
+
+    font.Glyphs       = nullptr;
+    font.GlyphCount   = 0;
+    font.Kernings     = nullptr;
+    font.KerningCount = 0;
+}
+
+uint16_t FindFontGlyph(const BitmapFont& font, const uint32_t codepoint)
+{
+    if (codepoint < g_fontAsciiGlyphs) {
+        return font.AsciiGlyphs[codepoint];
+    }
+
+    uint32_t low = 0;
+    uint32_t high = font.GlyphCount;
+
+    while (low < high)
+    {
+        const uint32_t middle = (low + high) / 2;
+
+        if (font.Glyphs[middle].Codepoint < codepoint) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return (low < font.GlyphCount && font.Glyphs[low].Codepoint == codepoint) ? (uint16_t)low : g_invalidFontGlyph;
+}
+
+float GetFontKerning(const BitmapFont& font, const uint32_t first, const uint32_t second)
+{
+    const uint64_t pair = ((uint64_t)first << 32) | second;
+
+    uint32_t low = 0;
+    uint32_t high = font.KerningCount;
+
+    while (low < high)
+    {
+        const uint32_t middle = (low + high) / 2;
+
+        if (font.Kernings[middle].Pair < pair) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return (low < font.KerningCount && font.Kernings[low].Pair == pair) ? font.Kernings[low].Amount : 0.0f;
+}
+
+/// LAYOUT
+
+// Malformed sequences decode to U+FFFD one byte at a time, the cursor always moves forward
+inline uint32_t DecodeUtf8(const char*& cursor, const char* end)
+{
+    const uint8_t lead = (uint8_t)*cursor++;
+
+    if (lead < 0x80) {
+        return lead;
+    }
+
+    const uint32_t extra = (lead >= 0xF0) ? 3 : (lead >= 0xE0) ? 2 : (lead >= 0xC0) ? 1 : 0;
+
+    if (extra == 0 || cursor + extra > end) {
+        return g_replacementCodepoint;
+    }
+
+    uint32_t codepoint = lead & (0x3F >> extra);
+
+    for (uint32_t index = 0; index < extra; ++index)
+    {
+        const uint8_t next = (uint8_t)cursor[index];
+
+        if ((next & 0xC0) != 0x80) {
+            return g_replacementCodepoint;
+        }
+
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+
+    cursor += extra;
+    return codepoint;
+}
+
+inline void AlignTextLine(TextGlyph* glyphs, const uint32_t first, const uint32_t count, const float width, const TextAlign& align)
+{
+    const float shift = (align == TextAlign::Right) ? -width : (align == TextAlign::Center) ? -width * 0.5f : 0.0f;
+
+    if (shift == 0.0f) {
+        return;
+    }
+
+    for (uint32_t index = first; index < count; ++index) {
+        glyphs[index].Quad[0] += shift;
+        glyphs[index].Quad[2] += shift;
+    }
+}
+
+uint32_t LayoutText(const TextStyle& style, const char* text, const uint32_t length, TextGlyph* glyphs,
+                    const uint32_t maxGlyphs, Vec2& size)
+{
+    const BitmapFont& font = *style.Font;
+
+    const char* cursor = text;
+    const char* end = text + length;
+
+    uint32_t count = 0;
+    uint32_t lineStart = 0;
+    uint32_t previous = 0;
+
+    float penX = 0.0f;
+    float penY = 0.0f;
+
+    size = { 0.0f, 0.0f };
+
+    while (cursor < end)
+    {
+        const uint32_t codepoint = DecodeUtf8(cursor, end);
+
+        if (codepoint == '\n')
+        {
+            AlignTextLine(glyphs, lineStart, count, penX, style.Align);
+
+            size.X = (penX > size.X) ? penX : size.X;
+            penX = 0.0f;
+            penY += font.LineHeight * style.Scale.Y;
+
+            lineStart = count;
+            previous = 0;
+            continue;
+        }
+
+        uint16_t glyphIndex = FindFontGlyph(font, codepoint);
+        glyphIndex = (glyphIndex != g_invalidFontGlyph) ? glyphIndex : font.FallbackGlyph;
+
+        if (glyphIndex == g_invalidFontGlyph) {
+            continue;
+        }
+
+        const FontGlyph& glyph = font.Glyphs[glyphIndex];
+
+        if (previous != 0 && font.KerningCount > 0) {
+            penX += GetFontKerning(font, previous, glyph.Codepoint) * style.Scale.X;
+        }
+
+        // Blank glyphs only move the pen
+        if (glyph.Region.Width > 0 && glyph.Region.Height > 0 && count < maxGlyphs)
+        {
+            TextGlyph& quad = glyphs[count++];
+
+            quad.Quad[0] = penX + glyph.OffsetX * style.Scale.X;
+            quad.Quad[1] = penY + glyph.OffsetY * style.Scale.Y;
+            quad.Quad[2] = quad.Quad[0] + glyph.Region.Width * style.Scale.X;
+            quad.Quad[3] = quad.Quad[1] + glyph.Region.Height * style.Scale.Y;
+
+            memcpy(quad.UV, glyph.UV, sizeof(quad.UV));
+        }
+
+        penX += (glyph.Advance + style.Tracking) * style.Scale.X;
+        previous = glyph.Codepoint;
+    }
+
+    AlignTextLine(glyphs, lineStart, count, penX, style.Align);
+
+    size.X = (penX > size.X) ? penX : size.X;
+    size.Y = penY + font.LineHeight * style.Scale.Y;
+
+    return count;
+}
+
+/// LAYOUT CACHE
+
+inline uint64_t HashBytes(uint64_t hash, const void* data, const uint32_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+
+    for (uint32_t index = 0; index < size; ++index) {
+        hash = (hash ^ bytes[index]) * g_fnvPrime;
+    }
+
+    return hash;
+}
+
+inline uint64_t HashTextLayout(const TextStyle& style, const char* text, const uint32_t length)
+{
+    uint64_t hash = HashBytes(g_fnvOffsetBasis, text, length);
+
+    hash = HashBytes(hash, &style.Font, sizeof(style.Font));
+    hash = HashBytes(hash, &style.Scale, sizeof(style.Scale));
+    hash = HashBytes(hash, &style.Align, sizeof(style.Align));
+    hash = HashBytes(hash, &style.Tracking, sizeof(style.Tracking));
+
+    return hash;
+}
+
+inline bool IsSameTextLayout(const TextLayout& layout, const uint64_t hash, const TextStyle& style,
+                             const char* text, const uint32_t length)
+{
+    return layout.Hash == hash && layout.Font == style.Font && layout.Length == length &&
+           layout.Scale.X == style.Scale.X && layout.Scale.Y == style.Scale.Y &&
+           layout.Align == style.Align && layout.Tracking == style.Tracking &&
+           memcmp(layout.Text, text, length) == 0;
+}
+
+void CreateTextLayoutCache(TextLayoutCache& cache, const uint32_t capacity)
+{
+    cache.Layouts  = new TextLayout[capacity];
+    cache.Count    = 0;
+    cache.Capacity = capacity;
+    cache.Clock    = 0;
+    cache.Stats    = { 0, 0, 0, 0 };
+}
+
+void DestroyTextLayoutCache(TextLayoutCache& cache)
+{
+    delete[] cache.Layouts;
+
+    cache.Layouts  = nullptr;
+    cache.Count    = 0;
+    cache.Capacity = 0;
+}
+
+const TextLayout* FindTextLayout(TextLayoutCache& cache, const TextStyle& style, const char* text, const uint32_t length)
+{
+    if (length > g_maxTextLayoutBytes) {
+        cache.Stats.Uncached++;
+        return nullptr;
+    }
+
+    const uint64_t hash = HashTextLayout(style, text, length);
+    cache.Clock++;
+
+    for (uint32_t index = 0; index < cache.Count; ++index)
+    {
+        TextLayout& layout = cache.Layouts[index];
+
+        if (IsSameTextLayout(layout, hash, style, text, length)) {
+            layout.LastUsed = cache.Clock;
+            cache.Stats.Hits++;
+            return &layout;
+        }
+    }
+
+    uint32_t slot = cache.Count;
+
+    // Full, the layout nobody asked for the longest goes
+    if (cache.Count == cache.Capacity)
+    {
+        slot = 0;
+
+        for (uint32_t index = 1; index < cache.Count; ++index)
+        {
+            if (cache.Layouts[index].LastUsed < cache.Layouts[slot].LastUsed) {
+                slot = index;
+            }
+        }
+
+        cache.Stats.Evictions++;
+    } else {
+        cache.Count++;
+    }
+
+    TextLayout& layout = cache.Layouts[slot];
+
+    layout.Hash     = hash;
+    layout.Font     = style.Font;
+    layout.Scale    = style.Scale;
+    layout.Align    = style.Align;
+    layout.Tracking = style.Tracking;
+    layout.Length   = length;
+    layout.LastUsed = cache.Clock;
+
+    memcpy(layout.Text, text, length);
+
+    layout.GlyphCount = LayoutText(style, text, length, layout.Glyphs, g_maxTextLayoutGlyphs, layout.Size);
+    cache.Stats.Misses++;
+
+    return &layout;
+}
+
+void ForgetTextLayouts(TextLayoutCache& cache, const BitmapFont& font)
+{
+    uint32_t kept = 0;
+
+    for (uint32_t index = 0; index < cache.Count; ++index)
+    {
+        if (cache.Layouts[index].Font != &font) {
+            cache.Layouts[kept++] = cache.Layouts[index];
+        }
+    }
+
+    cache.Count = kept;
+}
+
+/// TEXT LAYER
+
+inline void PremultiplyColor(const uint32_t color, float* output)
+{
+    float r, g, b, a;
+    DwordToColorNormalized(color, r, g, b, a);
+
+    output[0] = r * a;
+    output[1] = g * a;
+    output[2] = b * a;
+    output[3] = a;
+}
+
+inline void MakeTextEffect(const TextStyle& style, const Vec2& workResScale, TextEffect& effect)
+{
+    memset(&effect, 0, sizeof(effect));
+
+    const BitmapFont& font = *style.Font;
+
+    if (font.DistanceSpread <= 0.0f) {
+        return;
+    }
+
+    // The field goes from 0 to 1 across twice the spread, one display pixel is this much of it
+    const float range = 2.0f * font.DistanceSpread;
+    const float scaleX = style.Scale.X * workResScale.X;
+    const float scaleY = style.Scale.Y * workResScale.Y;
+    const float texelsPerPixel = 1.0f / (((scaleX < scaleY) ? scaleX : scaleY) * range);
+
+    // Half a pixel on each side of the edge, capped so tiny text still has an edge to find
+    effect.Smoothing = (0.5f * texelsPerPixel < 0.25f) ? 0.5f * texelsPerPixel : 0.25f;
+
+    if (style.OutlineWidth > 0.0f)
+    {
+        const float width = style.OutlineWidth / range;
+        effect.OutlineWidth = (width < 0.5f - effect.Smoothing) ? width : 0.5f - effect.Smoothing;
+
+        PremultiplyColor(style.OutlineColor, effect.OutlineColor);
+    }
+
+    if (style.ShadowOffset.X != 0.0f || style.ShadowOffset.Y != 0.0f)
+    {
+        effect.ShadowOffset[0] = style.ShadowOffset.X * font.TexelSize.X;
+        effect.ShadowOffset[1] = style.ShadowOffset.Y * font.TexelSize.Y;
+
+        PremultiplyColor(style.ShadowColor, effect.ShadowColor);
+    }
+}
+
+inline bool CanExtendTextRun(const TextRun& run, const Texture2D* texture, const bool isDistanceField, const TextEffect& effect)
+{
+    return run.Texture == texture && run.IsDistanceField == isDistanceField &&
+           (!isDistanceField || memcmp(&run.Effect, &effect, sizeof(effect)) == 0);
+}
+
+void CreateDistanceFieldRenderer(DistanceFieldRenderer& renderer, const uint32_t program, QuadIndexBuffer& indexBuffer)
+{
+    renderer.Program = program;
+
+    renderer.Uniforms.ModelViewProj = glGetUniformLocation(program, "ModelViewProj");
+    renderer.Uniforms.Smoothing     = glGetUniformLocation(program, "Smoothing");
+    renderer.Uniforms.OutlineWidth  = glGetUniformLocation(program, "OutlineWidth");
+    renderer.Uniforms.OutlineColor  = glGetUniformLocation(program, "OutlineColor");
+    renderer.Uniforms.ShadowOffset  = glGetUniformLocation(program, "ShadowOffset");
+    renderer.Uniforms.ShadowColor   = glGetUniformLocation(program, "ShadowColor");
+
+    // Text only, a few hundred glyphs per flush is plenty
+    CreateSpriteBatch(renderer.Batch, program, indexBuffer, g_maxTextLayerGlyphs);
+}
+
+void DestroyDistanceFieldRenderer(DistanceFieldRenderer& renderer)
+{
+    DestroySpriteBatch(renderer.Batch);
+    renderer.Program = 0;
+}
+
+void CreateTextLayer(TextLayer& layer, TextLayoutCache& cache, const uint32_t capacity)
+{
+    layer.Vertices   = new SpriteVertex[4 * capacity];
+    layer.Scratch    = new TextGlyph[capacity];
+    layer.RunCount   = 0;
+    layer.GlyphCount = 0;
+    layer.Capacity   = capacity;
+    layer.Cache      = &cache;
+}
+
+void DestroyTextLayer(TextLayer& layer)
+{
+    delete[] layer.Scratch;
+    delete[] layer.Vertices;
+
+    layer.Vertices = nullptr;
+    layer.Scratch  = nullptr;
+    layer.Capacity = 0;
+}
+
+void DrawText(TextLayer& layer, const TextStyle& style, const char* text, const Vec2& position, const Vec2& workResScale)
+{
+    const uint32_t length = (uint32_t)strlen(text);
+
+    if (length == 0 || !style.Font || !style.Font->Texture) {
+        return;
+    }
+
+    const TextGlyph* glyphs;
+    uint32_t glyphCount;
+
+    // Strings too long for the cache are laid out in the layer's own scratch, every time
+    const TextLayout* layout = FindTextLayout(*layer.Cache, style, text, length);
+
+    if (layout)
+    {
+        glyphs = layout->Glyphs;
+        glyphCount = layout->GlyphCount;
+    }
+
+    else
+    {
+        Vec2 size;
+        glyphs = layer.Scratch;
+        glyphCount = LayoutText(style, text, length, layer.Scratch, layer.Capacity - layer.GlyphCount, size);
+    }
+
+    if (layer.GlyphCount + glyphCount > layer.Capacity) {
+        LogError("gfxError: Text layer is full :: DrawText()");
+        glyphCount = layer.Capacity - layer.GlyphCount;
+    }
+
+    const Texture2D* texture = style.Font->Texture;
+    const bool isDistanceField = style.Font->DistanceSpread > 0.0f;
+
+    TextEffect effect;
+    MakeTextEffect(style, workResScale, effect);
+
+    if (layer.RunCount == 0 || !CanExtendTextRun(layer.Runs[layer.RunCount - 1], texture, isDistanceField, effect))
+    {
+        if (layer.RunCount == g_maxTextRuns) {
+            LogError("gfxError: Out of text runs :: DrawText()");
+            return;
+        }
+
+        layer.Runs[layer.RunCount++] = { texture, layer.GlyphCount, 0, isDistanceField, effect };
+    }
+
+    float r, g, b, a;
+    DwordToColorNormalized(style.Color, r, g, b, a);
+
+    SpriteVertex* vertices = &layer.Vertices[4 * layer.GlyphCount];
+
+    // Same corner order as the sprite quads, the texture slot is assigned by the batch
+    for (uint32_t index = 0; index < glyphCount; ++index, vertices += 4)
+    {
+        const TextGlyph& glyph = glyphs[index];
+
+        const float x0 = (position.X + glyph.Quad[0]) * workResScale.X;
+        const float y0 = (position.Y + glyph.Quad[1]) * workResScale.Y;
+        const float x1 = (position.X + glyph.Quad[2]) * workResScale.X;
+        const float y1 = (position.Y + glyph.Quad[3]) * workResScale.Y;
+
+        vertices[0] = { { x0, y0, 0.0f }, { r, g, b, a }, { glyph.UV[0], glyph.UV[1] }, 0.0f };
+        vertices[1] = { { x1, y1, 0.0f }, { r, g, b, a }, { glyph.UV[2], glyph.UV[3] }, 0.0f };
+        vertices[2] = { { x0, y1, 0.0f }, { r, g, b, a }, { glyph.UV[0], glyph.UV[3] }, 0.0f };
+        vertices[3] = { { x1, y0, 0.0f }, { r, g, b, a }, { glyph.UV[2], glyph.UV[1] }, 0.0f };
+    }
+
+    layer.GlyphCount += glyphCount;
+    layer.Runs[layer.RunCount - 1].GlyphCount += glyphCount;
+}
+
+Vec2 MeasureText(TextLayoutCache& cache, const TextStyle& style, const char* text)
+{
+    const uint32_t length = (uint32_t)strlen(text);
+    const TextLayout* layout = FindTextLayout(cache, style, text, length);
+
+    if (layout) {
+        return layout->Size;
+    }
+
+    // Only the size is wanted, no glyph is written
+    Vec2 size;
+    LayoutText(style, text, length, nullptr, 0, size);
+
+    return size;
+}
+
+void FlushTextLayer(TextLayer& layer, SpriteBatch& batch, DistanceFieldRenderer* distanceField, const Matrix& modelViewProj)
+{
+    for (uint32_t run = 0; run < layer.RunCount; ++run)
+    {
+        const TextRun& textRun = layer.Runs[run];
+        const uint32_t end = textRun.FirstGlyph + textRun.GlyphCount;
+
+        if (!textRun.IsDistanceField)
+        {
+            for (uint32_t index = textRun.FirstGlyph; index < end; ++index) {
+                SpriteBatchDraw(batch, *textRun.Texture, &layer.Vertices[4 * index]);
+            }
+
+            continue;
+        }
+
+        if (!distanceField) {
+            continue;
+        }
+
+        // Bitmap glyphs queued before this run go first, then the run with its own program and uniforms
+        FlushSpriteBatch(batch);
+
+        const DistanceFieldUniforms& uniforms = distanceField->Uniforms;
+        const TextEffect& effect = textRun.Effect;
+
+        glUseProgram(distanceField->Program);
+
+        glUniformMatrix4fv(uniforms.ModelViewProj, 1, GL_FALSE, &modelViewProj.M[0][0]);
+        glUniform1f(uniforms.Smoothing, effect.Smoothing);
+        glUniform1f(uniforms.OutlineWidth, effect.OutlineWidth);
+        glUniform4fv(uniforms.OutlineColor, 1, effect.OutlineColor);
+        glUniform2fv(uniforms.ShadowOffset, 1, effect.ShadowOffset);
+        glUniform4fv(uniforms.ShadowColor, 1, effect.ShadowColor);
+
+        for (uint32_t index = textRun.FirstGlyph; index < end; ++index) {
+            SpriteBatchDraw(distanceField->Batch, *textRun.Texture, &layer.Vertices[4 * index]);
+        }
+
+        FlushSpriteBatch(distanceField->Batch);
+        glUseProgram(batch.Buffer.Program);
+    }
+
+    // The next hook or layer must not find these quads still pending
+    FlushSpriteBatch(batch);
+
+    layer.RunCount = 0;
+    layer.GlyphCount = 0;
+}
+
+/// FORMATTING
+
+uint32_t FormatUint32(char* buffer, const uint32_t size, const uint32_t value, const uint32_t minDigits)
+{
+    if (size == 0) {
+        return 0;
+    }
+
+    // Backwards into a scratch, a uint32_t never has more than 10 digits
+    char digits[10];
+    uint32_t count = 0;
+
+    for (uint32_t remaining = value; remaining != 0 || count == 0; remaining /= 10) {
+        digits[count++] = (char)('0' + remaining % 10);
+    }
+
+    uint32_t length = 0;
+
+    for (uint32_t pad = count; pad < minDigits && length + 1 < size; ++pad) {
+        buffer[length++] = '0';
+    }
+
+    while (count > 0 && length + 1 < size) {
+        buffer[length++] = digits[--count];
+    }
+
+    buffer[length] = '\0';
+    return length;
+}
+
+uint32_t FormatFloat(char* buffer, const uint32_t size, const float value, const uint32_t decimals)
+{
+    if (size == 0) {
+        return 0;
+    }
+
+    if (value != value)
+    {
+        const char nan[] = "nan";
+        uint32_t length = 0;
+
+        while (nan[length] != '\0' && length + 1 < size) {
+            buffer[length] = nan[length];
+            ++length;
+        }
+
+        buffer[length] = '\0';
+        return length;
+    }
+
+    const uint32_t pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+    const uint32_t places = (decimals > 6) ? 6 : decimals;
+
+    const double magnitude = (value < 0.0f) ? -(double)value : (double)value;
+
+    // Rounded once on the scaled value, so 0.999 with two decimals reads 1.00.
+    // Double keeps every integer part up to UINT32_MAX exact, larger values and infinity saturate there
+    const double scaled = magnitude * pow10[places] + 0.5;
+    const uint64_t limit = ((uint64_t)UINT32_MAX + 1) * pow10[places];
+
+    const uint64_t fixed = (scaled < (double)limit) ? (uint64_t)scaled : (uint64_t)UINT32_MAX * pow10[places];
+    const uint32_t integer = (uint32_t)(fixed / pow10[places]);
+    const uint32_t fraction = (uint32_t)(fixed % pow10[places]);
+
+    uint32_t length = 0;
+
+    // Values that round to zero don't get a sign
+    if (value < 0.0f && fixed > 0 && size > 1) {
+        buffer[length++] = '-';
+    }
+
+    length += FormatUint32(buffer + length, size - length, integer);
+
+    if (places > 0 && length + 1 < size)
+    {
+        buffer[length++] = '.';
+        length += FormatUint32(buffer + length, size - length, fraction, places);
+    }
+
+    buffer[length] = '\0';
+    return length;
+}
\ No newline at end of file
@@ -0,0 +1,188 @@
+#ifndef BITMAP_FONT_H
+#define BITMAP_FONT_H
+
+#include "allocator.h"
+#include "asset.h"
+#include "gfx_math.h"
+#include "sprite_batch.h"
+#include "texture2d.h"
+
+#include <cstdint>
+
+constexpr const uint32_t g_fontAsciiGlyphs = 128;
+constexpr const uint16_t g_invalidFontGlyph = 0xFFFF;
+constexpr const uint32_t g_maxTextLayouts = 32;
+constexpr const uint32_t g_maxTextLayoutBytes = 64;     // UTF-8, longer strings are laid out every time they are drawn
+constexpr const uint32_t g_maxTextLayoutGlyphs = g_maxTextLayoutBytes;  // Every glyph takes a byte at least, cached strings always fit
+constexpr const uint32_t g_maxTextRuns = 32;
+constexpr const uint32_t g_maxTextLayerGlyphs = 512;
+
+typedef enum class TEXT_ALIGN : uint32_t {
+    Left,       // Every line starts at the origin
+    Center,
+    Right       // Every line ends at the origin
+} TextAlign;
+
+typedef struct {
+    uint32_t Codepoint;
+    Rect2D Region;          // Texels
+    float UV[4];            // Region normalized to the atlas, U0 V0 U1 V1
+    float OffsetX;          // Pen position to the top left of the quad, font pixels
+    float OffsetY;
+    float Advance;
+} FontGlyph;
+
+typedef struct {
+    uint64_t Pair;          // First codepoint << 32 | second codepoint
+    float Amount;           // Font pixels, added to the pen before the second glyph
+} FontKerning;
+
+// Glyph metrics of a BMFont text descriptor, single page. The page texture is owned by the caller.
+// Descriptors written by tools/sdf_font add an "sdf spread=N" line, their page holds distances instead of coverage
+typedef struct {
+    FontGlyph* Glyphs;      // Sorted by codepoint
+    uint32_t GlyphCount;
+    FontKerning* Kernings;  // Sorted by pair
+    uint32_t KerningCount;
+    uint16_t AsciiGlyphs[g_fontAsciiGlyphs];    // Direct lookup, the rest is a binary search
+    uint16_t FallbackGlyph;                     // Drawn for codepoints the font doesn't have, '?' when there's one
+    float LineHeight;
+    float Base;
+    float DistanceSpread;   // Atlas texels on each side of the edge, 0 for plain bitmap fonts
+    Vec2 TexelSize;         // 1 / page size
+    const Texture2D* Texture;
+} BitmapFont;
+
+// Everything but the color changes the layout
+typedef struct {
+    const BitmapFont* Font;
+    Vec2 Scale;
+    uint32_t Color;
+    TextAlign Align;
+    float Tracking;         // Extra advance after every glyph, font pixels
+    float OutlineWidth;     // Distance field fonts only, font pixels, up to the spread
+    uint32_t OutlineColor;
+    Vec2 ShadowOffset;      // Distance field fonts only, font pixels, clipped by the glyph padding past the spread
+    uint32_t ShadowColor;
+} TextStyle;
+
+typedef struct {
+    float Quad[4];          // X0 Y0 X1 Y1 from the text origin, work resolution units
+    float UV[4];
+} TextGlyph;
+
+typedef struct {
+    uint64_t Hash;
+    const BitmapFont* Font;
+    Vec2 Scale;
+    TextAlign Align;
+    float Tracking;
+    char Text[g_maxTextLayoutBytes];       // Tells strings with the same hash apart
+    uint32_t Length;
+    TextGlyph Glyphs[g_maxTextLayoutGlyphs];
+    uint32_t GlyphCount;
+    Vec2 Size;
+    uint32_t LastUsed;
+} TextLayout;
+
+typedef struct {
+    uint32_t Hits;
+    uint32_t Misses;
+    uint32_t Evictions;
+    uint32_t Uncached;      // Too long to be cached, laid out on every draw
+} TextLayoutStats;
+
+// Strings drawn again with the same style skip the UTF-8 decoding, the glyph lookups and the kerning
+typedef struct {
+    TextLayout* Layouts;
+    uint32_t Count;
+    uint32_t Capacity;
+    uint32_t Clock;         // Bumped on every lookup, the least recently used layout is replaced
+    TextLayoutStats Stats;
+} TextLayoutCache;
+
+// Uniforms of the distance field pass, computed per draw from the style and the display scale
+typedef struct {
+    float Smoothing;        // Half the antialiased band around the edge, distance units (0 to 1 across twice the spread)
+    float OutlineWidth;     // Distance units
+    float OutlineColor[4];  // Premultiplied
+    float ShadowOffset[2];  // UV
+    float ShadowColor[4];   // Premultiplied
+} TextEffect;
+
+typedef struct {
+    const Texture2D* Texture;
+    uint32_t FirstGlyph;
+    uint32_t GlyphCount;
+    bool IsDistanceField;
+    TextEffect Effect;
+} TextRun;
+
+typedef struct {
+    int32_t ModelViewProj;
+    int32_t Smoothing;
+    int32_t OutlineWidth;
+    int32_t OutlineColor;
+    int32_t ShadowOffset;
+    int32_t ShadowColor;
+} DistanceFieldUniforms;
+
+// Glyphs of distance field fonts are drawn by their own program, with a batch bound to it
+typedef struct {
+    uint32_t Program;
+    DistanceFieldUniforms Uniforms;
+    SpriteBatch Batch;
+} DistanceFieldRenderer;
+
+// Glyph quads collected during the update and fed to the sprite batch at its render layer
+typedef struct {
+    SpriteVertex* Vertices;         // 4 per glyph, display pixels like every batched vertex
+    TextGlyph* Scratch;             // Layout of the strings the cache can't hold
+    TextRun Runs[g_maxTextRuns];    // Consecutive glyphs sharing a texture
+    uint32_t RunCount;
+    uint32_t GlyphCount;
+    uint32_t Capacity;
+    TextLayoutCache* Cache;
+} TextLayer;
+
+// The descriptor text is parsed from scratch memory, the glyph and kerning arrays live on the heap with the font
+void CreateBitmapFont(Asset& asset, const Texture2D& texture, BitmapFont& font, const Allocator& scratch = g_heapAllocator);
+void DestroyBitmapFont(BitmapFont& font);
+
+// Returns g_invalidFontGlyph when the font doesn't have it
+uint16_t FindFontGlyph(const BitmapFont& font, const uint32_t codepoint);
+float GetFontKerning(const BitmapFont& font, const uint32_t first, const uint32_t second);
+
+// Lays out up to maxGlyphs glyphs and returns how many were written, size is the bounding box of every line
+uint32_t LayoutText(const TextStyle& style, const char* text, const uint32_t length, TextGlyph* glyphs,
+                    const uint32_t maxGlyphs, Vec2& size);
+
+void CreateTextLayoutCache(TextLayoutCache& cache, const uint32_t capacity = g_maxTextLayouts);
+void DestroyTextLayoutCache(TextLayoutCache& cache);
+
+// Returns nullptr when the string is too long to be cached
+const TextLayout* FindTextLayout(TextLayoutCache& cache, const TextStyle& style, const char* text, const uint32_t length);
+
+// Layouts of a font that is going away, they would point at its glyphs
+void ForgetTextLayouts(TextLayoutCache& cache, const BitmapFont& font);
+
+void CreateTextLayer(TextLayer& layer, TextLayoutCache& cache, const uint32_t capacity = g_maxTextLayerGlyphs);
+void DestroyTextLayer(TextLayer& layer);
+
+// The position is where the first line's top meets the alignment edge, work resolution units
+void DrawText(TextLayer& layer, const TextStyle& style, const char* text, const Vec2& position, const Vec2& workResScale);
+Vec2 MeasureText(TextLayoutCache& cache, const TextStyle& style, const char* text);
+
+// The program has to be linked already, the vertex shader is the sprite one
+void CreateDistanceFieldRenderer(DistanceFieldRenderer& renderer, const uint32_t program, QuadIndexBuffer& indexBuffer);
+void DestroyDistanceFieldRenderer(DistanceFieldRenderer& renderer);
+
+// Queues every glyph drawn since the last call and flushes. Bitmap runs go to the batch, distance field runs
+// to the renderer, the batch program is bound again afterwards. Distance field runs are dropped without a renderer
+void FlushTextLayer(TextLayer& layer, SpriteBatch& batch, DistanceFieldRenderer* distanceField, const Matrix& modelViewProj);
+
+// Allocation free, zero padded to minDigits. Both return the length written, the buffer is always terminated
+uint32_t FormatUint32(char* buffer, const uint32_t size, const uint32_t value, const uint32_t minDigits = 0);
+uint32_t FormatFloat(char* buffer, const uint32_t size, const float value, const uint32_t decimals = 2);
+
+#endif // BITMAP_FONT_H
\ No newline at end of file
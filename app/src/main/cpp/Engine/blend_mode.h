@@ -0,0 +1,13 @@
+#ifndef BLEND_MODE_H
+#define BLEND_MODE_H
+
+#include <cstdint>
+
+typedef enum class BLEND_MODE : uint32_t {
+    Opaque,
+    Alpha,                  // Straight alpha textures
+    PremultipliedAlpha,     // Color already multiplied by alpha, the default sprite pipeline
+    Additive
+} BlendMode;
+
+#endif // BLEND_MODE_H
\ No newline at end of file
@@ -0,0 +1,404 @@
+#include "collision.h"
+
+#include "utils.h"
+
+#include <cmath>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define COLLISION_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define COLLISION_SSE2 1
+#endif
+
+constexpr const float g_maxCollisionCellCoord = 32767.0f;  // Cells are packed in 16 bits per axis
+
+// Clamped before the cast, parked colliders sit at -FLT_MAX and NaN lands on the lower limit
+inline int32_t GetCellCoord(const CollisionGrid& grid, const float position)
+{
+    const float cell = floorf(position * grid.InvCellSize);
+
+    if (!(cell > -g_maxCollisionCellCoord)) {
+        return -(int32_t)g_maxCollisionCellCoord;
+    }
+
+    if (cell > g_maxCollisionCellCoord) {
+        return (int32_t)g_maxCollisionCellCoord;
+    } return (int32_t)cell;
+}
+
+// Parked and degenerate boxes overlap nothing, they stay out of the grid
+inline bool IsEmptyBounds(const BoundsSoA& bounds, const uint32_t index)
+{
+    return !(bounds.MaxX[index] > bounds.MinX[index] && bounds.MaxY[index] > bounds.MinY[index]);
+}
+
+inline uint32_t PackCell(const int32_t cellX, const int32_t cellY)
+{
+    return ((uint32_t)cellX & 0xFFFF) | ((uint32_t)cellY << 16);
+}
+
+inline uint32_t HashCell(const int32_t cellX, const int32_t cellY)
+{
+    return (((uint32_t)cellX * 73856093u) ^ ((uint32_t)cellY * 19349663u)) & (g_collisionBucketCount - 1);
+}
+
+inline bool OverlapsBounds(const BoundsSoA& bounds, const uint32_t lhe, const uint32_t rhe)
+{
+    return bounds.MinX[lhe] < bounds.MaxX[rhe] && bounds.MaxX[lhe] > bounds.MinX[rhe] &&
+           bounds.MinY[lhe] < bounds.MaxY[rhe] && bounds.MaxY[lhe] > bounds.MinY[rhe];
+}
+
+inline bool CanCollide(const CollisionGrid& grid, const uint32_t lhe, const uint32_t rhe)
+{
+    return (grid.Masks[lhe] & grid.Layers[rhe]) != 0 && (grid.Masks[rhe] & grid.Layers[lhe]) != 0;
+}
+
+void CreateCollisionGrid(CollisionGrid& grid, const float cellSize)
+{
+    grid.CellSize    = cellSize;
+    grid.InvCellSize = 1.0f / cellSize;
+
+    grid.BucketStart = new uint32_t[g_collisionBucketCount + 1];
+    grid.Pairs       = new CollisionPair[g_maxCollisionPairs];
+
+    grid.Entries          = nullptr;
+    grid.EntryCells       = nullptr;
+    grid.EntryCapacity    = 0;
+    grid.QueryStamps      = nullptr;
+    grid.QueryStamp       = 0;
+    grid.ColliderCapacity = 0;
+
+    grid.Bounds = { nullptr, nullptr, nullptr, nullptr };
+    grid.Layers = nullptr;
+    grid.Masks  = nullptr;
+    grid.Count  = 0;
+
+    grid.PairCount = 0;
+    grid.Stats     = { 0, 0, 0, 0 };
+
+    for (uint32_t bucket = 0; bucket <= g_collisionBucketCount; ++bucket) {
+        grid.BucketStart[bucket] = 0;
+    }
+}
+
+void DestroyCollisionGrid(CollisionGrid& grid)
+{
+    delete[] grid.QueryStamps;
+    delete[] grid.EntryCells;
+    delete[] grid.Entries;
+    delete[] grid.Pairs;
+    delete[] grid.BucketStart;
+
+    grid.QueryStamps = nullptr;
+    grid.EntryCells  = nullptr;
+    grid.Entries     = nullptr;
+    grid.Pairs       = nullptr;
+    grid.BucketStart = nullptr;
+    grid.Count       = 0;
+}
+
+void BuildCollisionGrid(CollisionGrid& grid, const BoundsSoA& bounds, const uint32_t* layers,
+                        const uint32_t* masks, const uint32_t count)
+{
+    grid.Bounds = bounds;
+    grid.Layers = layers;
+    grid.Masks  = masks;
+    grid.Count  = count;
+
+    if (count > grid.ColliderCapacity)
+    {
+        delete[] grid.QueryStamps;
+
+        grid.ColliderCapacity = count;
+        grid.QueryStamps = new uint32_t[count];
+        grid.QueryStamp  = 0;
+
+        for (uint32_t index = 0; index < count; ++index) {
+            grid.QueryStamps[index] = 0;
+        }
+    }
+
+    uint32_t* bucketStart = grid.BucketStart;
+
+    for (uint32_t bucket = 0; bucket <= g_collisionBucketCount; ++bucket) {
+        bucketStart[bucket] = 0;
+    }
+
+    // Counting sort, first count the entries landing in every bucket
+    uint32_t entryCount = 0;
+
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        if (IsEmptyBounds(bounds, index)) {
+            continue;
+        }
+
+        const int32_t minX = GetCellCoord(grid, bounds.MinX[index]);
+        const int32_t minY = GetCellCoord(grid, bounds.MinY[index]);
+        const int32_t maxX = GetCellCoord(grid, bounds.MaxX[index]);
+        const int32_t maxY = GetCellCoord(grid, bounds.MaxY[index]);
+
+        for (int32_t cellY = minY; cellY <= maxY; ++cellY) {
+            for (int32_t cellX = minX; cellX <= maxX; ++cellX) {
+                bucketStart[HashCell(cellX, cellY) + 1]++;
+            }
+        }
+
+        entryCount += (uint32_t)((maxX - minX + 1) * (maxY - minY + 1));
+    }
+
+    if (entryCount > grid.EntryCapacity)
+    {
+        delete[] grid.EntryCells;
+        delete[] grid.Entries;
+
+        // Some slack so a few colliders crossing cell borders don't reallocate every frame
+        grid.EntryCapacity = entryCount + entryCount / 2;
+        grid.Entries    = new uint32_t[grid.EntryCapacity];
+        grid.EntryCells = new uint32_t[grid.EntryCapacity];
+    }
+
+    for (uint32_t bucket = 0; bucket < g_collisionBucketCount; ++bucket) {
+        bucketStart[bucket + 1] += bucketStart[bucket];
+    }
+
+    // Then scatter, walking the colliders in order keeps every bucket sorted by collider index
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        if (IsEmptyBounds(bounds, index)) {
+            continue;
+        }
+
+        const int32_t minX = GetCellCoord(grid, bounds.MinX[index]);
+        const int32_t minY = GetCellCoord(grid, bounds.MinY[index]);
+        const int32_t maxX = GetCellCoord(grid, bounds.MaxX[index]);
+        const int32_t maxY = GetCellCoord(grid, bounds.MaxY[index]);
+
+        for (int32_t cellY = minY; cellY <= maxY; ++cellY)
+        {
+            for (int32_t cellX = minX; cellX <= maxX; ++cellX)
+            {
+                const uint32_t entry = bucketStart[HashCell(cellX, cellY)]++;
+
+                grid.Entries[entry]    = index;
+                grid.EntryCells[entry] = PackCell(cellX, cellY);
+            }
+        }
+    }
+
+    // The scatter advanced every start to the next bucket's, shift them back
+    for (uint32_t bucket = g_collisionBucketCount; bucket > 0; --bucket) {
+        bucketStart[bucket] = bucketStart[bucket - 1];
+    }
+
+    bucketStart[0] = 0;
+
+    grid.PairCount = 0;
+    grid.Stats = { count, entryCount, 0, 0 };
+}
+
+uint32_t FindCollisionPairs(CollisionGrid& grid)
+{
+    const BoundsSoA& bounds = grid.Bounds;
+
+    grid.PairCount = 0;
+    grid.Stats.PairTests = 0;
+
+    for (uint32_t bucket = 0; bucket < g_collisionBucketCount; ++bucket)
+    {
+        const uint32_t end = grid.BucketStart[bucket + 1];
+
+        for (uint32_t lheEntry = grid.BucketStart[bucket]; lheEntry < end; ++lheEntry)
+        {
+            const uint32_t lhe = grid.Entries[lheEntry];
+            const uint32_t cell = grid.EntryCells[lheEntry];
+
+            for (uint32_t rheEntry = lheEntry + 1; rheEntry < end; ++rheEntry)
+            {
+                const uint32_t rhe = grid.Entries[rheEntry];
+
+                // Another cell hashed into the same bucket
+                if (grid.EntryCells[rheEntry] != cell || !CanCollide(grid, lhe, rhe)) {
+                    continue;
+                }
+
+                grid.Stats.PairTests++;
+
+                if (!OverlapsBounds(bounds, lhe, rhe)) {
+                    continue;
+                }
+
+                // Colliders sharing several cells only report from the one holding the overlap's top left corner
+                const float cornerX = (bounds.MinX[lhe] > bounds.MinX[rhe]) ? bounds.MinX[lhe] : bounds.MinX[rhe];
+                const float cornerY = (bounds.MinY[lhe] > bounds.MinY[rhe]) ? bounds.MinY[lhe] : bounds.MinY[rhe];
+
+                if (PackCell(GetCellCoord(grid, cornerX), GetCellCoord(grid, cornerY)) != cell) {
+                    continue;
+                }
+
+                if (grid.PairCount == g_maxCollisionPairs) {
+                    LogError("gfxError: Too many collision pairs, the rest are dropped :: FindCollisionPairs()");
+                    grid.Stats.Pairs = grid.PairCount;
+                    return grid.PairCount;
+                }
+
+                // Buckets are sorted by collider index, lhe < rhe already holds
+                grid.Pairs[grid.PairCount++] = { lhe, rhe };
+            }
+        }
+    }
+
+    grid.Stats.Pairs = grid.PairCount;
+    return grid.PairCount;
+}
+
+uint32_t OverlapBounds(const BoundsSoA& bounds, const uint32_t* layers, const uint32_t count,
+                       const ScreenRect& box, const uint32_t layerMask, uint32_t* hitMask)
+{
+    for (uint32_t word = 0; word < GetCullMaskWords(count); ++word) {
+        hitMask[word] = 0;
+    }
+
+    uint32_t index = 0;
+
+#if defined(COLLISION_NEON)
+    const float32x4_t left   = vdupq_n_f32(box.Left);
+    const float32x4_t right  = vdupq_n_f32(box.Right);
+    const float32x4_t top    = vdupq_n_f32(box.Top);
+    const float32x4_t bottom = vdupq_n_f32(box.Bottom);
+    const uint32x4_t mask    = vdupq_n_u32(layerMask);
+
+    const uint32_t laneBitsData[4] = { 1, 2, 4, 8 };
+    const uint32x4_t laneBits = vld1q_u32(laneBitsData);
+
+    for (; index + 4 <= count; index += 4)
+    {
+        const uint32x4_t overlapX = vandq_u32(vcltq_f32(vld1q_f32(bounds.MinX + index), right),
+                                              vcgtq_f32(vld1q_f32(bounds.MaxX + index), left));
+        const uint32x4_t overlapY = vandq_u32(vcltq_f32(vld1q_f32(bounds.MinY + index), bottom),
+                                              vcgtq_f32(vld1q_f32(bounds.MaxY + index), top));
+
+        // All ones where the layer shares a bit with the mask
+        const uint32x4_t onLayer = vtstq_u32(vld1q_u32(layers + index), mask);
+
+        const uint32x4_t bits = vandq_u32(vandq_u32(vandq_u32(overlapX, overlapY), onLayer), laneBits);
+        uint32x2_t folded = vpadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+        folded = vpadd_u32(folded, folded);
+
+        hitMask[index / 32] |= vget_lane_u32(folded, 0) << (index % 32);
+    }
+#elif defined(COLLISION_SSE2)
+    const __m128 left   = _mm_set1_ps(box.Left);
+    const __m128 right  = _mm_set1_ps(box.Right);
+    const __m128 top    = _mm_set1_ps(box.Top);
+    const __m128 bottom = _mm_set1_ps(box.Bottom);
+    const __m128i mask  = _mm_set1_epi32((int32_t)layerMask);
+    const __m128i zero  = _mm_setzero_si128();
+
+    for (; index + 4 <= count; index += 4)
+    {
+        const __m128 overlapX = _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(bounds.MinX + index), right),
+                                           _mm_cmpgt_ps(_mm_loadu_ps(bounds.MaxX + index), left));
+        const __m128 overlapY = _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(bounds.MinY + index), bottom),
+                                           _mm_cmpgt_ps(_mm_loadu_ps(bounds.MaxY + index), top));
+
+        // All ones where the layer has no bit of the mask
+        const __m128i offLayer = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128((const __m128i*)(layers + index)), mask), zero);
+
+        const __m128 hits = _mm_andnot_ps(_mm_castsi128_ps(offLayer), _mm_and_ps(overlapX, overlapY));
+        hitMask[index / 32] |= (uint32_t)_mm_movemask_ps(hits) << (index % 32);
+    }
+#endif
+
+    for (; index < count; ++index)
+    {
+        const bool isHit = bounds.MinX[index] < box.Right && bounds.MaxX[index] > box.Left &&
+                           bounds.MinY[index] < box.Bottom && bounds.MaxY[index] > box.Top &&
+                           (layers[index] & layerMask) != 0;
+
+        hitMask[index / 32] |= (uint32_t)isHit << (index % 32);
+    }
+
+    uint32_t hitCount = 0;
+
+    for (uint32_t word = 0; word < GetCullMaskWords(count); ++word) {
+        hitCount += PopCount(hitMask[word]);
+    }
+
+    return hitCount;
+}
+
+uint32_t OverlapBoundsMany(const BoundsSoA& bounds, const uint32_t* layers, const uint32_t count,
+                           const BoundsSoA& boxes, const uint32_t boxCount, const uint32_t layerMask, uint32_t* hitMasks)
+{
+    const uint32_t words = GetCullMaskWords(count);
+    uint32_t hitCount = 0;
+
+    for (uint32_t index = 0; index < boxCount; ++index)
+    {
+        const ScreenRect box = { boxes.MinX[index], boxes.MaxX[index], boxes.MaxY[index], boxes.MinY[index] };
+        hitCount += OverlapBounds(bounds, layers, count, box, layerMask, hitMasks + index * words);
+    }
+
+    return hitCount;
+}
+
+uint32_t QueryCollisionRegion(CollisionGrid& grid, const ScreenRect& region, const uint32_t layerMask,
+                              uint32_t* results, const uint32_t maxResults)
+{
+    const BoundsSoA& bounds = grid.Bounds;
+
+    // Stamps tell whether a collider was already reported by a previous cell of this query
+    if (++grid.QueryStamp == 0)
+    {
+        for (uint32_t index = 0; index < grid.ColliderCapacity; ++index) {
+            grid.QueryStamps[index] = 0;
+        }
+
+        grid.QueryStamp = 1;
+    }
+
+    const int32_t minX = GetCellCoord(grid, region.Left);
+    const int32_t minY = GetCellCoord(grid, region.Top);
+    const int32_t maxX = GetCellCoord(grid, region.Right);
+    const int32_t maxY = GetCellCoord(grid, region.Bottom);
+
+    uint32_t resultCount = 0;
+
+    for (int32_t cellY = minY; cellY <= maxY; ++cellY)
+    {
+        for (int32_t cellX = minX; cellX <= maxX; ++cellX)
+        {
+            const uint32_t bucket = HashCell(cellX, cellY);
+            const uint32_t cell = PackCell(cellX, cellY);
+
+            for (uint32_t entry = grid.BucketStart[bucket]; entry < grid.BucketStart[bucket + 1]; ++entry)
+            {
+                const uint32_t index = grid.Entries[entry];
+
+                if (grid.EntryCells[entry] != cell || grid.QueryStamps[index] == grid.QueryStamp) {
+                    continue;
+                }
+
+                grid.QueryStamps[index] = grid.QueryStamp;
+
+                const bool isInside = bounds.MinX[index] < region.Right && bounds.MaxX[index] > region.Left &&
+                                      bounds.MinY[index] < region.Bottom && bounds.MaxY[index] > region.Top;
+
+                if (!isInside || (grid.Layers[index] & layerMask) == 0) {
+                    continue;
+                }
+
+                if (resultCount == maxResults) {
+                    return resultCount;
+                }
+
+                results[resultCount++] = index;
+            }
+        }
+    }
+
+    return resultCount;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include "culling.h"
+#include "gfx_math.h"
+
+#include <cstdint>
+
+constexpr const uint32_t g_collisionBucketCount = 1024;    // Power of two
+constexpr const uint32_t g_maxCollisionPairs = 4096;
+constexpr const float g_defaultCollisionCellSize = 128.0f;  // Work resolution units
+
+typedef struct {
+    uint32_t First;         // Collider indices, First < Second
+    uint32_t Second;
+} CollisionPair;
+
+typedef struct {
+    uint32_t Colliders;
+    uint32_t CellEntries;   // One per cell a collider covers
+    uint32_t PairTests;     // Bounds tests run while enumerating pairs
+    uint32_t Pairs;
+} CollisionStats;
+
+// Spatial hash over a uniform grid, rebuilt with a counting sort from SoA bounds.
+// Cells are hashed into a fixed bucket table so the world doesn't need limits
+typedef struct {
+    float CellSize;
+    float InvCellSize;
+    uint32_t* BucketStart;      // g_collisionBucketCount + 1 offsets into Entries
+    uint32_t* Entries;          // Collider index per covered cell, grouped by bucket
+    uint32_t* EntryCells;       // Packed cell coordinates of each entry, buckets are shared by several cells
+    uint32_t EntryCapacity;
+    uint32_t* QueryStamps;      // Last query that reported each collider
+    uint32_t QueryStamp;
+    uint32_t ColliderCapacity;
+    BoundsSoA Bounds;
+    const uint32_t* Layers;
+    const uint32_t* Masks;
+    uint32_t Count;
+    CollisionPair* Pairs;
+    uint32_t PairCount;
+    CollisionStats Stats;
+} CollisionGrid;
+
+void CreateCollisionGrid(CollisionGrid& grid, const float cellSize = g_defaultCollisionCellSize);
+void DestroyCollisionGrid(CollisionGrid& grid);
+
+// The arrays are read by the pair and region queries, they have to stay untouched until the next build
+void BuildCollisionGrid(CollisionGrid& grid, const BoundsSoA& bounds, const uint32_t* layers,
+                        const uint32_t* masks, const uint32_t count);
+
+// Two colliders pair up when their bounds overlap and each one's mask has a bit of the other's layer
+uint32_t FindCollisionPairs(CollisionGrid& grid);
+
+// Sets bit i of the mask when bounds i overlaps the box and is on one of the layers, returns how many do.
+// Brute force over packed bounds, four per SIMD compare, cheaper than the grid for a single query against a few thousand
+uint32_t OverlapBounds(const BoundsSoA& bounds, const uint32_t* layers, const uint32_t count,
+                       const ScreenRect& box, const uint32_t layerMask, uint32_t* hitMask);
+
+// Same test for several boxes, box i fills the GetCullMaskWords(count) words starting at hitMasks[i * words]
+uint32_t OverlapBoundsMany(const BoundsSoA& bounds, const uint32_t* layers, const uint32_t count,
+                           const BoundsSoA& boxes, const uint32_t boxCount, const uint32_t layerMask, uint32_t* hitMasks);
+
+// Colliders on any of the given layers overlapping the region, each reported once
+uint32_t QueryCollisionRegion(CollisionGrid& grid, const ScreenRect& region, const uint32_t layerMask,
+                              uint32_t* results, const uint32_t maxResults);
+
+#endif // COLLISION_H
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include "collision_mask.h"
+
+#include "utils.h"
+
+#include <cmath>
+
+inline const uint64_t* GetMaskRow(const CollisionMaskAtlas& atlas, const CollisionMask& mask, const int32_t row)
+{
+    return atlas.Words + mask.FirstWord + (uint32_t)row * mask.WordsPerRow;
+}
+
+// 64 bits of a row starting at any texel, texels outside of the row read as empty
+inline uint64_t ExtractMaskBits(const uint64_t* row, const CollisionMask& mask, const int32_t first)
+{
+    const int32_t word  = first >> 6;      // Floors negative texels too
+    const int32_t shift = first & 63;
+    const int32_t words = (int32_t)mask.WordsPerRow;
+
+    uint64_t bits = (word >= 0 && word < words) ? row[word] >> shift : 0;
+
+    if (shift != 0 && word + 1 >= 0 && word + 1 < words) {
+        bits |= row[word + 1] << (64 - shift);
+    } return bits;
+}
+
+inline bool GetMaskBit(const uint64_t* row, const CollisionMask& mask, const int32_t texel)
+{
+    return texel >= 0 && texel < (int32_t)mask.Width && ((row[texel >> 6] >> (texel & 63)) & 1) != 0;
+}
+
+void CreateCollisionMaskAtlas(const Texture2D& texture, const Rect2D* regions, const uint32_t count,
+                              CollisionMaskAtlas& atlas, const uint8_t alphaThreshold)
+{
+    atlas.Masks     = nullptr;
+    atlas.MaskCount = 0;
+    atlas.Words     = nullptr;
+    atlas.WordCount = 0;
+
+    if (!texture.Data) {
+        LogError("gfxError: Texture2D has no decoded pixels to build masks from :: CreateCollisionMaskAtlas()");
+        return;
+    }
+
+    atlas.Masks = new CollisionMask[count];
+
+    // Regions hanging over the texture edge are clipped, then every mask gets its span of the pool
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        const Rect2D& region = regions[index];
+        CollisionMask& mask = atlas.Masks[index];
+
+        const uint32_t left = (uint32_t)region.X;
+        const uint32_t top  = (uint32_t)region.Y;
+
+        mask.Region = region;
+        mask.Width  = (left >= texture.Width) ? 0 : (left + region.Width > texture.Width) ? texture.Width - left : region.Width;
+        mask.Height = (top >= texture.Height) ? 0 : (top + region.Height > texture.Height) ? texture.Height - top : region.Height;
+
+        mask.WordsPerRow = (mask.Width + 63) / 64;
+        mask.FirstWord   = atlas.WordCount;
+
+        atlas.WordCount += mask.WordsPerRow * mask.Height;
+    }
+
+    atlas.Words = new uint64_t[atlas.WordCount];
+    atlas.MaskCount = count;
+
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        const CollisionMask& mask = atlas.Masks[index];
+
+        for (uint32_t y = 0; y < mask.Height; ++y)
+        {
+            uint64_t* row = atlas.Words + mask.FirstWord + y * mask.WordsPerRow;
+            const uint8_t* texel = texture.Data + 4 * (((uint32_t)mask.Region.Y + y) * texture.Width + (uint32_t)mask.Region.X);
+
+            for (uint32_t word = 0; word < mask.WordsPerRow; ++word) {
+                row[word] = 0;
+            }
+
+            for (uint32_t x = 0; x < mask.Width; ++x, texel += 4) {
+                row[x >> 6] |= (uint64_t)(texel[3] >= alphaThreshold) << (x & 63);
+            }
+        }
+    }
+}
+
+void DestroyCollisionMaskAtlas(CollisionMaskAtlas& atlas)
+{
+    delete[] atlas.Words;
+    delete[] atlas.Masks;
+
+    atlas.Words     = nullptr;
+    atlas.Masks     = nullptr;
+    atlas.WordCount = 0;
+    atlas.MaskCount = 0;
+}
+
+const CollisionMask* FindCollisionMask(const CollisionMaskAtlas& atlas, const Rect2D& region)
+{
+    for (uint32_t index = 0; index < atlas.MaskCount; ++index)
+    {
+        if (atlas.Masks[index].Region == region) {
+            return &atlas.Masks[index];
+        }
+    }
+
+    return nullptr;
+}
+
+bool TestCollisionMasks(const CollisionMaskAtlas& atlas, const CollisionMask& lhe, const Vec2& lhePos, const Vec2& lheScale,
+                        const CollisionMask& rhe, const Vec2& rhePos, const Vec2& rheScale)
+{
+    // Overlap of both placed masks in work resolution units
+    const float left   = fmaxf(lhePos.X, rhePos.X);
+    const float top    = fmaxf(lhePos.Y, rhePos.Y);
+    const float right  = fminf(lhePos.X + lhe.Width * lheScale.X, rhePos.X + rhe.Width * rheScale.X);
+    const float bottom = fminf(lhePos.Y + lhe.Height * lheScale.Y, rhePos.Y + rhe.Height * rheScale.Y);
+
+    if (left >= right || top >= bottom) {
+        return false;
+    }
+
+    // Same overlap in lhe texels
+    const int32_t firstX = (int32_t)floorf((left - lhePos.X) / lheScale.X);
+    const int32_t firstY = (int32_t)floorf((top - lhePos.Y) / lheScale.Y);
+    const int32_t endX   = (int32_t)ceilf((right - lhePos.X) / lheScale.X);
+    const int32_t endY   = (int32_t)ceilf((bottom - lhePos.Y) / lheScale.Y);
+
+    // Texel centers of lhe mapped into rhe texel space, rheTexel = lheTexel * ratio + offset
+    const float ratioX  = lheScale.X / rheScale.X;
+    const float ratioY  = lheScale.Y / rheScale.Y;
+    const float offsetX = (lhePos.X - rhePos.X) / rheScale.X + 0.5f * ratioX;
+    const float offsetY = (lhePos.Y - rhePos.Y) / rheScale.Y + 0.5f * ratioY;
+
+    // Equal scales keep both grids aligned, rhe's bits are then a plain shift of lhe's
+    const bool isAligned = (ratioX == 1.0f);
+    const int32_t shiftX = (int32_t)floorf(offsetX);
+
+    for (int32_t y = firstY; y < endY; ++y)
+    {
+        const int32_t rheY = (int32_t)floorf(y * ratioY + offsetY);
+
+        if (y < 0 || y >= (int32_t)lhe.Height || rheY < 0 || rheY >= (int32_t)rhe.Height) {
+            continue;
+        }
+
+        const uint64_t* lheRow = GetMaskRow(atlas, lhe, y);
+        const uint64_t* rheRow = GetMaskRow(atlas, rhe, rheY);
+
+        for (int32_t x = firstX; x < endX; x += 64)
+        {
+            const int32_t span = (endX - x < 64) ? endX - x : 64;
+            const uint64_t valid = (span == 64) ? ~0ull : (1ull << span) - 1;
+
+            const uint64_t lheBits = ExtractMaskBits(lheRow, lhe, x) & valid;
+
+            if (lheBits == 0) {
+                continue;
+            }
+
+            uint64_t rheBits = 0;
+
+            if (isAligned) {
+                rheBits = ExtractMaskBits(rheRow, rhe, x + shiftX);
+            }
+
+            // Scaled against each other, gather rhe's texels under the solid lhe ones
+            else
+            {
+                for (uint64_t bits = lheBits; bits != 0; bits &= bits - 1)
+                {
+                    const int32_t bit = __builtin_ctzll(bits);
+                    const int32_t rheX = (int32_t)floorf((x + bit) * ratioX + offsetX);
+
+                    rheBits |= (uint64_t)GetMaskBit(rheRow, rhe, rheX) << bit;
+                }
+            }
+
+            if ((lheBits & rheBits) != 0) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
\ No newline at end of file
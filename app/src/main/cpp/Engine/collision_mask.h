@@ -0,0 +1,39 @@
+#ifndef COLLISION_MASK_H
+#define COLLISION_MASK_H
+
+#include "gfx_math.h"
+#include "texture2d.h"
+
+#include <cstdint>
+
+constexpr const uint8_t g_defaultMaskAlphaThreshold = 0x80;
+
+// One bit per texel, set where the texel is solid. Bit i of a row word is texel (word * 64 + i),
+// the bits past the region width are always clear
+typedef struct {
+    Rect2D Region;
+    uint32_t Width;
+    uint32_t Height;
+    uint32_t WordsPerRow;
+    uint32_t FirstWord;     // Into the atlas word pool
+} CollisionMask;
+
+typedef struct {
+    CollisionMask* Masks;
+    uint32_t MaskCount;
+    uint64_t* Words;        // Rows of every mask back to back
+    uint32_t WordCount;
+} CollisionMaskAtlas;
+
+// Built from the texture's decoded copy while it's imported, regions are texel rects like Sprite::TexRect
+void CreateCollisionMaskAtlas(const Texture2D& texture, const Rect2D* regions, const uint32_t count,
+                              CollisionMaskAtlas& atlas, const uint8_t alphaThreshold = g_defaultMaskAlphaThreshold);
+void DestroyCollisionMaskAtlas(CollisionMaskAtlas& atlas);
+const CollisionMask* FindCollisionMask(const CollisionMaskAtlas& atlas, const Rect2D& region);
+
+// Narrowphase for two masks placed in work resolution units, run it once their bounds are known to overlap.
+// The overlap is walked in the first mask's texels, 64 of them per AND
+bool TestCollisionMasks(const CollisionMaskAtlas& atlas, const CollisionMask& lhe, const Vec2& lhePos, const Vec2& lheScale,
+                        const CollisionMask& rhe, const Vec2& rhePos, const Vec2& rheScale);
+
+#endif // COLLISION_MASK_H
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "culling.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CULLING_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CULLING_SSE2 1
+#endif
+
+uint32_t CullBounds(const BoundsSoA& bounds, const uint32_t count, const ScreenRect& view, uint32_t* visibleMask)
+{
+    for (uint32_t word = 0; word < GetCullMaskWords(count); ++word) {
+        visibleMask[word] = 0;
+    }
+
+    uint32_t index = 0;
+
+#if defined(CULLING_NEON)
+    const float32x4_t left   = vdupq_n_f32(view.Left);
+    const float32x4_t right  = vdupq_n_f32(view.Right);
+    const float32x4_t top    = vdupq_n_f32(view.Top);
+    const float32x4_t bottom = vdupq_n_f32(view.Bottom);
+
+    const uint32_t laneBitsData[4] = { 1, 2, 4, 8 };
+    const uint32x4_t laneBits = vld1q_u32(laneBitsData);
+
+    for (; index + 4 <= count; index += 4)
+    {
+        const uint32x4_t overlapX = vandq_u32(vcltq_f32(vld1q_f32(bounds.MinX + index), right),
+                                              vcgtq_f32(vld1q_f32(bounds.MaxX + index), left));
+        const uint32x4_t overlapY = vandq_u32(vcltq_f32(vld1q_f32(bounds.MinY + index), bottom),
+                                              vcgtq_f32(vld1q_f32(bounds.MaxY + index), top));
+
+        // No movemask on ARMv7, fold the lane bits with pairwise adds instead
+        const uint32x4_t bits = vandq_u32(vandq_u32(overlapX, overlapY), laneBits);
+        uint32x2_t folded = vpadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+        folded = vpadd_u32(folded, folded);
+
+        visibleMask[index / 32] |= vget_lane_u32(folded, 0) << (index % 32);
+    }
+#elif defined(CULLING_SSE2)
+    const __m128 left   = _mm_set1_ps(view.Left);
+    const __m128 right  = _mm_set1_ps(view.Right);
+    const __m128 top    = _mm_set1_ps(view.Top);
+    const __m128 bottom = _mm_set1_ps(view.Bottom);
+
+    for (; index + 4 <= count; index += 4)
+    {
+        const __m128 overlapX = _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(bounds.MinX + index), right),
+                                           _mm_cmpgt_ps(_mm_loadu_ps(bounds.MaxX + index), left));
+        const __m128 overlapY = _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(bounds.MinY + index), bottom),
+                                           _mm_cmpgt_ps(_mm_loadu_ps(bounds.MaxY + index), top));
+
+        visibleMask[index / 32] |= (uint32_t)_mm_movemask_ps(_mm_and_ps(overlapX, overlapY)) << (index % 32);
+    }
+#endif
+
+    for (; index < count; ++index)
+    {
+        const bool isVisible = bounds.MinX[index] < view.Right && bounds.MaxX[index] > view.Left &&
+                               bounds.MinY[index] < view.Bottom && bounds.MaxY[index] > view.Top;
+
+        visibleMask[index / 32] |= (uint32_t)isVisible << (index % 32);
+    }
+
+    uint32_t visibleCount = 0;
+
+    for (uint32_t word = 0; word < GetCullMaskWords(count); ++word) {
+        visibleCount += PopCount(visibleMask[word]);
+    }
+
+    return visibleCount;
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#ifndef CULLING_H
+#define CULLING_H
+
+#include "gfx_math.h"
+
+#include <cstdint>
+
+// Axis aligned bounds stored as separate arrays so four of them are tested per SIMD compare
+typedef struct {
+    float* MinX;
+    float* MinY;
+    float* MaxX;
+    float* MaxY;
+} BoundsSoA;
+
+inline uint32_t GetCullMaskWords(const uint32_t count)
+{
+    return (count + 31) / 32;
+}
+
+inline uint32_t PopCount(uint32_t value)
+{
+    uint32_t count = 0;
+
+    for (; value != 0; value &= value - 1) {
+        ++count;
+    } return count;
+}
+
+// Sets bit i of the mask when bounds i overlaps the view, returns how many do.
+// Y grows downwards like the work resolution, so Top is the smaller value
+uint32_t CullBounds(const BoundsSoA& bounds, const uint32_t count, const ScreenRect& view, uint32_t* visibleMask);
+
+#endif // CULLING_H
\ No newline at end of file
@@ -0,0 +1,1078 @@
+#include "entity_store.h"
+
+#include "utils.h"
+
+#include <cfloat>
+#include <cmath>
+
+/// COMPONENT INDEX
+
+inline void CreateComponentIndex(ComponentIndex& index, const uint32_t capacity)
+{
+    index.Sparse = new uint32_t[capacity];
+    index.Owners   = new EntityId[capacity];
+    index.Count    = 0;
+    index.Capacity = capacity;
+
+    for (uint32_t entity = 0; entity < capacity; ++entity) {
+        index.Sparse[entity] = g_invalidComponentSlot;
+    }
+}
+
+inline void DestroyComponentIndex(ComponentIndex& index)
+{
+    delete[] index.Owners;
+    delete[] index.Sparse;
+
+    index.Owners   = nullptr;
+    index.Sparse   = nullptr;
+    index.Count    = 0;
+    index.Capacity = 0;
+}
+
+// Appends a slot for the entity, or returns the one it already has
+inline uint32_t InsertComponentSlot(ComponentIndex& index, const EntityId entity, bool& isNew)
+{
+    const uint32_t existing = FindComponentSlot(index, entity);
+    isNew = (existing == g_invalidComponentSlot);
+
+    if (!isNew) {
+        return existing;
+    }
+
+    const uint32_t slot = index.Count++;
+
+    index.Sparse[GetEntityIndex(entity)] = slot;
+    index.Owners[slot] = entity;
+
+    return slot;
+}
+
+// Frees the entity's slot by moving the last one into it, the caller moves the data the same way
+inline bool RemoveComponentSlot(ComponentIndex& index, const EntityId entity, uint32_t& slot, uint32_t& last)
+{
+    slot = FindComponentSlot(index, entity);
+
+    if (slot == g_invalidComponentSlot) {
+        return false;
+    }
+
+    last = --index.Count;
+
+    const EntityId moved = index.Owners[last];
+
+    index.Owners[slot] = moved;
+    index.Sparse[GetEntityIndex(moved)] = slot;
+    index.Sparse[GetEntityIndex(entity)] = g_invalidComponentSlot;
+
+    return true;
+}
+
+uint32_t FindComponentSlot(const ComponentIndex& index, const EntityId entity)
+{
+    // g_invalidEntity and corrupt handles point past the sparse array
+    if (GetEntityIndex(entity) >= index.Capacity) {
+        return g_invalidComponentSlot;
+    }
+
+    const uint32_t slot = index.Sparse[GetEntityIndex(entity)];
+
+    // A stale handle shares the index but not the generation
+    if (slot == g_invalidComponentSlot || index.Owners[slot] != entity) {
+        return g_invalidComponentSlot;
+    } return slot;
+}
+
+// Out of reach of every overlap test
+inline void ParkColliderBounds(ColliderComponents& colliders, const uint32_t slot)
+{
+    colliders.Bounds.MinX[slot] = colliders.Bounds.MinY[slot] = -FLT_MAX;
+    colliders.Bounds.MaxX[slot] = colliders.Bounds.MaxY[slot] = -FLT_MAX;
+}
+
+inline void SwapTransformSlots(TransformComponents& transforms, const uint32_t lhe, const uint32_t rhe)
+{
+    if (lhe == rhe) {
+        return;
+    }
+
+    const EntityId lheOwner = transforms.Index.Owners[lhe];
+    const EntityId rheOwner = transforms.Index.Owners[rhe];
+
+    transforms.Index.Owners[lhe] = rheOwner;
+    transforms.Index.Owners[rhe] = lheOwner;
+    transforms.Index.Sparse[GetEntityIndex(rheOwner)] = lhe;
+    transforms.Index.Sparse[GetEntityIndex(lheOwner)] = rhe;
+
+    const Vec2 position = transforms.Position[lhe];
+    transforms.Position[lhe] = transforms.Position[rhe];
+    transforms.Position[rhe] = position;
+
+    const Vec2 scale = transforms.Scale[lhe];
+    transforms.Scale[lhe] = transforms.Scale[rhe];
+    transforms.Scale[rhe] = scale;
+}
+
+/// STORE
+
+void CreateEntityStore(EntityStore& store, const uint32_t capacity)
+{
+    store.Capacity   = (capacity > g_entityIndexMask) ? g_entityIndexMask : capacity;
+    store.FreeCount  = 0;
+    store.NextIndex  = 0;
+    store.AliveCount = 0;
+    store.Meshes     = nullptr;
+    store.CollisionMasks = nullptr;
+
+    store.Generations = new uint32_t[store.Capacity];
+    store.FreeIndices = new uint32_t[store.Capacity];
+
+    for (uint32_t index = 0; index < store.Capacity; ++index) {
+        store.Generations[index] = 0;
+    }
+
+    CreateComponentIndex(store.Transforms.Index, store.Capacity);
+    store.Transforms.Position = new Vec2[store.Capacity];
+    store.Transforms.Scale    = new Vec2[store.Capacity];
+
+    CreateComponentIndex(store.Sprites.Index, store.Capacity);
+    store.Sprites.Sprites = new Sprite[store.Capacity];
+    store.Sprites.Layer   = new uint32_t[store.Capacity];
+    store.Sprites.Depth   = new float[store.Capacity];
+
+    CreateComponentIndex(store.Velocities.Index, store.Capacity);
+    store.Velocities.Velocity     = new Vec2[store.Capacity];
+    store.Velocities.Acceleration = new Vec2[store.Capacity];
+    store.Velocities.BoundsMin    = new Vec2[store.Capacity];
+    store.Velocities.BoundsMax    = new Vec2[store.Capacity];
+    store.Velocities.WrapSpan     = new Vec2[store.Capacity];
+    store.Velocities.Bounds       = new BoundsMode[store.Capacity];
+    store.Velocities.OutsideMask  = new uint32_t[GetBoundsMaskWords(store.Capacity)];
+
+    store.EventCount = 0;
+
+    CreateComponentIndex(store.Colliders.Index, store.Capacity);
+    store.Colliders.Offset = new Vec2[store.Capacity];
+    store.Colliders.Extent = new Vec2[store.Capacity];
+    store.Colliders.Layer  = new uint32_t[store.Capacity];
+    store.Colliders.Mask   = new uint32_t[store.Capacity];
+
+    store.Colliders.Bounds.MinX = new float[store.Capacity];
+    store.Colliders.Bounds.MinY = new float[store.Capacity];
+    store.Colliders.Bounds.MaxX = new float[store.Capacity];
+    store.Colliders.Bounds.MaxY = new float[store.Capacity];
+    store.Colliders.HitMask     = new uint32_t[GetCullMaskWords(store.Capacity)];
+
+    store.Collisions     = new EntityCollision[g_maxCollisionPairs];
+    store.CollisionCount = 0;
+
+    CreateComponentIndex(store.Animators.Index, store.Capacity);
+    store.Animators.Clip  = new uint32_t[store.Capacity];
+    store.Animators.Time  = new float[store.Capacity];
+    store.Animators.Speed = new float[store.Capacity];
+    store.Animators.Frame = new uint32_t[store.Capacity];
+
+    store.Animations = nullptr;
+    store.AnimationEventCount = 0;
+
+    CreateComponentIndex(store.GpuSprites.Index, store.Capacity);
+    store.GpuSprites.Layer       = new GpuSpriteLayer*[store.Capacity];
+    store.GpuSprites.Sprite      = new uint32_t[store.Capacity];
+    store.GpuSprites.Position    = new Vec2[store.Capacity];
+    store.GpuSprites.Region      = new Rect2D[store.Capacity];
+    store.GpuSprites.BoundsMin   = new Vec2[store.Capacity];
+    store.GpuSprites.BoundsMax   = new Vec2[store.Capacity];
+    store.GpuSprites.WrapSpan    = new Vec2[store.Capacity];
+    store.GpuSprites.Bounds      = new BoundsMode[store.Capacity];
+    store.GpuSprites.OutsideMask = new uint32_t[GetBoundsMaskWords(store.Capacity)];
+}
+
+void DestroyEntityStore(EntityStore& store)
+{
+    delete[] store.GpuSprites.OutsideMask;
+    delete[] store.GpuSprites.Bounds;
+    delete[] store.GpuSprites.WrapSpan;
+    delete[] store.GpuSprites.BoundsMax;
+    delete[] store.GpuSprites.BoundsMin;
+    delete[] store.GpuSprites.Region;
+    delete[] store.GpuSprites.Position;
+    delete[] store.GpuSprites.Sprite;
+    delete[] store.GpuSprites.Layer;
+    DestroyComponentIndex(store.GpuSprites.Index);
+
+    delete[] store.Animators.Frame;
+    delete[] store.Animators.Speed;
+    delete[] store.Animators.Time;
+    delete[] store.Animators.Clip;
+    DestroyComponentIndex(store.Animators.Index);
+
+    delete[] store.Collisions;
+
+    delete[] store.Colliders.HitMask;
+    delete[] store.Colliders.Bounds.MaxY;
+    delete[] store.Colliders.Bounds.MaxX;
+    delete[] store.Colliders.Bounds.MinY;
+    delete[] store.Colliders.Bounds.MinX;
+    delete[] store.Colliders.Mask;
+    delete[] store.Colliders.Layer;
+    delete[] store.Colliders.Extent;
+    delete[] store.Colliders.Offset;
+    DestroyComponentIndex(store.Colliders.Index);
+
+    delete[] store.Velocities.OutsideMask;
+    delete[] store.Velocities.Bounds;
+    delete[] store.Velocities.WrapSpan;
+    delete[] store.Velocities.BoundsMax;
+    delete[] store.Velocities.BoundsMin;
+    delete[] store.Velocities.Acceleration;
+    delete[] store.Velocities.Velocity;
+    DestroyComponentIndex(store.Velocities.Index);
+
+    delete[] store.Sprites.Depth;
+    delete[] store.Sprites.Layer;
+    delete[] store.Sprites.Sprites;
+    DestroyComponentIndex(store.Sprites.Index);
+
+    delete[] store.Transforms.Scale;
+    delete[] store.Transforms.Position;
+    DestroyComponentIndex(store.Transforms.Index);
+
+    delete[] store.FreeIndices;
+    delete[] store.Generations;
+
+    store.Capacity   = 0;
+    store.AliveCount = 0;
+}
+
+EntityId CreateEntity(EntityStore& store)
+{
+    uint32_t index;
+
+    // Reuse freed indices first, their generation was bumped on destruction
+    if (store.FreeCount > 0) {
+        index = store.FreeIndices[--store.FreeCount];
+    }
+
+    else if (store.NextIndex < store.Capacity) {
+        index = store.NextIndex++;
+    }
+
+    else {
+        LogError("gfxError: Out of entities :: CreateEntity()");
+        return g_invalidEntity;
+    }
+
+    store.AliveCount++;
+    return (store.Generations[index] << g_entityIndexBits) | index;
+}
+
+void DestroyEntity(EntityStore& store, const EntityId entity)
+{
+    if (!IsEntityAlive(store, entity)) {
+        return;
+    }
+
+    RemoveTransform(store, entity);
+    RemoveSprite(store, entity);
+    RemoveVelocity(store, entity);
+    RemoveCollider(store, entity);
+    RemoveAnimator(store, entity);
+    RemoveGpuSprite(store, entity);
+
+    const uint32_t index = GetEntityIndex(entity);
+
+    store.Generations[index] = (store.Generations[index] + 1) & g_entityGenerationMask;
+    store.FreeIndices[store.FreeCount++] = index;
+    store.AliveCount--;
+}
+
+bool IsEntityAlive(const EntityStore& store, const EntityId entity)
+{
+    const uint32_t index = GetEntityIndex(entity);
+
+    return entity != g_invalidEntity && index < store.NextIndex &&
+           store.Generations[index] == GetEntityGeneration(entity);
+}
+
+/// COMPONENTS
+
+inline void ApplyTexRect(const EntityStore& store, Sprite& sprite, const Rect2D& texRect)
+{
+    SpriteSetTexRect(sprite, texRect);
+
+    if (store.Meshes) {
+        SpriteSetMesh(sprite, FindSpriteMesh(*store.Meshes, texRect));
+    }
+}
+
+void AddTransform(EntityStore& store, const EntityId entity, const Vec2& position, const Vec2& scale)
+{
+    if (!IsEntityAlive(store, entity)) {
+        return;
+    }
+
+    bool isNew;
+    const uint32_t slot = InsertComponentSlot(store.Transforms.Index, entity, isNew);
+
+    store.Transforms.Position[slot] = position;
+    store.Transforms.Scale[slot]    = scale;
+}
+
+void AddSprite(EntityStore& store, const EntityId entity, Texture2D& texture, const Rect2D& texRect,
+               const uint32_t color, const uint32_t layer, const float depth)
+{
+    if (!IsEntityAlive(store, entity)) {
+        return;
+    }
+
+    bool isNew;
+    const uint32_t slot = InsertComponentSlot(store.Sprites.Index, entity, isNew);
+
+    Sprite& sprite = store.Sprites.Sprites[slot];
+
+    // Vertices are built against the real work resolution scale when the sprite is first drawn
+    CreateSprite(sprite, { 1.0f, 1.0f }, texture);
+    sprite.NeedBufferUpdate = true;
+
+    SpriteSetColor(sprite, color);
+    ApplyTexRect(store, sprite, texRect);
+
+    store.Sprites.Layer[slot] = layer;
+    store.Sprites.Depth[slot] = depth;
+}
+
+void AddVelocity(EntityStore& store, const EntityId entity, const Vec2& velocity, const Vec2& acceleration)
+{
+    if (!IsEntityAlive(store, entity)) {
+        return;
+    }
+
+    const uint32_t transform = FindComponentSlot(store.Transforms.Index, entity);
+
+    if (transform == g_invalidComponentSlot) {
+        LogError("gfxError: Entity needs a transform to move :: AddVelocity()");
+        return;
+    }
+
+    VelocityComponents& velocities = store.Velocities;
+
+    // Line the transform up with the velocity slot it's about to get
+    if (FindComponentSlot(velocities.Index, entity) == g_invalidComponentSlot) {
+        SwapTransformSlots(store.Transforms, transform, velocities.Index.Count);
+    }
+
+    bool isNew;
+    const uint32_t slot = InsertComponentSlot(velocities.Index, entity, isNew);
+
+    velocities.Velocity[slot]     = velocity;
+    velocities.Acceleration[slot] = acceleration;
+
+    if (isNew) {
+        velocities.BoundsMin[slot] = { -FLT_MAX, -FLT_MAX };
+        velocities.BoundsMax[slot] = { FLT_MAX, FLT_MAX };
+        velocities.WrapSpan[slot]  = { 0.0f, 0.0f };
+        velocities.Bounds[slot]    = BoundsMode::None;
+    }
+}
+
+void AddCollider(EntityStore& store, const EntityId entity, const Vec2& offset, const Vec2& extent,
+                 const uint32_t layer, const uint32_t mask)
+{
+    if (!IsEntityAlive(store, entity)) {
+        return;
+    }
+
+    bool isNew;
+    const uint32_t slot = InsertComponentSlot(store.Colliders.Index, entity, isNew);
+
+    // Queries before the next collision update don't see the new box yet
+    if (isNew) {
+        ParkColliderBounds(store.Colliders, slot);
+    }
+
+    store.Colliders.Offset[slot] = offset;
+    store.Colliders.Extent[slot] = extent;
+    store.Colliders.Layer[slot]  = layer;
+    store.Colliders.Mask[slot]   = mask;
+}
+
+inline bool IsValidClip(const EntityStore& store, const uint32_t clip)
+{
+    if (!store.Animations || clip >= store.Animations->ClipCount) {
+        LogError("gfxError: Unknown animation clip %u :: IsValidClip()", clip);
+        return false;
+    } return true;
+}
+
+// Shows the clip frame on the entity sprite, the atlas searches only happen here
+inline void ApplyAnimationFrame(EntityStore& store, const uint32_t slot)
+{
+    AnimatorComponents& animators = store.Animators;
+
+    const AnimationClip& clip = store.Animations->Clips[animators.Clip[slot]];
+    const uint32_t sprite = store.Sprites.Index.Sparse[GetEntityIndex(animators.Index.Owners[slot])];
+
+    if (sprite != g_invalidComponentSlot) {
+        ApplyTexRect(store, store.Sprites.Sprites[sprite], store.Animations->Frames[clip.FirstFrame + animators.Frame[slot]].Region);
+    }
+}
+
+void AddGpuSprite(EntityStore& store, const EntityId entity, GpuSpriteLayer& layer, const uint32_t clip,
+                  const Vec2& velocity, const uint32_t color, const float time)
+{
+    if (!IsEntityAlive(store, entity)) {
+        return;
+    }
+
+    const uint32_t transform = FindComponentSlot(store.Transforms.Index, entity);
+
+    if (transform == g_invalidComponentSlot) {
+        LogError("gfxError: Entity needs a transform to spawn a GPU sprite :: AddGpuSprite()");
+        return;
+    }
+
+    const Vec2& position = store.Transforms.Position[transform];
+    const uint32_t sprite = AddGpuSprite(layer, clip, position, velocity, store.Transforms.Scale[transform], color, time);
+
+    if (sprite == g_invalidGpuSprite) {
+        return;
+    }
+
+    GpuSpriteComponents& gpuSprites = store.GpuSprites;
+
+    bool isNew;
+    const uint32_t slot = InsertComponentSlot(gpuSprites.Index, entity, isNew);
+
+    // Added again, the previous quad goes back to its layer
+    if (!isNew) {
+        RemoveGpuSprite(*gpuSprites.Layer[slot], gpuSprites.Sprite[slot]);
+    }
+
+    gpuSprites.Layer[slot]     = &layer;
+    gpuSprites.Sprite[slot]    = sprite;
+    gpuSprites.Position[slot]  = position;
+    gpuSprites.Region[slot]    = GetGpuSpriteRegion(layer, sprite, time);
+    gpuSprites.BoundsMin[slot] = { -FLT_MAX, -FLT_MAX };
+    gpuSprites.BoundsMax[slot] = { FLT_MAX, FLT_MAX };
+    gpuSprites.WrapSpan[slot]  = { 0.0f, 0.0f };
+    gpuSprites.Bounds[slot]    = BoundsMode::None;
+}
+
+void AddAnimator(EntityStore& store, const EntityId entity, const uint32_t clip, const float speed)
+{
+    if (!IsEntityAlive(store, entity) || !IsValidClip(store, clip)) {
+        return;
+    }
+
+    if (FindComponentSlot(store.Sprites.Index, entity) == g_invalidComponentSlot) {
+        LogError("gfxError: Entity needs a sprite to animate :: AddAnimator()");
+        return;
+    }
+
+    bool isNew;
+    const uint32_t slot = InsertComponentSlot(store.Animators.Index, entity, isNew);
+
+    store.Animators.Clip[slot]  = clip;
+    store.Animators.Time[slot]  = 0.0f;
+    store.Animators.Speed[slot] = speed;
+    store.Animators.Frame[slot] = 0;
+
+    ApplyAnimationFrame(store, slot);
+}
+
+void RemoveTransform(EntityStore& store, const EntityId entity)
+{
+    uint32_t slot, last;
+
+    // Leaves the moving group first, so the slot freed below is never inside it
+    RemoveVelocity(store, entity);
+
+    if (RemoveComponentSlot(store.Transforms.Index, entity, slot, last)) {
+        store.Transforms.Position[slot] = store.Transforms.Position[last];
+        store.Transforms.Scale[slot]    = store.Transforms.Scale[last];
+    }
+}
+
+void RemoveSprite(EntityStore& store, const EntityId entity)
+{
+    uint32_t slot, last;
+
+    if (RemoveComponentSlot(store.Sprites.Index, entity, slot, last)) {
+        store.Sprites.Sprites[slot] = store.Sprites.Sprites[last];
+        store.Sprites.Layer[slot]   = store.Sprites.Layer[last];
+        store.Sprites.Depth[slot]   = store.Sprites.Depth[last];
+    }
+}
+
+void RemoveVelocity(EntityStore& store, const EntityId entity)
+{
+    uint32_t slot, last;
+
+    VelocityComponents& velocities = store.Velocities;
+
+    if (RemoveComponentSlot(velocities.Index, entity, slot, last))
+    {
+        velocities.Velocity[slot]     = velocities.Velocity[last];
+        velocities.Acceleration[slot] = velocities.Acceleration[last];
+        velocities.BoundsMin[slot]    = velocities.BoundsMin[last];
+        velocities.BoundsMax[slot]    = velocities.BoundsMax[last];
+        velocities.WrapSpan[slot]     = velocities.WrapSpan[last];
+        velocities.Bounds[slot]       = velocities.Bounds[last];
+
+        // Same move on the transforms, the removed entity ends up right after the group
+        SwapTransformSlots(store.Transforms, slot, last);
+    }
+}
+
+void RemoveCollider(EntityStore& store, const EntityId entity)
+{
+    uint32_t slot, last;
+
+    if (RemoveComponentSlot(store.Colliders.Index, entity, slot, last)) {
+        store.Colliders.Offset[slot] = store.Colliders.Offset[last];
+        store.Colliders.Extent[slot] = store.Colliders.Extent[last];
+        store.Colliders.Layer[slot]  = store.Colliders.Layer[last];
+        store.Colliders.Mask[slot]   = store.Colliders.Mask[last];
+
+        store.Colliders.Bounds.MinX[slot] = store.Colliders.Bounds.MinX[last];
+        store.Colliders.Bounds.MinY[slot] = store.Colliders.Bounds.MinY[last];
+        store.Colliders.Bounds.MaxX[slot] = store.Colliders.Bounds.MaxX[last];
+        store.Colliders.Bounds.MaxY[slot] = store.Colliders.Bounds.MaxY[last];
+    }
+}
+
+void RemoveGpuSprite(EntityStore& store, const EntityId entity)
+{
+    uint32_t slot, last;
+
+    GpuSpriteComponents& gpuSprites = store.GpuSprites;
+    const uint32_t found = FindComponentSlot(gpuSprites.Index, entity);
+
+    if (found != g_invalidComponentSlot) {
+        RemoveGpuSprite(*gpuSprites.Layer[found], gpuSprites.Sprite[found]);
+    }
+
+    if (RemoveComponentSlot(gpuSprites.Index, entity, slot, last))
+    {
+        gpuSprites.Layer[slot]     = gpuSprites.Layer[last];
+        gpuSprites.Sprite[slot]    = gpuSprites.Sprite[last];
+        gpuSprites.Position[slot]  = gpuSprites.Position[last];
+        gpuSprites.Region[slot]    = gpuSprites.Region[last];
+        gpuSprites.BoundsMin[slot] = gpuSprites.BoundsMin[last];
+        gpuSprites.BoundsMax[slot] = gpuSprites.BoundsMax[last];
+        gpuSprites.WrapSpan[slot]  = gpuSprites.WrapSpan[last];
+        gpuSprites.Bounds[slot]    = gpuSprites.Bounds[last];
+    }
+}
+
+void RemoveAnimator(EntityStore& store, const EntityId entity)
+{
+    uint32_t slot, last;
+
+    if (RemoveComponentSlot(store.Animators.Index, entity, slot, last)) {
+        store.Animators.Clip[slot]  = store.Animators.Clip[last];
+        store.Animators.Time[slot]  = store.Animators.Time[last];
+        store.Animators.Speed[slot] = store.Animators.Speed[last];
+        store.Animators.Frame[slot] = store.Animators.Frame[last];
+    }
+}
+
+/// ACCESSORS
+
+inline uint32_t FindSlotOrLog(const ComponentIndex& index, const EntityId entity, const char* component)
+{
+    const uint32_t slot = FindComponentSlot(index, entity);
+
+    if (slot == g_invalidComponentSlot) {
+        LogError("gfxError: Entity has no %s component :: FindSlotOrLog()", component);
+    } return slot;
+}
+
+Vec2& GetEntityPosition(EntityStore& store, const EntityId entity)
+{
+    static Vec2 scratch;
+
+    const uint32_t slot = FindSlotOrLog(store.Transforms.Index, entity, "transform");
+    return (slot != g_invalidComponentSlot) ? store.Transforms.Position[slot] : scratch;
+}
+
+Vec2& GetEntityScale(EntityStore& store, const EntityId entity)
+{
+    static Vec2 scratch;
+
+    const uint32_t slot = FindSlotOrLog(store.Transforms.Index, entity, "transform");
+    return (slot != g_invalidComponentSlot) ? store.Transforms.Scale[slot] : scratch;
+}
+
+Vec2& GetEntityVelocity(EntityStore& store, const EntityId entity)
+{
+    static Vec2 scratch;
+
+    const uint32_t slot = FindSlotOrLog(store.Velocities.Index, entity, "velocity");
+    return (slot != g_invalidComponentSlot) ? store.Velocities.Velocity[slot] : scratch;
+}
+
+Vec2& GetEntityAcceleration(EntityStore& store, const EntityId entity)
+{
+    static Vec2 scratch;
+
+    const uint32_t slot = FindSlotOrLog(store.Velocities.Index, entity, "velocity");
+    return (slot != g_invalidComponentSlot) ? store.Velocities.Acceleration[slot] : scratch;
+}
+
+void SetEntityBounds(EntityStore& store, const EntityId entity, const Vec2& min, const Vec2& max,
+                     const BoundsMode& mode, const Vec2& wrapSpan)
+{
+    const uint32_t gpuSprite = FindComponentSlot(store.GpuSprites.Index, entity);
+
+    if (gpuSprite != g_invalidComponentSlot)
+    {
+        store.GpuSprites.BoundsMin[gpuSprite] = min;
+        store.GpuSprites.BoundsMax[gpuSprite] = max;
+        store.GpuSprites.WrapSpan[gpuSprite]  = wrapSpan;
+        store.GpuSprites.Bounds[gpuSprite]    = mode;
+
+        return;
+    }
+
+    const uint32_t slot = FindSlotOrLog(store.Velocities.Index, entity, "velocity");
+
+    if (slot != g_invalidComponentSlot)
+    {
+        store.Velocities.BoundsMin[slot] = min;
+        store.Velocities.BoundsMax[slot] = max;
+        store.Velocities.WrapSpan[slot]  = wrapSpan;
+        store.Velocities.Bounds[slot]    = mode;
+    }
+}
+
+const Sprite& GetEntitySprite(EntityStore& store, const EntityId entity)
+{
+    static Sprite scratch;
+
+    const uint32_t slot = FindSlotOrLog(store.Sprites.Index, entity, "sprite");
+    return (slot != g_invalidComponentSlot) ? store.Sprites.Sprites[slot] : scratch;
+}
+
+void SetEntityTexRect(EntityStore& store, const EntityId entity, const Rect2D& texRect)
+{
+    const uint32_t slot = FindSlotOrLog(store.Sprites.Index, entity, "sprite");
+
+    if (slot == g_invalidComponentSlot) {
+        return;
+    }
+
+    Sprite& sprite = store.Sprites.Sprites[slot];
+
+    // Animations set the region every frame, only search the mesh atlas when it changes
+    if (texRect != sprite.TexRect) {
+        ApplyTexRect(store, sprite, texRect);
+    }
+}
+
+void SetEntityColor(EntityStore& store, const EntityId entity, const uint32_t color)
+{
+    const uint32_t slot = FindSlotOrLog(store.Sprites.Index, entity, "sprite");
+
+    if (slot != g_invalidComponentSlot) {
+        SpriteSetColor(store.Sprites.Sprites[slot], color);
+    }
+}
+
+void PlayEntityAnimation(EntityStore& store, const EntityId entity, const uint32_t clip, const bool restart)
+{
+    const uint32_t slot = FindSlotOrLog(store.Animators.Index, entity, "animator");
+
+    if (slot == g_invalidComponentSlot || !IsValidClip(store, clip)) {
+        return;
+    }
+
+    if (clip == store.Animators.Clip[slot] && !restart) {
+        return;
+    }
+
+    store.Animators.Clip[slot]  = clip;
+    store.Animators.Time[slot]  = 0.0f;
+    store.Animators.Frame[slot] = 0;
+
+    ApplyAnimationFrame(store, slot);
+}
+
+void SetEntityAnimationSpeed(EntityStore& store, const EntityId entity, const float speed)
+{
+    const uint32_t slot = FindSlotOrLog(store.Animators.Index, entity, "animator");
+
+    if (slot != g_invalidComponentSlot) {
+        store.Animators.Speed[slot] = speed;
+    }
+}
+
+void SetEntityMotion(EntityStore& store, const EntityId entity, const Vec2& position, const Vec2& velocity, const float time)
+{
+    const uint32_t slot = FindSlotOrLog(store.GpuSprites.Index, entity, "GPU sprite");
+
+    if (slot == g_invalidComponentSlot) {
+        return;
+    }
+
+    SetGpuSpriteMotion(*store.GpuSprites.Layer[slot], store.GpuSprites.Sprite[slot], position, velocity, time);
+
+    // Visible to the rest of the frame, not just from the next GPU sprite pass on
+    store.GpuSprites.Position[slot] = position;
+    GetEntityPosition(store, entity) = position;
+}
+
+void SetEntityGpuClip(EntityStore& store, const EntityId entity, const uint32_t clip, const float time)
+{
+    const uint32_t slot = FindSlotOrLog(store.GpuSprites.Index, entity, "GPU sprite");
+
+    if (slot == g_invalidComponentSlot) {
+        return;
+    }
+
+    GpuSpriteLayer& layer = *store.GpuSprites.Layer[slot];
+
+    SetGpuSpriteClip(layer, store.GpuSprites.Sprite[slot], clip, time);
+    store.GpuSprites.Region[slot] = GetGpuSpriteRegion(layer, store.GpuSprites.Sprite[slot], time);
+}
+
+Vec2 GetEntitySize(EntityStore& store, const EntityId entity)
+{
+    const uint32_t gpuSprite = FindComponentSlot(store.GpuSprites.Index, entity);
+
+    // GPU sprites always have a transform, it holds the scale their quads were spawned with
+    if (gpuSprite != g_invalidComponentSlot)
+    {
+        const Rect2D& region = store.GpuSprites.Region[gpuSprite];
+        const Vec2& scale = GetEntityScale(store, entity);
+
+        return { region.Width * scale.X, region.Height * scale.Y };
+    }
+
+    const Sprite& sprite = GetEntitySprite(store, entity);
+    const uint32_t slot = FindComponentSlot(store.Transforms.Index, entity);
+
+    const Vec2 scale = (slot != g_invalidComponentSlot) ? store.Transforms.Scale[slot] : sprite.Scale;
+    return { sprite.Size.X * scale.X, sprite.Size.Y * scale.Y };
+}
+
+bool GetEntityCollider(EntityStore& store, const EntityId entity, Vec2& position, Vec2& size)
+{
+    const uint32_t slot = FindComponentSlot(store.Colliders.Index, entity);
+
+    if (slot == g_invalidComponentSlot) {
+        return false;
+    }
+
+    const Vec2 spriteSize = GetEntitySize(store, entity);
+    const Vec2& offset = store.Colliders.Offset[slot];
+    const Vec2& extent = store.Colliders.Extent[slot];
+
+    position = GetEntityPosition(store, entity) + Vec2(spriteSize.X * offset.X, spriteSize.Y * offset.Y);
+    size     = { spriteSize.X * extent.X, spriteSize.Y * extent.Y };
+
+    return true;
+}
+
+/// SYSTEMS
+
+void UpdateEntityKinematics(EntityStore& store, const float deltaTime)
+{
+    VelocityComponents& velocities = store.Velocities;
+    Vec2* positions = store.Transforms.Position;
+
+    const uint32_t count = velocities.Index.Count;
+    store.EventCount = 0;
+
+    // Transform slots [0, count) belong to the same entities as the velocity slots
+    IntegrateMotion(positions, velocities.Velocity, velocities.Acceleration, count, deltaTime);
+
+    if (FindOutOfBounds(positions, velocities.BoundsMin, velocities.BoundsMax, count, velocities.OutsideMask) == 0) {
+        return;
+    }
+
+    for (uint32_t word = 0; word < GetBoundsMaskWords(count); ++word)
+    {
+        for (uint32_t bits = velocities.OutsideMask[word]; bits != 0; bits &= bits - 1)
+        {
+            const uint32_t slot = word * 32 + (uint32_t)__builtin_ctz(bits);
+            const BoundsMode mode = velocities.Bounds[slot];
+
+            if (mode == BoundsMode::None) {
+                continue;
+            }
+
+            if (mode == BoundsMode::Wrap)
+            {
+                Vec2& position = positions[slot];
+                const Vec2& span = velocities.WrapSpan[slot];
+
+                const Vec2& min = velocities.BoundsMin[slot];
+                const Vec2& max = velocities.BoundsMax[slot];
+
+                position.X += (position.X < min.X) ? span.X : (position.X > max.X) ? -span.X : 0.0f;
+                position.Y += (position.Y < min.Y) ? span.Y : (position.Y > max.Y) ? -span.Y : 0.0f;
+            }
+
+            if (store.EventCount < g_maxKinematicsEvents) {
+                store.Events[store.EventCount++] = { velocities.Index.Owners[slot], mode };
+            }
+        }
+    }
+}
+
+void UpdateEntityGpuSprites(EntityStore& store, const float time)
+{
+    GpuSpriteComponents& gpuSprites = store.GpuSprites;
+    const uint32_t count = gpuSprites.Index.Count;
+
+    for (uint32_t slot = 0; slot < count; ++slot)
+    {
+        const GpuSpriteLayer& layer = *gpuSprites.Layer[slot];
+
+        gpuSprites.Position[slot] = GetGpuSpritePosition(layer, gpuSprites.Sprite[slot], time);
+        gpuSprites.Region[slot]   = GetGpuSpriteRegion(layer, gpuSprites.Sprite[slot], time);
+    }
+
+    if (FindOutOfBounds(gpuSprites.Position, gpuSprites.BoundsMin, gpuSprites.BoundsMax, count, gpuSprites.OutsideMask) > 0)
+    {
+        for (uint32_t word = 0; word < GetBoundsMaskWords(count); ++word)
+        {
+            for (uint32_t bits = gpuSprites.OutsideMask[word]; bits != 0; bits &= bits - 1)
+            {
+                const uint32_t slot = word * 32 + (uint32_t)__builtin_ctz(bits);
+                const BoundsMode mode = gpuSprites.Bounds[slot];
+
+                if (mode == BoundsMode::None) {
+                    continue;
+                }
+
+                // The line is restarted from the wrapped position, one quad upload per wrap
+                if (mode == BoundsMode::Wrap)
+                {
+                    GpuSpriteLayer& layer = *gpuSprites.Layer[slot];
+                    Vec2& position = gpuSprites.Position[slot];
+
+                    const Vec2& span = gpuSprites.WrapSpan[slot];
+                    const Vec2& min = gpuSprites.BoundsMin[slot];
+                    const Vec2& max = gpuSprites.BoundsMax[slot];
+
+                    position.X += (position.X < min.X) ? span.X : (position.X > max.X) ? -span.X : 0.0f;
+                    position.Y += (position.Y < min.Y) ? span.Y : (position.Y > max.Y) ? -span.Y : 0.0f;
+
+                    const uint32_t sprite = gpuSprites.Sprite[slot];
+                    SetGpuSpriteMotion(layer, sprite, position, GetGpuSpriteVelocity(layer, sprite), time);
+                }
+
+                if (store.EventCount < g_maxKinematicsEvents) {
+                    store.Events[store.EventCount++] = { gpuSprites.Index.Owners[slot], mode };
+                }
+            }
+        }
+    }
+
+    // Colliders and gameplay code keep reading the transform, if the entity still has one
+    for (uint32_t slot = 0; slot < count; ++slot)
+    {
+        const uint32_t transform = FindComponentSlot(store.Transforms.Index, gpuSprites.Index.Owners[slot]);
+
+        if (transform != g_invalidComponentSlot) {
+            store.Transforms.Position[transform] = gpuSprites.Position[slot];
+        }
+    }
+}
+
+void UpdateEntityAnimations(EntityStore& store, const float deltaTime)
+{
+    AnimatorComponents& animators = store.Animators;
+    store.AnimationEventCount = 0;
+
+    if (!store.Animations) {
+        return;
+    }
+
+    const AnimationClip* clips = store.Animations->Clips;
+
+    for (uint32_t slot = 0; slot < animators.Index.Count; ++slot)
+    {
+        const AnimationClip& clip = clips[animators.Clip[slot]];
+
+        const float previous = animators.Time[slot];
+        float time = previous + deltaTime * animators.Speed[slot];
+
+        if (time >= clip.Duration)
+        {
+            const bool isLoop = (clip.Mode == AnimationMode::Loop);
+
+            // Once clips report when they first reach the end, then hold it
+            if ((isLoop || previous < clip.Duration) && store.AnimationEventCount < g_maxAnimationEvents) {
+                store.AnimationEvents[store.AnimationEventCount++] = {
+                    animators.Index.Owners[slot], animators.Clip[slot], isLoop ? AnimationEventType::Looped : AnimationEventType::Finished
+                };
+            }
+
+            time = isLoop ? fmodf(time, clip.Duration) : clip.Duration;
+        }
+
+        // Played backwards past the start, loops wrap around to the end and Once clips hold the first frame
+        else if (time < 0.0f) {
+            time = (clip.Mode == AnimationMode::Loop) ? clip.Duration + fmodf(time, clip.Duration) : 0.0f;
+        }
+
+        animators.Time[slot] = time;
+
+        const uint32_t frame = GetAnimationClipFrame(clip, time);
+
+        if (frame != animators.Frame[slot]) {
+            animators.Frame[slot] = frame;
+            ApplyAnimationFrame(store, slot);
+        }
+    }
+}
+
+// Atlas region an entity shows, whether the batcher or a GPU sprite layer draws it
+inline const Rect2D* FindEntityRegion(const EntityStore& store, const EntityId entity)
+{
+    const uint32_t sprite = FindComponentSlot(store.Sprites.Index, entity);
+
+    if (sprite != g_invalidComponentSlot) {
+        return &store.Sprites.Sprites[sprite].TexRect;
+    }
+
+    const uint32_t gpuSprite = FindComponentSlot(store.GpuSprites.Index, entity);
+    return (gpuSprite != g_invalidComponentSlot) ? &store.GpuSprites.Region[gpuSprite] : nullptr;
+}
+
+uint32_t UpdateEntityCollisions(EntityStore& store, CollisionGrid& grid)
+{
+    ColliderComponents& colliders = store.Colliders;
+    const uint32_t count = colliders.Index.Count;
+
+    for (uint32_t slot = 0; slot < count; ++slot)
+    {
+        const EntityId entity = colliders.Index.Owners[slot];
+
+        const uint32_t transform = FindComponentSlot(store.Transforms.Index, entity);
+        const uint32_t sprite = FindComponentSlot(store.Sprites.Index, entity);
+        const uint32_t gpuSprite = FindComponentSlot(store.GpuSprites.Index, entity);
+
+        // Nothing to place the box with, park it where nothing reaches
+        if (transform == g_invalidComponentSlot || (sprite == g_invalidComponentSlot && gpuSprite == g_invalidComponentSlot))
+        {
+            ParkColliderBounds(colliders, slot);
+            continue;
+        }
+
+        const Vec2& position = store.Transforms.Position[transform];
+        const Vec2& scale = store.Transforms.Scale[transform];
+        const Vec2 spriteSize = (sprite != g_invalidComponentSlot) ? store.Sprites.Sprites[sprite].Size :
+                                Vec2(store.GpuSprites.Region[gpuSprite].Width, store.GpuSprites.Region[gpuSprite].Height);
+
+        const float sizeX = spriteSize.X * scale.X;
+        const float sizeY = spriteSize.Y * scale.Y;
+
+        colliders.Bounds.MinX[slot] = position.X + sizeX * colliders.Offset[slot].X;
+        colliders.Bounds.MinY[slot] = position.Y + sizeY * colliders.Offset[slot].Y;
+        colliders.Bounds.MaxX[slot] = colliders.Bounds.MinX[slot] + sizeX * colliders.Extent[slot].X;
+        colliders.Bounds.MaxY[slot] = colliders.Bounds.MinY[slot] + sizeY * colliders.Extent[slot].Y;
+    }
+
+    BuildCollisionGrid(grid, colliders.Bounds, colliders.Layer, colliders.Mask, count);
+
+    store.CollisionCount = FindCollisionPairs(grid);
+
+    for (uint32_t index = 0; index < store.CollisionCount; ++index)
+    {
+        store.Collisions[index] = { colliders.Index.Owners[grid.Pairs[index].First],
+                                    colliders.Index.Owners[grid.Pairs[index].Second] };
+    }
+
+    return store.CollisionCount;
+}
+
+uint32_t QueryEntities(EntityStore& store, CollisionGrid& grid, const ScreenRect& region, const uint32_t layerMask,
+                       EntityId* results, const uint32_t maxResults)
+{
+    const uint32_t count = QueryCollisionRegion(grid, region, layerMask, results, maxResults);
+
+    // Collider slots to handles, in place
+    for (uint32_t index = 0; index < count; ++index) {
+        results[index] = store.Colliders.Index.Owners[results[index]];
+    }
+
+    return count;
+}
+
+uint32_t OverlapEntities(EntityStore& store, const ScreenRect& box, const uint32_t layerMask,
+                         EntityId* results, const uint32_t maxResults)
+{
+    ColliderComponents& colliders = store.Colliders;
+    const uint32_t count = colliders.Index.Count;
+
+    const uint32_t hitCount = OverlapBounds(colliders.Bounds, colliders.Layer, count, box, layerMask, colliders.HitMask);
+
+    if (results == nullptr || hitCount == 0) {
+        return hitCount;
+    }
+
+    uint32_t resultCount = 0;
+
+    for (uint32_t word = 0; word < GetCullMaskWords(count); ++word)
+    {
+        for (uint32_t bits = colliders.HitMask[word]; bits != 0 && resultCount < maxResults; bits &= bits - 1) {
+            results[resultCount++] = colliders.Index.Owners[word * 32 + (uint32_t)__builtin_ctz(bits)];
+        }
+    }
+
+    return resultCount;
+}
+
+bool TestEntityMasks(EntityStore& store, const EntityId lhe, const EntityId rhe)
+{
+    if (!store.CollisionMasks) {
+        return true;
+    }
+
+    const Rect2D* lheRegion = FindEntityRegion(store, lhe);
+    const Rect2D* rheRegion = FindEntityRegion(store, rhe);
+    const uint32_t lheTransform = FindComponentSlot(store.Transforms.Index, lhe);
+    const uint32_t rheTransform = FindComponentSlot(store.Transforms.Index, rhe);
+
+    if (!lheRegion || !rheRegion ||
+        lheTransform == g_invalidComponentSlot || rheTransform == g_invalidComponentSlot) {
+        return true;
+    }
+
+    const CollisionMaskAtlas& atlas = *store.CollisionMasks;
+
+    const CollisionMask* lheMask = FindCollisionMask(atlas, *lheRegion);
+    const CollisionMask* rheMask = FindCollisionMask(atlas, *rheRegion);
+
+    if (!lheMask || !rheMask) {
+        return true;
+    }
+
+    return TestCollisionMasks(atlas, *lheMask, store.Transforms.Position[lheTransform], store.Transforms.Scale[lheTransform],
+                              *rheMask, store.Transforms.Position[rheTransform], store.Transforms.Scale[rheTransform]);
+}
+
+void SubmitEntitySprites(EntityStore& store, RenderQueue& queue, const uint32_t program)
+{
+    SpriteComponents& sprites = store.Sprites;
+    const TransformComponents& transforms = store.Transforms;
+
+    for (uint32_t slot = 0; slot < sprites.Index.Count; ++slot)
+    {
+        Sprite& sprite = sprites.Sprites[slot];
+        const uint32_t transform = transforms.Index.Sparse[GetEntityIndex(sprites.Index.Owners[slot])];
+
+        // The setters only flag a vertex rebuild when the value actually changed
+        if (transform != g_invalidComponentSlot) {
+            SpriteSetPosition(sprite, transforms.Position[transform]);
+            SpriteSetScale(sprite, transforms.Scale[transform]);
+        }
+
+        const uint64_t key = MakeRenderSortKey(sprites.Layer[slot], true, program, sprite.Texture->Id, sprites.Depth[slot]);
+        RenderQueueSubmit(queue, key, sprite);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,229 @@
+#ifndef ENTITY_STORE_H
+#define ENTITY_STORE_H
+
+#include "animation.h"
+#include "collision.h"
+#include "collision_mask.h"
+#include "gfx_math.h"
+#include "gpu_sprite_layer.h"
+#include "kinematics.h"
+#include "render_queue.h"
+#include "sprite.h"
+#include "sprite_mesh.h"
+#include "texture2d.h"
+
+#include <cstdint>
+
+constexpr const uint32_t g_maxEntities = 16384;
+constexpr const uint32_t g_entityIndexBits = 20;
+constexpr const uint32_t g_entityIndexMask = (1u << g_entityIndexBits) - 1;
+constexpr const uint32_t g_entityGenerationMask = (1u << (32 - g_entityIndexBits)) - 1;
+constexpr const uint32_t g_invalidEntity = 0xFFFFFFFF;
+constexpr const uint32_t g_invalidComponentSlot = 0xFFFFFFFF;
+constexpr const uint32_t g_maxKinematicsEvents = 256;
+constexpr const uint32_t g_maxAnimationEvents = 256;
+
+// Index in the low bits, generation in the high ones, a handle stops matching once its index is reused
+typedef uint32_t EntityId;
+
+inline uint32_t GetEntityIndex(const EntityId entity)
+{
+    return entity & g_entityIndexMask;
+}
+
+inline uint32_t GetEntityGeneration(const EntityId entity)
+{
+    return entity >> g_entityIndexBits;
+}
+
+// Sparse set, component data lives in dense arrays indexed by slot and stays packed on removal
+typedef struct {
+    uint32_t* Sparse;       // Entity index -> dense slot
+    EntityId* Owners;       // Dense slot -> entity
+    uint32_t Count;
+    uint32_t Capacity;
+} ComponentIndex;
+
+// Entities with a velocity occupy the first transform slots, in the same order as their velocity slots
+typedef struct {
+    ComponentIndex Index;
+    Vec2* Position;         // Work resolution units, top left corner
+    Vec2* Scale;
+} TransformComponents;
+
+typedef struct {
+    ComponentIndex Index;
+    Sprite* Sprites;        // Render payload, vertices stay cached until a field changes
+    uint32_t* Layer;
+    float* Depth;           // 0 is the front
+} SpriteComponents;
+
+typedef struct {
+    ComponentIndex Index;
+    Vec2* Velocity;         // Work resolution units per second
+    Vec2* Acceleration;
+    Vec2* BoundsMin;        // Position limits, unbounded by default
+    Vec2* BoundsMax;
+    Vec2* WrapSpan;
+    BoundsMode* Bounds;
+    uint32_t* OutsideMask;
+} VelocityComponents;
+
+typedef struct {
+    ComponentIndex Index;
+    Vec2* Offset;           // Both relative to the scaled sprite size, an extent of 1 covers the whole sprite
+    Vec2* Extent;
+    uint32_t* Layer;        // Bits the collider is on
+    uint32_t* Mask;         // Bits it collides with
+    BoundsSoA Bounds;       // World space, refreshed by UpdateEntityCollisions
+    uint32_t* HitMask;
+} ColliderComponents;
+
+typedef struct {
+    ComponentIndex Index;
+    uint32_t* Clip;         // Into the store animation library
+    float* Time;            // Seconds into the clip
+    float* Speed;           // Playback rate, 0 pauses and negative plays backwards
+    uint32_t* Frame;        // Clip frame the sprite is showing
+} AnimatorComponents;
+
+typedef struct {
+    ComponentIndex Index;
+    GpuSpriteLayer** Layer;     // Drawn and moved by the layer, the store only evaluates the same closed form
+    uint32_t* Sprite;
+    Vec2* Position;             // Refreshed by UpdateEntityGpuSprites, then copied to the transform
+    Rect2D* Region;             // Frame shown this frame, stands in for the sprite region
+    Vec2* BoundsMin;
+    Vec2* BoundsMax;
+    Vec2* WrapSpan;
+    BoundsMode* Bounds;
+    uint32_t* OutsideMask;
+} GpuSpriteComponents;
+
+typedef struct {
+    EntityId Entity;
+    BoundsMode Mode;        // Wrapped entities were already moved back, respawned ones are left to the game
+} KinematicsEvent;
+
+typedef struct {
+    EntityId First;
+    EntityId Second;
+} EntityCollision;
+
+typedef struct {
+    EntityId Entity;
+    uint32_t Clip;
+    AnimationEventType Type;
+} AnimationEvent;
+
+typedef struct {
+    uint32_t* Generations;
+    uint32_t* FreeIndices;
+    uint32_t FreeCount;
+    uint32_t NextIndex;
+    uint32_t Capacity;
+    uint32_t AliveCount;
+    TransformComponents Transforms;
+    SpriteComponents Sprites;
+    VelocityComponents Velocities;
+    ColliderComponents Colliders;
+    AnimatorComponents Animators;
+    GpuSpriteComponents GpuSprites;
+    const SpriteMeshAtlas* Meshes;  // Optional, looked up whenever a sprite region changes
+    const CollisionMaskAtlas* CollisionMasks;   // Optional, found by sprite region for the pixel narrowphase
+    KinematicsEvent Events[g_maxKinematicsEvents];
+    uint32_t EventCount;
+    EntityCollision* Collisions;
+    uint32_t CollisionCount;
+    const AnimationLibrary* Animations;     // Needed by the animators, clip ids index into it
+    AnimationEvent AnimationEvents[g_maxAnimationEvents];
+    uint32_t AnimationEventCount;
+} EntityStore;
+
+void CreateEntityStore(EntityStore& store, const uint32_t capacity = g_maxEntities);
+void DestroyEntityStore(EntityStore& store);
+
+EntityId CreateEntity(EntityStore& store);
+void DestroyEntity(EntityStore& store, const EntityId entity);
+bool IsEntityAlive(const EntityStore& store, const EntityId entity);
+
+// Returns g_invalidComponentSlot when the entity doesn't have the component
+uint32_t FindComponentSlot(const ComponentIndex& index, const EntityId entity);
+
+void AddTransform(EntityStore& store, const EntityId entity, const Vec2& position, const Vec2& scale = { 1.0f, 1.0f });
+void AddSprite(EntityStore& store, const EntityId entity, Texture2D& texture, const Rect2D& texRect,
+               const uint32_t color, const uint32_t layer, const float depth = 0.0f);
+// Requires a transform, moving entities are kept packed at the front of the transform arrays
+void AddVelocity(EntityStore& store, const EntityId entity, const Vec2& velocity, const Vec2& acceleration = { 0.0f, 0.0f });
+void AddCollider(EntityStore& store, const EntityId entity, const Vec2& offset = { 0.0f, 0.0f }, const Vec2& extent = { 1.0f, 1.0f },
+                 const uint32_t layer = 1, const uint32_t mask = 0xFFFFFFFF);
+
+// The entity needs a transform, it spawns at its position and moves at a constant velocity from there.
+// Entities with a GPU sprite have neither a sprite nor a velocity component
+void AddGpuSprite(EntityStore& store, const EntityId entity, GpuSpriteLayer& layer, const uint32_t clip,
+                  const Vec2& velocity, const uint32_t color, const float time);
+
+// The entity needs a sprite, the first frame of the clip is shown right away
+void AddAnimator(EntityStore& store, const EntityId entity, const uint32_t clip, const float speed = 1.0f);
+
+void RemoveTransform(EntityStore& store, const EntityId entity);
+void RemoveSprite(EntityStore& store, const EntityId entity);
+void RemoveVelocity(EntityStore& store, const EntityId entity);
+void RemoveCollider(EntityStore& store, const EntityId entity);
+void RemoveAnimator(EntityStore& store, const EntityId entity);
+void RemoveGpuSprite(EntityStore& store, const EntityId entity);
+
+// Accessors for game code, missing components log an error and hand back a scratch value
+Vec2& GetEntityPosition(EntityStore& store, const EntityId entity);
+Vec2& GetEntityScale(EntityStore& store, const EntityId entity);
+Vec2& GetEntityVelocity(EntityStore& store, const EntityId entity);
+Vec2& GetEntityAcceleration(EntityStore& store, const EntityId entity);
+void SetEntityBounds(EntityStore& store, const EntityId entity, const Vec2& min, const Vec2& max,
+                     const BoundsMode& mode, const Vec2& wrapSpan = { 0.0f, 0.0f });
+const Sprite& GetEntitySprite(EntityStore& store, const EntityId entity);
+void SetEntityTexRect(EntityStore& store, const EntityId entity, const Rect2D& texRect);
+void SetEntityColor(EntityStore& store, const EntityId entity, const uint32_t color);
+
+// Switching to the clip already playing keeps its time unless restart is set
+void PlayEntityAnimation(EntityStore& store, const EntityId entity, const uint32_t clip, const bool restart = false);
+void SetEntityAnimationSpeed(EntityStore& store, const EntityId entity, const float speed);
+
+// GPU sprites only, a new straight line starting at position now. One quad upload each
+void SetEntityMotion(EntityStore& store, const EntityId entity, const Vec2& position, const Vec2& velocity, const float time);
+void SetEntityGpuClip(EntityStore& store, const EntityId entity, const uint32_t clip, const float time);
+
+// Scaled sprite size, what the entity covers on screen in work resolution units
+Vec2 GetEntitySize(EntityStore& store, const EntityId entity);
+
+// Collider box in work resolution units, false when the entity has no collider
+bool GetEntityCollider(EntityStore& store, const EntityId entity, Vec2& position, Vec2& size);
+
+// Moves every entity with a velocity, then wraps or reports the ones that left their bounds
+void UpdateEntityKinematics(EntityStore& store, const float deltaTime);
+
+// Evaluates where the GPU moved every GPU sprite, then wraps or reports the ones that left their bounds.
+// Runs after UpdateEntityKinematics, its events are appended to the kinematics ones
+void UpdateEntityGpuSprites(EntityStore& store, const float time);
+
+// Advances every animator, swaps sprite regions on frame changes and reports loops and finished clips
+void UpdateEntityAnimations(EntityStore& store, const float deltaTime);
+
+// Rebuilds the broadphase from the collider bounds and lists the overlapping entity pairs
+uint32_t UpdateEntityCollisions(EntityStore& store, CollisionGrid& grid);
+
+// Entities whose collider overlaps the region, as of the last UpdateEntityCollisions
+uint32_t QueryEntities(EntityStore& store, CollisionGrid& grid, const ScreenRect& region, const uint32_t layerMask,
+                       EntityId* results, const uint32_t maxResults);
+
+// Batch test of one box against every collider, handles are written when results isn't null
+uint32_t OverlapEntities(EntityStore& store, const ScreenRect& box, const uint32_t layerMask,
+                         EntityId* results = nullptr, const uint32_t maxResults = 0);
+
+// Pixel test of two entities through the masks of their current sprite regions.
+// Entities without a mask keep the bounds result, so this only ever narrows an overlap down
+bool TestEntityMasks(EntityStore& store, const EntityId lhe, const EntityId rhe);
+
+// Copies transforms into the sprite payloads and submits every sprite to the queue
+void SubmitEntitySprites(EntityStore& store, RenderQueue& queue, const uint32_t program);
+
+#endif // ENTITY_STORE_H
\ No newline at end of file
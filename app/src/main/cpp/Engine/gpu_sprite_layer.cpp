@@ -0,0 +1,323 @@
+#include "gpu_sprite_layer.h"
+
+#include "utils.h"
+
+#include <cmath>
+
+inline void BakeClipTables(GpuSpriteLayer& layer, const AnimationLibrary& animations)
+{
+    layer.FrameCount = (animations.FrameCount > g_maxGpuAnimationFrames) ? g_maxGpuAnimationFrames : animations.FrameCount;
+    layer.ClipCount  = 0;
+
+    if (animations.FrameCount > g_maxGpuAnimationFrames || animations.ClipCount > g_maxGpuAnimationClips) {
+        LogError("gfxError: Animation library exceeds the shader tables, extra clips are dropped :: BakeClipTables()");
+    }
+
+    for (uint32_t index = 0; index < layer.FrameCount; ++index)
+    {
+        for (uint32_t component = 0; component < 4; ++component) {
+            layer.FrameTable[index][component] = animations.Frames[index].UV[component];
+        }
+    }
+
+    // Clips keep their library ids, so they stop at the first one that doesn't fit
+    for (uint32_t index = 0; index < animations.ClipCount && index < g_maxGpuAnimationClips; ++index)
+    {
+        const AnimationClip& clip = animations.Clips[index];
+
+        if (clip.FirstFrame + clip.FrameCount > layer.FrameCount) {
+            break;
+        }
+
+        layer.ClipTable[index][0] = (float)clip.FirstFrame;
+        layer.ClipTable[index][1] = (float)clip.FrameCount;
+        layer.ClipTable[index][2] = clip.FrameTime;
+        layer.ClipTable[index][3] = (clip.Mode == AnimationMode::Once) ? 1.0f : 0.0f;
+
+        layer.ClipCount++;
+    }
+}
+
+inline void MarkSpriteDirty(GpuSpriteLayer& layer, const uint32_t sprite)
+{
+    const uint32_t quadSize = 4 * sizeof(GpuSpriteVertex);
+    MarkStreamingVertexBufferDirty(layer.Stream, sprite * quadSize, quadSize);
+}
+
+inline uint32_t GetLiveMaskWords(const uint32_t capacity)
+{
+    return (capacity + 31) / 32;
+}
+
+inline bool IsGpuSpriteLive(const GpuSpriteLayer& layer, const uint32_t sprite)
+{
+    return (layer.LiveMask[sprite / 32] & (1u << (sprite % 32))) != 0;
+}
+
+// Freed slots are rejected too, removing one twice would hand the same quad to two sprites
+inline bool IsValidGpuSprite(const GpuSpriteLayer& layer, const uint32_t sprite)
+{
+    if (sprite >= layer.Count || !IsGpuSpriteLive(layer, sprite)) {
+        LogError("gfxError: Unknown GPU sprite %u :: IsValidGpuSprite()", sprite);
+        return false;
+    } return true;
+}
+
+void CreateGpuSpriteLayer(GpuSpriteLayer& layer, const uint32_t program, QuadIndexBuffer& indexBuffer, const Texture2D& texture,
+                          const AnimationLibrary& animations, const uint32_t capacity)
+{
+    layer.Capacity    = (capacity > indexBuffer.MaxQuads) ? indexBuffer.MaxQuads : capacity;
+    layer.Count       = 0;
+    layer.FreeCount   = 0;
+    layer.Program     = program;
+    layer.QuadIndices = &indexBuffer;
+    layer.Texture     = &texture;
+    layer.Animations  = &animations;
+
+    layer.Tint[0] = layer.Tint[1] = layer.Tint[2] = layer.Tint[3] = 1.0f;
+
+    BakeClipTables(layer, animations);
+
+    layer.Vertices  = new GpuSpriteVertex[4 * layer.Capacity];
+    layer.FreeSlots = new uint32_t[layer.Capacity];
+    layer.LiveMask  = new uint32_t[GetLiveMaskWords(layer.Capacity)];
+
+    for (uint32_t word = 0; word < GetLiveMaskWords(layer.Capacity); ++word) {
+        layer.LiveMask[word] = 0;
+    }
+
+    const VertexElement layout[] = {
+        VertexElement::Position,
+        VertexElement::Color,
+        VertexElement::Corner,
+        VertexElement::Animation,
+        VertexElement::Motion
+    }; const uint32_t nLayout = sizeof(layout) / sizeof(VertexElement);
+
+    VertexBuffer source;
+    source.Stride = sizeof(GpuSpriteVertex);
+    source.Size   = 4 * layer.Capacity * sizeof(GpuSpriteVertex);
+    source.Data   = layer.Vertices;
+
+    CreateStreamingVertexBuffer(program, layout, nLayout, source, layer.Stream, StreamingMode::Ring);
+
+    // Creation enabled the arrays at this program's locations, the sprite batch program doesn't know about them
+    DisableVertexBufferAttribs(GetStreamingVertexBufferCurrent(layer.Stream));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    layer.Uniforms.ModelViewProj = glGetUniformLocation(program, "ModelViewProj");
+    layer.Uniforms.WorkResScale  = glGetUniformLocation(program, "WorkResScale");
+    layer.Uniforms.AtlasSize     = glGetUniformLocation(program, "AtlasSize");
+    layer.Uniforms.Tint          = glGetUniformLocation(program, "Tint");
+    layer.Uniforms.Time          = glGetUniformLocation(program, "Time");
+    layer.Uniforms.Clips         = glGetUniformLocation(program, "Clips");
+    layer.Uniforms.Frames        = glGetUniformLocation(program, "Frames");
+    layer.Uniforms.Textures      = glGetUniformLocation(program, "Textures");
+
+    ReserveQuadIndexBuffer(indexBuffer, layer.Capacity);
+}
+
+void DestroyGpuSpriteLayer(GpuSpriteLayer& layer)
+{
+    DestroyStreamingVertexBuffer(layer.Stream);
+
+    delete[] layer.LiveMask;
+    delete[] layer.FreeSlots;
+    delete[] layer.Vertices;
+
+    layer.LiveMask  = nullptr;
+    layer.FreeSlots = nullptr;
+    layer.Vertices  = nullptr;
+    layer.Capacity  = 0;
+    layer.Count     = 0;
+    layer.FreeCount = 0;
+}
+
+uint32_t AddGpuSprite(GpuSpriteLayer& layer, const uint32_t clip, const Vec2& position, const Vec2& velocity,
+                      const Vec2& scale, const uint32_t color, const float startTime)
+{
+    if (clip >= layer.ClipCount) {
+        LogError("gfxError: Clip %u isn't in the GPU tables :: AddGpuSprite()", clip);
+        return g_invalidGpuSprite;
+    }
+
+    uint32_t sprite;
+
+    if (layer.FreeCount > 0) {
+        sprite = layer.FreeSlots[--layer.FreeCount];
+    }
+
+    else if (layer.Count < layer.Capacity) {
+        sprite = layer.Count++;
+    }
+
+    else {
+        LogError("gfxError: GPU sprite layer is full :: AddGpuSprite()");
+        return g_invalidGpuSprite;
+    }
+
+    layer.LiveMask[sprite / 32] |= 1u << (sprite % 32);
+
+    float r, g, b, a;
+    DwordToColorNormalized(color, r, g, b, a);
+
+    // Same corner order as the sprite quads, so the shared quad indices wind them the same way
+    const float corners[4][2] = { { 0.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f }, { 1.0f, 0.0f } };
+
+    GpuSpriteVertex* vertices = &layer.Vertices[4 * sprite];
+
+    for (uint32_t index = 0; index < 4; ++index)
+    {
+        vertices[index] = { { position.X, position.Y, 0.0f }, { r, g, b, a }, { corners[index][0], corners[index][1] },
+                            { (float)clip, startTime, scale.X, scale.Y }, { velocity.X, velocity.Y, startTime, 0.0f } };
+    }
+
+    MarkSpriteDirty(layer, sprite);
+    return sprite;
+}
+
+void RemoveGpuSprite(GpuSpriteLayer& layer, const uint32_t sprite)
+{
+    if (!IsValidGpuSprite(layer, sprite)) {
+        return;
+    }
+
+    GpuSpriteVertex* vertices = &layer.Vertices[4 * sprite];
+
+    // The slot keeps being drawn until it's reused, without any area it produces no fragments
+    for (uint32_t index = 0; index < 4; ++index) {
+        vertices[index].Animation[2] = 0.0f;
+        vertices[index].Animation[3] = 0.0f;
+    }
+
+    layer.LiveMask[sprite / 32] &= ~(1u << (sprite % 32));
+    layer.FreeSlots[layer.FreeCount++] = sprite;
+
+    MarkSpriteDirty(layer, sprite);
+}
+
+void SetGpuSpriteClip(GpuSpriteLayer& layer, const uint32_t sprite, const uint32_t clip, const float startTime)
+{
+    if (!IsValidGpuSprite(layer, sprite) || clip >= layer.ClipCount) {
+        return;
+    }
+
+    GpuSpriteVertex* vertices = &layer.Vertices[4 * sprite];
+
+    for (uint32_t index = 0; index < 4; ++index) {
+        vertices[index].Animation[0] = (float)clip;
+        vertices[index].Animation[1] = startTime;
+    }
+
+    MarkSpriteDirty(layer, sprite);
+}
+
+void SetGpuSpritePosition(GpuSpriteLayer& layer, const uint32_t sprite, const Vec2& position)
+{
+    if (!IsValidGpuSprite(layer, sprite)) {
+        return;
+    }
+
+    GpuSpriteVertex* vertices = &layer.Vertices[4 * sprite];
+
+    for (uint32_t index = 0; index < 4; ++index) {
+        vertices[index].Position[0] = position.X;
+        vertices[index].Position[1] = position.Y;
+    }
+
+    MarkSpriteDirty(layer, sprite);
+}
+
+void SetGpuSpriteMotion(GpuSpriteLayer& layer, const uint32_t sprite, const Vec2& position, const Vec2& velocity, const float time)
+{
+    if (!IsValidGpuSprite(layer, sprite)) {
+        return;
+    }
+
+    GpuSpriteVertex* vertices = &layer.Vertices[4 * sprite];
+
+    for (uint32_t index = 0; index < 4; ++index)
+    {
+        vertices[index].Position[0] = position.X;
+        vertices[index].Position[1] = position.Y;
+        vertices[index].Motion[0]   = velocity.X;
+        vertices[index].Motion[1]   = velocity.Y;
+        vertices[index].Motion[2]   = time;
+    }
+
+    MarkSpriteDirty(layer, sprite);
+}
+
+void SetGpuSpriteLayerTint(GpuSpriteLayer& layer, const uint32_t color)
+{
+    DwordToColorNormalized(color, layer.Tint[0], layer.Tint[1], layer.Tint[2], layer.Tint[3]);
+}
+
+Vec2 GetGpuSpritePosition(const GpuSpriteLayer& layer, const uint32_t sprite, const float time)
+{
+    const GpuSpriteVertex& vertex = layer.Vertices[4 * sprite];
+    const float elapsed = time - vertex.Motion[2];
+
+    return { vertex.Position[0] + vertex.Motion[0] * elapsed, vertex.Position[1] + vertex.Motion[1] * elapsed };
+}
+
+Vec2 GetGpuSpriteVelocity(const GpuSpriteLayer& layer, const uint32_t sprite)
+{
+    const GpuSpriteVertex& vertex = layer.Vertices[4 * sprite];
+    return { vertex.Motion[0], vertex.Motion[1] };
+}
+
+const Rect2D& GetGpuSpriteRegion(const GpuSpriteLayer& layer, const uint32_t sprite, const float time)
+{
+    const GpuSpriteVertex& vertex = layer.Vertices[4 * sprite];
+    const AnimationClip& clip = layer.Animations->Clips[(uint32_t)vertex.Animation[0]];
+
+    // Same frame selection as the vertex shader
+    const float elapsed = (time > vertex.Animation[1]) ? time - vertex.Animation[1] : 0.0f;
+    const uint32_t frame = (clip.Mode == AnimationMode::Once) ? GetAnimationClipFrame(clip, elapsed)
+                                                              : (uint32_t)floorf(elapsed / clip.FrameTime) % clip.FrameCount;
+
+    return layer.Animations->Frames[clip.FirstFrame + frame].Region;
+}
+
+Vec2 GetGpuSpriteSize(const GpuSpriteLayer& layer, const uint32_t sprite, const float time)
+{
+    if (!IsValidGpuSprite(layer, sprite)) {
+        return { 0.0f, 0.0f };
+    }
+
+    const GpuSpriteVertex& vertex = layer.Vertices[4 * sprite];
+    const Rect2D& region = GetGpuSpriteRegion(layer, sprite, time);
+
+    return { region.Width * vertex.Animation[2], region.Height * vertex.Animation[3] };
+}
+
+void DrawGpuSpriteLayer(GpuSpriteLayer& layer, const Matrix& modelViewProj, const Vec2& workResScale, const float time)
+{
+    // Uploads only happen for quads written since this ring buffer was last current
+    FlushStreamingVertexBuffer(layer.Stream);
+
+    if (layer.Count == layer.FreeCount || !layer.Texture->IsReady) {
+        DisableVertexBufferAttribs(GetStreamingVertexBufferCurrent(layer.Stream));
+        return;
+    }
+
+    glUseProgram(layer.Program);
+
+    glUniformMatrix4fv(layer.Uniforms.ModelViewProj, 1, GL_FALSE, &modelViewProj.M[0][0]);
+    glUniform2f(layer.Uniforms.WorkResScale, workResScale.X, workResScale.Y);
+    glUniform2f(layer.Uniforms.AtlasSize, (float)layer.Texture->Width, (float)layer.Texture->Height);
+    glUniform4fv(layer.Uniforms.Tint, 1, layer.Tint);
+    glUniform1f(layer.Uniforms.Time, time);
+    glUniform4fv(layer.Uniforms.Clips, layer.ClipCount, &layer.ClipTable[0][0]);
+    glUniform4fv(layer.Uniforms.Frames, layer.FrameCount, &layer.FrameTable[0][0]);
+    glUniform1i(layer.Uniforms.Textures, 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, layer.Texture->Id);
+
+    BindIndexBuffer(layer.QuadIndices->Buffer);
+    glDrawElements(GL_TRIANGLES, 6 * layer.Count, (uint32_t)layer.QuadIndices->Type, nullptr);
+
+    DisableVertexBufferAttribs(GetStreamingVertexBufferCurrent(layer.Stream));
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifndef GPU_SPRITE_LAYER_H
+#define GPU_SPRITE_LAYER_H
+
+#include "animation.h"
+#include "gfx_math.h"
+#include "index_buffer.h"
+#include "texture2d.h"
+#include "vertex_buffer.h"
+
+#include <cstdint>
+
+constexpr const uint32_t g_maxGpuSprites = 1024;
+constexpr const uint32_t g_maxGpuAnimationClips = 16;     // Must match the uniform arrays of the GPU sprite vertex shader
+constexpr const uint32_t g_maxGpuAnimationFrames = 48;
+constexpr const uint32_t g_invalidGpuSprite = 0xFFFFFFFF;
+
+typedef struct {
+    float Position[3];      // Quad origin at spawn time, work resolution units
+    float Color[4];
+    float Corner[2];        // 0 or 1 on each axis
+    float Animation[4];     // Clip, start time, scale (XY)
+    float Motion[4];        // Velocity (XY), spawn time, unused
+} GpuSpriteVertex;
+
+typedef struct {
+    int32_t ModelViewProj;
+    int32_t WorkResScale;
+    int32_t AtlasSize;
+    int32_t Tint;
+    int32_t Time;
+    int32_t Clips;
+    int32_t Frames;
+    int32_t Textures;
+} GpuSpriteUniforms;
+
+// Quads whose frame is picked by the vertex shader from the clip tables and a time uniform,
+// and that move in a straight line from where they spawned. Nothing is uploaded unless a sprite
+// is added, removed or changed, so the cost follows the spawn rate rather than the sprite count
+typedef struct {
+    StreamingVertexBuffer Stream;
+    GpuSpriteVertex* Vertices;
+    uint32_t* FreeSlots;
+    uint32_t FreeCount;
+    uint32_t* LiveMask;     // One bit per slot, set while a sprite uses it
+    uint32_t Count;         // Slots [0, Count) are drawn, free ones have no area
+    uint32_t Capacity;
+    uint32_t Program;
+    GpuSpriteUniforms Uniforms;
+    QuadIndexBuffer* QuadIndices;
+    const Texture2D* Texture;
+    const AnimationLibrary* Animations;
+    float ClipTable[g_maxGpuAnimationClips][4];     // First frame, frame count, frame time, 1 when it holds its last frame
+    float FrameTable[g_maxGpuAnimationFrames][4];   // U0 V0 U1 V1
+    uint32_t ClipCount;
+    uint32_t FrameCount;
+    float Tint[4];
+} GpuSpriteLayer;
+
+// The program has to be linked already, the clip tables are baked from the library here
+void CreateGpuSpriteLayer(GpuSpriteLayer& layer, const uint32_t program, QuadIndexBuffer& indexBuffer, const Texture2D& texture,
+                          const AnimationLibrary& animations, const uint32_t capacity = g_maxGpuSprites);
+void DestroyGpuSpriteLayer(GpuSpriteLayer& layer);
+
+// Returns g_invalidGpuSprite when the layer is full or the clip isn't in the tables
+uint32_t AddGpuSprite(GpuSpriteLayer& layer, const uint32_t clip, const Vec2& position, const Vec2& velocity,
+                      const Vec2& scale, const uint32_t color, const float startTime);
+void RemoveGpuSprite(GpuSpriteLayer& layer, const uint32_t sprite);
+
+void SetGpuSpriteClip(GpuSpriteLayer& layer, const uint32_t sprite, const uint32_t clip, const float startTime);
+void SetGpuSpritePosition(GpuSpriteLayer& layer, const uint32_t sprite, const Vec2& position);
+
+// Restarts the straight line, the sprite is at position at that time and keeps moving from there
+void SetGpuSpriteMotion(GpuSpriteLayer& layer, const uint32_t sprite, const Vec2& position, const Vec2& velocity, const float time);
+
+// Multiplies every vertex color, fading the whole layer costs a uniform instead of an upload
+void SetGpuSpriteLayerTint(GpuSpriteLayer& layer, const uint32_t color);
+
+// The same closed forms the vertex shader evaluates, nothing is read back
+Vec2 GetGpuSpritePosition(const GpuSpriteLayer& layer, const uint32_t sprite, const float time);
+Vec2 GetGpuSpriteVelocity(const GpuSpriteLayer& layer, const uint32_t sprite);
+const Rect2D& GetGpuSpriteRegion(const GpuSpriteLayer& layer, const uint32_t sprite, const float time);
+
+// Scaled size of the frame shown at that time
+Vec2 GetGpuSpriteSize(const GpuSpriteLayer& layer, const uint32_t sprite, const float time);
+
+// Switches to the layer program and leaves it bound, the caller restores its own
+void DrawGpuSpriteLayer(GpuSpriteLayer& layer, const Matrix& modelViewProj, const Vec2& workResScale, const float time);
+
+#endif // GPU_SPRITE_LAYER_H
\ No newline at end of file
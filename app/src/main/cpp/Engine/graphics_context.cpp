@@ -1,9 +1,17 @@
 #include "graphics_context.h"
 
+#include <cstring>
+
 void GraphicsContext::Create(const uint32_t width, const uint32_t height)
 {
     Width  = width;
     Height = height;
+
+    bUintIndices = HasExtension("GL_OES_element_index_uint");
+
+    // Blending is disabled by default in GLES2
+    CurrentBlendMode = BlendMode::Opaque;
+    glDisable(GL_BLEND);
 }
 
 void GraphicsContext::ClearBackBuffer(const float r, const float g, const float b, const float a)
@@ -24,14 +32,75 @@ void GraphicsContext::DisableDepthBufferTesting()
     glDisable(GL_DEPTH_TEST);
 }
 
+void GraphicsContext::SetBlendMode(const BlendMode& mode)
+{
+    if (mode == CurrentBlendMode) {
+        return;
+    }
+
+    switch (mode)
+    {
+    case BlendMode::Opaque:
+        glDisable(GL_BLEND);
+        break;
+
+    case BlendMode::Alpha:
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        break;
+
+    case BlendMode::PremultipliedAlpha:
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        break;
+
+    case BlendMode::Additive:
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE);
+        break;
+    }
+
+    CurrentBlendMode = mode;
+}
+
 void GraphicsContext::Draw(const PrimitiveType& type, const uint32_t offset, const uint32_t count)
 {
     glDrawArrays((uint32_t)type, offset, count);
 }
 
-void GraphicsContext::DrawIndexed(const PrimitiveType& type, const uint32_t count)
+void GraphicsContext::DrawIndexed(const PrimitiveType& type, const uint32_t count, const IndexType& indexType, const uint32_t first)
+{
+    const uintptr_t offset = first * GetIndexTypeSize(indexType);
+    glDrawElements((uint32_t)type, count, (uint32_t)indexType, (void*)offset);
+}
+
+bool GraphicsContext::HasExtension(const char* name)
+{
+    const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+
+    if (extensions == nullptr) {
+        return false;
+    }
+
+    // Extension names may prefix each other, match whole space separated tokens only
+    const size_t length = strlen(name);
+
+    for (const char* match = strstr(extensions, name); match != nullptr; match = strstr(match + length, name))
+    {
+        const bool startsToken = (match == extensions || match[-1] == ' ');
+        const bool endsToken = (match[length] == ' ' || match[length] == '\0');
+
+        if (startsToken && endsToken) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool GraphicsContext::SupportsUintIndices() const
 {
-    glDrawElements((uint32_t)type, count, GL_UNSIGNED_SHORT, nullptr);
+    return bUintIndices;
 }
 
 uint32_t GraphicsContext::GetDisplayWidth() const
@@ -2,6 +2,8 @@
 #define GRAPHICS_CONTEXT_H
 
 #include "primitive_type.h"
+#include "index_type.h"
+#include "blend_mode.h"
 #include "vector.h"
 
 #include <GLES2/gl2.h>
@@ -15,8 +17,12 @@ public:
     void ClearBackBuffer(const float r, const float g, const float b, const float a);
     void EnableDepthBufferTesting();
     void DisableDepthBufferTesting();
+    void SetBlendMode(const BlendMode& mode);
     void Draw(const PrimitiveType& type, const uint32_t offset, const uint32_t count);
-    void DrawIndexed(const PrimitiveType& type, const uint32_t count);
+    void DrawIndexed(const PrimitiveType& type, const uint32_t count, const IndexType& indexType, const uint32_t first = 0);
+
+    static bool HasExtension(const char* name);
+    bool SupportsUintIndices() const;
 
     uint32_t GetDisplayWidth() const;
     uint32_t GetDisplayHeight() const;
@@ -24,6 +30,10 @@ public:
 private:
     uint32_t Width;
     uint32_t Height;
+
+    BlendMode CurrentBlendMode;
+
+    bool bUintIndices;
 };
 
 #endif // GRAPHICS_CONTEXT_H
\ No newline at end of file
@@ -1,5 +1,23 @@
 #include "index_buffer.h"
 
+#include "utils.h"
+
+template <typename T>
+inline void FillQuadIndices(T* indices, const uint32_t quadCount)
+{
+    for (uint32_t index = 0; index < quadCount; ++index)
+    {
+        const T vertex = (T)(4 * index);
+
+        indices[ 6 * index + 0 ] = vertex + 0;
+        indices[ 6 * index + 1 ] = vertex + 1;
+        indices[ 6 * index + 2 ] = vertex + 2;
+        indices[ 6 * index + 3 ] = vertex + 0;
+        indices[ 6 * index + 4 ] = vertex + 3;
+        indices[ 6 * index + 5 ] = vertex + 1;
+    }
+}
+
 void CreateIndexBuffer(IndexBuffer& buffer)
 {
     glGenBuffers(1, &buffer.Id);
@@ -18,4 +36,80 @@ void DestroyIndexBuffer(const IndexBuffer& buffer)
 void BindIndexBuffer(const IndexBuffer& buffer)
 {
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.Id);
+}
+
+void OrphanIndexBuffer(const void* data, const uint32_t size, const IndexBuffer& buffer)
+{
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.Id);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(buffer.Size * buffer.Stride), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, size, data);
+}
+
+void CreateQuadIndexBuffer(QuadIndexBuffer& buffer, const bool allowUintIndices)
+{
+    buffer.Type         = IndexType::UnsignedShort;
+    buffer.QuadCapacity = 0;
+    buffer.MaxQuads     = allowUintIndices ? g_maxUintIndexQuads : g_maxShortIndexQuads;
+
+    buffer.Buffer.Size   = 0;
+    buffer.Buffer.Stride = sizeof(uint16_t);
+    buffer.Buffer.Data   = nullptr;
+
+    // Storage is allocated lazily by the first reserve
+    glGenBuffers(1, &buffer.Buffer.Id);
+}
+
+void DestroyQuadIndexBuffer(QuadIndexBuffer& buffer)
+{
+    DestroyIndexBuffer(buffer.Buffer);
+
+    buffer.QuadCapacity = 0;
+    buffer.Buffer.Size  = 0;
+}
+
+void ReserveQuadIndexBuffer(QuadIndexBuffer& buffer, const uint32_t quadCount)
+{
+    if (quadCount <= buffer.QuadCapacity || buffer.QuadCapacity == buffer.MaxQuads) {
+        return;
+    }
+
+    // Grow geometrically so a slowly growing batch doesn't rebuild the indices every frame
+    uint32_t capacity = (buffer.QuadCapacity > 0) ? buffer.QuadCapacity * 2 : g_minQuadIndexCapacity;
+
+    if (capacity < quadCount) {
+        capacity = quadCount;
+    }
+
+    if (capacity > buffer.MaxQuads) {
+        capacity = buffer.MaxQuads;
+    }
+
+    // Stay on 16-bit indices for as long as they can address every vertex
+    if (capacity > g_maxShortIndexQuads && quadCount <= g_maxShortIndexQuads) {
+        capacity = g_maxShortIndexQuads;
+    }
+
+    const IndexType type = (capacity > g_maxShortIndexQuads) ? IndexType::UnsignedInt : IndexType::UnsignedShort;
+    const uint32_t stride = GetIndexTypeSize(type);
+    const uint32_t indexCount = 6 * capacity;
+
+    uint8_t* indices = new uint8_t[indexCount * stride];
+
+    if (type == IndexType::UnsignedInt) {
+        FillQuadIndices((uint32_t*)indices, capacity);
+    } else {
+        FillQuadIndices((uint16_t*)indices, capacity);
+    }
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.Buffer.Id);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indexCount * stride), indices, GL_STATIC_DRAW);
+
+    delete[] indices;
+
+    buffer.Type          = type;
+    buffer.QuadCapacity  = capacity;
+    buffer.Buffer.Size   = indexCount;
+    buffer.Buffer.Stride = stride;
+
+    LogDebug("QuadIndexBuffer reserved %d quads (%s indices)", capacity, (type == IndexType::UnsignedInt) ? "32-bit" : "16-bit");
 }
\ No newline at end of file
@@ -1,18 +1,38 @@
 #ifndef INDEX_BUFFER_H
 #define INDEX_BUFFER_H
 
+#include "index_type.h"
+
 #include <GLES2/gl2.h>
 #include <cstdint>
 
+// Highest quad count whose 4 * N vertices are still addressable by 16-bit indices
+constexpr const uint32_t g_maxShortIndexQuads = 16383;
+constexpr const uint32_t g_maxUintIndexQuads = 1 << 20;
+constexpr const uint32_t g_minQuadIndexCapacity = 64;
+
 typedef struct {
     uint32_t Id;
-    uint32_t Size;
+    uint32_t Size;      // Index count, the byte size is Size * Stride
     uint32_t Stride;
     void* Data;
 } IndexBuffer;
 
+typedef struct {
+    IndexBuffer Buffer;
+    IndexType Type;
+    uint32_t QuadCapacity;
+    uint32_t MaxQuads;
+} QuadIndexBuffer;
+
 void CreateIndexBuffer(IndexBuffer& buffer);
 void DestroyIndexBuffer(const IndexBuffer& buffer);
 void BindIndexBuffer(const IndexBuffer& buffer);
+void OrphanIndexBuffer(const void* data, const uint32_t size, const IndexBuffer& buffer);
+
+// Quads are laid out as 0, 1, 2, 0, 3, 1 (top-left, bottom-right, bottom-left, top-right)
+void CreateQuadIndexBuffer(QuadIndexBuffer& buffer, const bool allowUintIndices);
+void DestroyQuadIndexBuffer(QuadIndexBuffer& buffer);
+void ReserveQuadIndexBuffer(QuadIndexBuffer& buffer, const uint32_t quadCount);
 
 #endif // INDEX_BUFFER_H
\ No newline at end of file
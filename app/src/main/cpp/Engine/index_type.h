@@ -0,0 +1,17 @@
+#ifndef INDEX_TYPE_H
+#define INDEX_TYPE_H
+
+#include <cstdint>
+#include <GLES2/gl2.h>
+
+typedef enum class INDEX_TYPE : uint32_t {
+    UnsignedShort = GL_UNSIGNED_SHORT,
+    UnsignedInt   = GL_UNSIGNED_INT     // Requires OES_element_index_uint
+} IndexType;
+
+inline uint32_t GetIndexTypeSize(const IndexType& type)
+{
+    return (type == IndexType::UnsignedInt) ? sizeof(uint32_t) : sizeof(uint16_t);
+}
+
+#endif // INDEX_TYPE_H
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "kinematics.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define KINEMATICS_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define KINEMATICS_SSE2 1
+#endif
+
+void IntegrateMotion(Vec2* position, Vec2* velocity, const Vec2* acceleration, const uint32_t count, const float deltaTime)
+{
+    float* pos = &position->X;
+    float* vel = &velocity->X;
+    const float* acc = &acceleration->X;
+
+    const uint32_t floatCount = 2 * count;
+    uint32_t index = 0;
+
+#if defined(KINEMATICS_NEON)
+    const float32x4_t dt = vdupq_n_f32(deltaTime);
+
+    for (; index + 4 <= floatCount; index += 4)
+    {
+        const float32x4_t v = vmlaq_f32(vld1q_f32(vel + index), vld1q_f32(acc + index), dt);
+
+        vst1q_f32(vel + index, v);
+        vst1q_f32(pos + index, vmlaq_f32(vld1q_f32(pos + index), v, dt));
+    }
+#elif defined(KINEMATICS_SSE2)
+    const __m128 dt = _mm_set1_ps(deltaTime);
+
+    for (; index + 4 <= floatCount; index += 4)
+    {
+        const __m128 v = _mm_add_ps(_mm_loadu_ps(vel + index), _mm_mul_ps(_mm_loadu_ps(acc + index), dt));
+
+        _mm_storeu_ps(vel + index, v);
+        _mm_storeu_ps(pos + index, _mm_add_ps(_mm_loadu_ps(pos + index), _mm_mul_ps(v, dt)));
+    }
+#endif
+
+    for (; index < floatCount; ++index)
+    {
+        vel[index] += acc[index] * deltaTime;
+        pos[index] += vel[index] * deltaTime;
+    }
+}
+
+uint32_t FindOutOfBounds(const Vec2* position, const Vec2* min, const Vec2* max, const uint32_t count, uint32_t* outsideMask)
+{
+    for (uint32_t word = 0; word < GetBoundsMaskWords(count); ++word) {
+        outsideMask[word] = 0;
+    }
+
+    const float* pos = &position->X;
+    const float* lower = &min->X;
+    const float* upper = &max->X;
+
+    uint32_t outsideCount = 0;
+    uint32_t entity = 0;
+
+#if defined(KINEMATICS_NEON)
+    // Lanes are X0 Y0 X1 Y1, either axis of an entity flags it
+    const uint32_t laneBitsData[4] = { 1, 1, 2, 2 };
+    const uint32x4_t laneBits = vld1q_u32(laneBitsData);
+
+    for (; entity + 2 <= count; entity += 2)
+    {
+        const uint32_t index = 2 * entity;
+        const float32x4_t p = vld1q_f32(pos + index);
+
+        const uint32x4_t outside = vorrq_u32(vcltq_f32(p, vld1q_f32(lower + index)),
+                                             vcgtq_f32(p, vld1q_f32(upper + index)));
+
+        // Or the lane bits together, no movemask on ARMv7
+        const uint32x4_t bits = vandq_u32(outside, laneBits);
+        const uint32x2_t folded = vorr_u32(vget_low_u32(bits), vget_high_u32(bits));
+        const uint32_t pair = vget_lane_u32(folded, 0) | vget_lane_u32(folded, 1);
+
+        outsideMask[entity / 32] |= pair << (entity % 32);
+        outsideCount += (pair & 1) + (pair >> 1);
+    }
+#elif defined(KINEMATICS_SSE2)
+    for (; entity + 2 <= count; entity += 2)
+    {
+        const uint32_t index = 2 * entity;
+        const __m128 p = _mm_loadu_ps(pos + index);
+
+        const __m128 outside = _mm_or_ps(_mm_cmplt_ps(p, _mm_loadu_ps(lower + index)),
+                                         _mm_cmpgt_ps(p, _mm_loadu_ps(upper + index)));
+
+        // Lanes are X0 Y0 X1 Y1, either axis of an entity flags it
+        const uint32_t lanes = (uint32_t)_mm_movemask_ps(outside);
+        const uint32_t pair = ((lanes & 0x3) != 0) | (((lanes & 0xC) != 0) << 1);
+
+        outsideMask[entity / 32] |= pair << (entity % 32);
+        outsideCount += (pair & 1) + (pair >> 1);
+    }
+#endif
+
+    for (; entity < count; ++entity)
+    {
+        const bool isOutside = position[entity].X < min[entity].X || position[entity].X > max[entity].X ||
+                               position[entity].Y < min[entity].Y || position[entity].Y > max[entity].Y;
+
+        outsideMask[entity / 32] |= (uint32_t)isOutside << (entity % 32);
+        outsideCount += isOutside;
+    }
+
+    return outsideCount;
+}
\ No newline at end of file
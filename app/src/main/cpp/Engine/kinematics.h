@@ -0,0 +1,28 @@
+#ifndef KINEMATICS_H
+#define KINEMATICS_H
+
+#include "gfx_math.h"
+
+#include <cstdint>
+
+// Vec2 arrays are walked as flat XY float streams, two entities per SIMD register
+static_assert(sizeof(Vec2) == 2 * sizeof(float), "Vec2 must be tightly packed");
+
+typedef enum class BOUNDS_MODE {
+    None,       // Leaving the bounds is ignored
+    Wrap,       // Moved back by the wrap span on the axis it left through
+    Respawn     // Left where it is, the game repositions it when handling the event
+} BoundsMode;
+
+inline uint32_t GetBoundsMaskWords(const uint32_t count)
+{
+    return (count + 31) / 32;
+}
+
+// Semi-implicit Euler, velocity += acceleration * dt then position += velocity * dt
+void IntegrateMotion(Vec2* position, Vec2* velocity, const Vec2* acceleration, const uint32_t count, const float deltaTime);
+
+// Sets bit i of the mask when position i is outside of [min, max] on either axis, returns how many are
+uint32_t FindOutOfBounds(const Vec2* position, const Vec2* min, const Vec2* max, const uint32_t count, uint32_t* outsideMask);
+
+#endif // KINEMATICS_H
\ No newline at end of file
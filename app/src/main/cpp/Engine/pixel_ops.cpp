@@ -0,0 +1,360 @@
+#include "pixel_ops.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PIXEL_OPS_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define PIXEL_OPS_SSE2 1
+#endif
+
+// 4x4 Bayer matrix, scaled to an offset in [0, 255) by ditherOffset
+constexpr const uint8_t g_bayerMatrix[4][4] = {
+    {  0,  8,  2, 10 },
+    { 12,  4, 14,  6 },
+    {  3, 11,  1,  9 },
+    { 15,  7, 13,  5 }
+};
+
+// Exact round(value * alpha / 255) without a division
+inline uint8_t MulDiv255(const uint32_t value, const uint32_t alpha)
+{
+    const uint32_t product = value * alpha + 128;
+    return (uint8_t)((product + (product >> 8)) >> 8);
+}
+
+// Quantizes an 8-bit channel to [0, max], the offset decides the rounding point
+inline uint16_t Quantize(const uint32_t value, const uint32_t max, const uint32_t offset)
+{
+    return (uint16_t)((value * max + offset) / 255);
+}
+
+inline uint32_t DitherOffset(const uint32_t x, const uint32_t y)
+{
+    return g_bayerMatrix[y & 3][x & 3] * 16 + 8;
+}
+
+// Largest DitherOffset, quantizing with it rounds up at least as far as any dithered channel
+constexpr const uint32_t g_maxDitherOffset = 15 * 16 + 8;
+
+#if defined(PIXEL_OPS_NEON)
+
+inline uint8x8_t MulDiv255(const uint8x8_t value, const uint8x8_t alpha)
+{
+    const uint16x8_t product = vmull_u8(value, alpha);
+    return vrshrn_n_u16(vrsraq_n_u16(product, product, 8), 8);
+}
+
+#elif defined(PIXEL_OPS_SSE2)
+
+// Two RGBA pixels widened to 16-bit lanes
+inline __m128i PremultiplyWide(const __m128i pixels)
+{
+    const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    const __m128i alphaOne   = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+    const __m128i bias       = _mm_set1_epi16(128);
+
+    // Broadcast each pixel's alpha, alpha itself gets multiplied by 255 and comes out unchanged
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, 0xFF), 0xFF);
+    alpha = _mm_or_si128(_mm_andnot_si128(alphaLanes, alpha), alphaOne);
+
+    const __m128i product = _mm_add_epi16(_mm_mullo_epi16(pixels, alpha), bias);
+    return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+}
+
+#endif
+
+void PremultiplyAlpha(uint8_t* pixels, const uint32_t count)
+{
+    uint32_t index = 0;
+
+#if defined(PIXEL_OPS_NEON)
+    for (; index + 8 <= count; index += 8)
+    {
+        uint8x8x4_t rgba = vld4_u8(pixels + 4 * index);
+
+        rgba.val[0] = MulDiv255(rgba.val[0], rgba.val[3]);
+        rgba.val[1] = MulDiv255(rgba.val[1], rgba.val[3]);
+        rgba.val[2] = MulDiv255(rgba.val[2], rgba.val[3]);
+
+        vst4_u8(pixels + 4 * index, rgba);
+    }
+#elif defined(PIXEL_OPS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; index + 4 <= count; index += 4)
+    {
+        __m128i* address = (__m128i*)(pixels + 4 * index);
+        const __m128i rgba = _mm_loadu_si128(address);
+
+        const __m128i low  = PremultiplyWide(_mm_unpacklo_epi8(rgba, zero));
+        const __m128i high = PremultiplyWide(_mm_unpackhi_epi8(rgba, zero));
+
+        _mm_storeu_si128(address, _mm_packus_epi16(low, high));
+    }
+#endif
+
+    for (; index < count; ++index)
+    {
+        uint8_t* pixel = pixels + 4 * index;
+
+        pixel[0] = MulDiv255(pixel[0], pixel[3]);
+        pixel[1] = MulDiv255(pixel[1], pixel[3]);
+        pixel[2] = MulDiv255(pixel[2], pixel[3]);
+    }
+}
+
+void UnpremultiplyAlpha(uint8_t* pixels, const uint32_t count)
+{
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        uint8_t* pixel = pixels + 4 * index;
+        const uint32_t alpha = pixel[3];
+
+        if (alpha == 0 || alpha == 0xFF) {
+            continue;
+        }
+
+        for (uint32_t channel = 0; channel < 3; ++channel)
+        {
+            const uint32_t value = (pixel[channel] * 255 + alpha / 2) / alpha;
+            pixel[channel] = (uint8_t)((value > 0xFF) ? 0xFF : value);
+        }
+    }
+}
+
+bool IsGreyscale(const uint8_t* pixels, const uint32_t count)
+{
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        const uint8_t* pixel = pixels + 4 * index;
+
+        if (pixel[0] != pixel[1] || pixel[0] != pixel[2]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool IsOpaque(const uint8_t* pixels, const uint32_t count)
+{
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        if (pixels[4 * index + 3] != 0xFF) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ConvertToLuminanceAlpha(const uint8_t* pixels, uint8_t* output, const uint32_t count)
+{
+    uint32_t index = 0;
+
+#if defined(PIXEL_OPS_NEON)
+    for (; index + 8 <= count; index += 8)
+    {
+        const uint8x8x4_t rgba = vld4_u8(pixels + 4 * index);
+
+        // Rec. 601 weights summing to 256, greyscale input comes out unchanged
+        uint16x8_t luma = vmull_u8(rgba.val[0], vdup_n_u8(77));
+        luma = vmlal_u8(luma, rgba.val[1], vdup_n_u8(150));
+        luma = vmlal_u8(luma, rgba.val[2], vdup_n_u8(29));
+
+        uint8x8x2_t la;
+        la.val[0] = vrshrn_n_u16(luma, 8);
+        la.val[1] = rgba.val[3];
+
+        vst2_u8(output + 2 * index, la);
+    }
+#endif
+
+    for (; index < count; ++index)
+    {
+        const uint8_t* pixel = pixels + 4 * index;
+
+        output[2 * index + 0] = (uint8_t)((77 * pixel[0] + 150 * pixel[1] + 29 * pixel[2] + 128) >> 8);
+        output[2 * index + 1] = pixel[3];
+    }
+}
+
+void ConvertToRGB565(const uint8_t* pixels, uint16_t* output, const uint32_t width, const uint32_t height, const bool dither)
+{
+    if (!dither)
+    {
+        const uint32_t count = width * height;
+        uint32_t index = 0;
+
+#if defined(PIXEL_OPS_NEON)
+        for (; index + 8 <= count; index += 8)
+        {
+            const uint8x8x4_t rgba = vld4_u8(pixels + 4 * index);
+
+            const uint16x8_t r = vmovl_u8(MulDiv255(rgba.val[0], vdup_n_u8(31)));
+            const uint16x8_t g = vmovl_u8(MulDiv255(rgba.val[1], vdup_n_u8(63)));
+            const uint16x8_t b = vmovl_u8(MulDiv255(rgba.val[2], vdup_n_u8(31)));
+
+            vst1q_u16(output + index, vorrq_u16(vorrq_u16(vshlq_n_u16(r, 11), vshlq_n_u16(g, 5)), b));
+        }
+#endif
+
+        for (; index < count; ++index)
+        {
+            const uint8_t* pixel = pixels + 4 * index;
+            output[index] = (uint16_t)((MulDiv255(pixel[0], 31) << 11) | (MulDiv255(pixel[1], 63) << 5) | MulDiv255(pixel[2], 31));
+        }
+
+        return;
+    }
+
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            const uint32_t index = y * width + x;
+            const uint8_t* pixel = pixels + 4 * index;
+            const uint32_t offset = DitherOffset(x, y);
+
+            output[index] = (uint16_t)((Quantize(pixel[0], 31, offset) << 11) |
+                                       (Quantize(pixel[1], 63, offset) << 5) |
+                                        Quantize(pixel[2], 31, offset));
+        }
+    }
+}
+
+void ConvertToRGBA4444(const uint8_t* pixels, uint16_t* output, const uint32_t width, const uint32_t height, const bool dither)
+{
+    if (!dither)
+    {
+        const uint32_t count = width * height;
+        uint32_t index = 0;
+
+#if defined(PIXEL_OPS_NEON)
+        for (; index + 8 <= count; index += 8)
+        {
+            const uint8x8x4_t rgba = vld4_u8(pixels + 4 * index);
+
+            const uint16x8_t r = vmovl_u8(MulDiv255(rgba.val[0], vdup_n_u8(15)));
+            const uint16x8_t g = vmovl_u8(MulDiv255(rgba.val[1], vdup_n_u8(15)));
+            const uint16x8_t b = vmovl_u8(MulDiv255(rgba.val[2], vdup_n_u8(15)));
+            const uint16x8_t a = vmovl_u8(MulDiv255(rgba.val[3], vdup_n_u8(15)));
+
+            const uint16x8_t rg = vorrq_u16(vshlq_n_u16(r, 12), vshlq_n_u16(g, 8));
+            const uint16x8_t ba = vorrq_u16(vshlq_n_u16(b, 4), a);
+
+            vst1q_u16(output + index, vorrq_u16(rg, ba));
+        }
+#endif
+
+        for (; index < count; ++index)
+        {
+            const uint8_t* pixel = pixels + 4 * index;
+
+            output[index] = (uint16_t)((MulDiv255(pixel[0], 15) << 12) | (MulDiv255(pixel[1], 15) << 8) |
+                                       (MulDiv255(pixel[2], 15) << 4) | MulDiv255(pixel[3], 15));
+        }
+
+        return;
+    }
+
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            const uint32_t index = y * width + x;
+            const uint8_t* pixel = pixels + 4 * index;
+            const uint32_t offset = DitherOffset(x, y);
+
+            // Alpha isn't dithered, noisy edges would show through the blending. It still rounds up as far as
+            // the colour can, premultiplied colour rounded above its alpha would come out brighter than the source
+            output[index] = (uint16_t)((Quantize(pixel[0], 15, offset) << 12) |
+                                       (Quantize(pixel[1], 15, offset) << 8) |
+                                       (Quantize(pixel[2], 15, offset) << 4) |
+                                        Quantize(pixel[3], 15, g_maxDitherOffset));
+        }
+    }
+}
+
+// Averages the 2x2 block starting at column 2 * x of both rows
+inline void AverageBlock(const uint8_t* row0, const uint8_t* row1, const uint32_t x0, const uint32_t x1, uint8_t* output)
+{
+    for (uint32_t channel = 0; channel < 4; ++channel)
+    {
+        const uint32_t sum = row0[4 * x0 + channel] + row0[4 * x1 + channel] +
+                             row1[4 * x0 + channel] + row1[4 * x1 + channel];
+
+        output[channel] = (uint8_t)((sum + 2) >> 2);
+    }
+}
+
+void DownsampleBox(const uint8_t* pixels, const uint32_t width, const uint32_t height, uint8_t* output)
+{
+    const uint32_t outputWidth  = (width > 1) ? width / 2 : 1;
+    const uint32_t outputHeight = (height > 1) ? height / 2 : 1;
+
+    for (uint32_t y = 0; y < outputHeight; ++y)
+    {
+        // Odd edges are dropped, a single row or column is averaged with itself
+        const uint8_t* row0 = pixels + 4 * width * (2 * y);
+        const uint8_t* row1 = (height > 1) ? row0 + 4 * width : row0;
+        uint8_t* target = output + 4 * outputWidth * y;
+
+        uint32_t x = 0;
+
+        if (width > 1)
+        {
+#if defined(PIXEL_OPS_NEON)
+            for (; x + 8 <= outputWidth; x += 8)
+            {
+                const uint8x16x4_t top    = vld4q_u8(row0 + 8 * x);
+                const uint8x16x4_t bottom = vld4q_u8(row1 + 8 * x);
+
+                uint8x8x4_t result;
+
+                for (uint32_t channel = 0; channel < 4; ++channel)
+                {
+                    // Vertical sums, then neighbouring columns added pairwise
+                    const uint16x8_t low  = vaddl_u8(vget_low_u8(top.val[channel]), vget_low_u8(bottom.val[channel]));
+                    const uint16x8_t high = vaddl_u8(vget_high_u8(top.val[channel]), vget_high_u8(bottom.val[channel]));
+
+                    const uint16x4_t pairsLow  = vpadd_u16(vget_low_u16(low), vget_high_u16(low));
+                    const uint16x4_t pairsHigh = vpadd_u16(vget_low_u16(high), vget_high_u16(high));
+
+                    result.val[channel] = vrshrn_n_u16(vcombine_u16(pairsLow, pairsHigh), 2);
+                }
+
+                vst4_u8(target + 4 * x, result);
+            }
+#elif defined(PIXEL_OPS_SSE2)
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i bias = _mm_set1_epi16(2);
+
+            for (; x + 2 <= outputWidth; x += 2)
+            {
+                const __m128i top    = _mm_loadu_si128((const __m128i*)(row0 + 8 * x));
+                const __m128i bottom = _mm_loadu_si128((const __m128i*)(row1 + 8 * x));
+
+                // Pixels 0 and 1 in the low sum, 2 and 3 in the high one
+                const __m128i sumLow  = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+                const __m128i sumHigh = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+
+                const __m128i blockLow  = _mm_add_epi16(sumLow, _mm_srli_si128(sumLow, 8));
+                const __m128i blockHigh = _mm_add_epi16(sumHigh, _mm_srli_si128(sumHigh, 8));
+
+                const __m128i blocks = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(blockLow, blockHigh), bias), 2);
+                _mm_storel_epi64((__m128i*)(target + 4 * x), _mm_packus_epi16(blocks, zero));
+            }
+#endif
+
+            for (; x < outputWidth; ++x) {
+                AverageBlock(row0, row1, 2 * x, 2 * x + 1, target + 4 * x);
+            }
+        }
+
+        else {
+            AverageBlock(row0, row1, 0, 0, target);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#ifndef PIXEL_OPS_H
+#define PIXEL_OPS_H
+
+#include <cstdint>
+
+// Bulk operations over tightly packed RGBA8 pixel buffers, vectorized with NEON or SSE2 when available
+
+void PremultiplyAlpha(uint8_t* pixels, const uint32_t count);
+void UnpremultiplyAlpha(uint8_t* pixels, const uint32_t count);
+
+// Content checks used to pick a smaller texture format
+bool IsGreyscale(const uint8_t* pixels, const uint32_t count);
+bool IsOpaque(const uint8_t* pixels, const uint32_t count);
+
+// Format conversions, the 16-bit ones optionally apply a 4x4 ordered dither
+void ConvertToLuminanceAlpha(const uint8_t* pixels, uint8_t* output, const uint32_t count);
+void ConvertToRGB565(const uint8_t* pixels, uint16_t* output, const uint32_t width, const uint32_t height, const bool dither);
+void ConvertToRGBA4444(const uint8_t* pixels, uint16_t* output, const uint32_t width, const uint32_t height, const bool dither);
+
+// Mip chain helper, expects premultiplied pixels so transparent texels don't bleed their color.
+// Writes max(1, width / 2) x max(1, height / 2) pixels.
+void DownsampleBox(const uint8_t* pixels, const uint32_t width, const uint32_t height, uint8_t* output);
+
+#endif // PIXEL_OPS_H
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "qoi.h"
+
+#include <cstring>
+
+constexpr const uint8_t g_qoiOpIndex = 0x00;    // 00xxxxxx
+constexpr const uint8_t g_qoiOpDiff  = 0x40;    // 01xxxxxx
+constexpr const uint8_t g_qoiOpLuma  = 0x80;    // 10xxxxxx
+constexpr const uint8_t g_qoiOpRun   = 0xC0;    // 11xxxxxx
+constexpr const uint8_t g_qoiOpRGB   = 0xFE;
+constexpr const uint8_t g_qoiOpRGBA  = 0xFF;
+constexpr const uint8_t g_qoiOpMask  = 0xC0;
+
+// Images above this are rejected, keeps 4 * width * height inside 32 bits
+constexpr const uint32_t g_qoiMaxPixels = 400000000;
+
+inline uint32_t ReadBigEndian32(const uint8_t* data)
+{
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | (uint32_t)data[3];
+}
+
+inline uint32_t PackPixel(const uint32_t r, const uint32_t g, const uint32_t b, const uint32_t a)
+{
+    return (r & 0xFF) | ((g & 0xFF) << 8) | ((b & 0xFF) << 16) | ((a & 0xFF) << 24);
+}
+
+inline uint32_t HashPixel(const uint32_t pixel)
+{
+    const uint32_t r = pixel & 0xFF;
+    const uint32_t g = (pixel >> 8) & 0xFF;
+    const uint32_t b = (pixel >> 16) & 0xFF;
+    const uint32_t a = pixel >> 24;
+
+    return (r * 3 + g * 5 + b * 7 + a * 11) % g_qoiIndexSize;
+}
+
+bool IsQoiImage(const uint8_t* data, const uint32_t length)
+{
+    return length >= g_qoiHeaderSize && ReadBigEndian32(data) == g_qoiMagic;
+}
+
+bool CreateQoiDecoder(const uint8_t* data, const uint32_t length, QoiDecoder& decoder)
+{
+    if (!IsQoiImage(data, length) || length < g_qoiHeaderSize + g_qoiPaddingSize) {
+        return false;
+    }
+
+    decoder.Header.Width      = ReadBigEndian32(data + 4);
+    decoder.Header.Height     = ReadBigEndian32(data + 8);
+    decoder.Header.Channels   = data[12];
+    decoder.Header.ColorSpace = data[13];
+
+    const uint64_t pixelCount = (uint64_t)decoder.Header.Width * decoder.Header.Height;
+
+    if (pixelCount == 0 || pixelCount > g_qoiMaxPixels ||
+        (decoder.Header.Channels != 3 && decoder.Header.Channels != 4)) {
+        return false;
+    }
+
+    decoder.Data       = data;
+    decoder.Length     = length - g_qoiPaddingSize;     // Ops never start inside the end marker
+    decoder.Position   = g_qoiHeaderSize;
+    decoder.PixelsLeft = (uint32_t)pixelCount;
+    decoder.Run        = 0;
+    decoder.Pixel      = PackPixel(0, 0, 0, 0xFF);
+
+    memset(decoder.Index, 0, sizeof(decoder.Index));
+    return true;
+}
+
+uint32_t DecodeQoiPixels(QoiDecoder& decoder, uint8_t* output, const uint32_t count)
+{
+    const uint32_t total = (count < decoder.PixelsLeft) ? count : decoder.PixelsLeft;
+
+    // Locals so the compiler keeps the hot state in registers
+    const uint8_t* data = decoder.Data;
+    uint32_t position = decoder.Position;
+    uint32_t pixel = decoder.Pixel;
+    uint32_t run = decoder.Run;
+    uint32_t decoded = 0;
+
+    while (decoded < total)
+    {
+        if (run > 0) {
+            --run;
+        }
+
+        else if (position < decoder.Length)
+        {
+            const uint8_t op = data[position++];
+
+            if (op == g_qoiOpRGB) {
+                if (position + 3 > decoder.Length) { break; }
+                pixel = PackPixel(data[position], data[position + 1], data[position + 2], pixel >> 24);
+                position += 3;
+            }
+
+            else if (op == g_qoiOpRGBA) {
+                if (position + 4 > decoder.Length) { break; }
+                pixel = PackPixel(data[position], data[position + 1], data[position + 2], data[position + 3]);
+                position += 4;
+            }
+
+            else if ((op & g_qoiOpMask) == g_qoiOpIndex) {
+                pixel = decoder.Index[op];
+            }
+
+            else if ((op & g_qoiOpMask) == g_qoiOpDiff)
+            {
+                // 2 bit deltas biased by 2, wrapping per channel
+                const uint32_t r = (pixel & 0xFF) + ((op >> 4) & 0x03) - 2;
+                const uint32_t g = ((pixel >> 8) & 0xFF) + ((op >> 2) & 0x03) - 2;
+                const uint32_t b = ((pixel >> 16) & 0xFF) + (op & 0x03) - 2;
+
+                pixel = PackPixel(r, g, b, pixel >> 24);
+            }
+
+            else if ((op & g_qoiOpMask) == g_qoiOpLuma)
+            {
+                if (position + 1 > decoder.Length) { break; }
+
+                const uint8_t next = data[position++];
+                const uint32_t deltaG = (uint32_t)(op & 0x3F) - 32;
+
+                const uint32_t r = (pixel & 0xFF) + deltaG + ((next >> 4) & 0x0F) - 8;
+                const uint32_t g = ((pixel >> 8) & 0xFF) + deltaG;
+                const uint32_t b = ((pixel >> 16) & 0xFF) + deltaG + (next & 0x0F) - 8;
+
+                pixel = PackPixel(r, g, b, pixel >> 24);
+            }
+
+            else {
+                run = op & 0x3F;    // Stored with a bias of -1, this pixel is the first of the run
+            }
+
+            decoder.Index[HashPixel(pixel)] = pixel;
+        }
+
+        // Out of data before the last pixel
+        else {
+            break;
+        }
+
+        // Packed R first, matches the RGBA byte order on our little endian targets
+        memcpy(output + 4 * decoded, &pixel, 4);
+        ++decoded;
+    }
+
+    decoder.Position    = position;
+    decoder.Pixel       = pixel;
+    decoder.Run         = run;
+    decoder.PixelsLeft -= decoded;
+
+    return decoded;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef QOI_H
+#define QOI_H
+
+#include <cstdint>
+
+// "Quite OK Image" format, converted offline by tools/qoi_converter
+constexpr const uint32_t g_qoiMagic = 0x716F6966;    // "qoif", big endian
+constexpr const uint32_t g_qoiHeaderSize = 14;
+constexpr const uint32_t g_qoiPaddingSize = 8;       // End marker
+constexpr const uint32_t g_qoiIndexSize = 64;
+
+typedef struct {
+    uint32_t Width;
+    uint32_t Height;
+    uint8_t Channels;       // 3 or 4, the decoder always writes RGBA8
+    uint8_t ColorSpace;
+} QoiHeader;
+
+// Decoding state, pixels can be pulled in any number of chunks straight into the destination
+typedef struct {
+    const uint8_t* Data;
+    uint32_t Length;
+    uint32_t Position;
+    uint32_t PixelsLeft;
+    uint32_t Run;
+    uint32_t Pixel;                     // Packed RGBA, R in the low byte
+    uint32_t Index[g_qoiIndexSize];
+    QoiHeader Header;
+} QoiDecoder;
+
+bool IsQoiImage(const uint8_t* data, const uint32_t length);
+bool CreateQoiDecoder(const uint8_t* data, const uint32_t length, QoiDecoder& decoder);
+
+// Writes up to count RGBA8 pixels and returns how many were decoded, less than asked only at the end or on corrupt data
+uint32_t DecodeQoiPixels(QoiDecoder& decoder, uint8_t* output, const uint32_t count);
+
+#endif // QOI_H
\ No newline at end of file
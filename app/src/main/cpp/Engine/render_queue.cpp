@@ -0,0 +1,244 @@
+#include "render_queue.h"
+
+#include "utils.h"
+
+#include <cfloat>
+
+inline uint64_t MaskBits(const uint32_t value, const uint32_t bits)
+{
+    return (uint64_t)value & ((1ull << bits) - 1);
+}
+
+uint64_t MakeRenderSortKey(const uint32_t layer, const bool translucent, const uint32_t program,
+                           const uint32_t texture, const float depth)
+{
+    const float clampedDepth = (depth < 0.0f) ? 0.0f : (depth > 1.0f) ? 1.0f : depth;
+    const uint32_t maxDepth = (1u << g_renderDepthBits) - 1;
+    const uint32_t quantizedDepth = (uint32_t)(clampedDepth * (float)maxDepth);
+
+    const uint64_t state = (MaskBits(program, g_renderProgramBits) << g_renderTextureBits) | MaskBits(texture, g_renderTextureBits);
+
+    uint64_t key = MaskBits(layer, g_renderLayerBits) << 56;
+
+    if (translucent)
+    {
+        // Back to front, the furthest item gets the smallest key
+        key |= 1ull << 55;
+        key |= MaskBits(maxDepth - quantizedDepth, g_renderDepthBits) << 31;
+        key |= state << 7;
+    }
+
+    else {
+        key |= state << 31;
+        key |= MaskBits(quantizedDepth, g_renderDepthBits) << 7;
+    }
+
+    return key;
+}
+
+void CreateRenderQueue(RenderQueue& queue, const uint32_t capacity)
+{
+    queue.Capacity   = capacity;
+    queue.Count      = 0;
+    queue.Entries    = new RenderSortEntry[capacity];
+    queue.Scratch    = new RenderSortEntry[capacity];
+    queue.Sprites    = new Sprite*[capacity];
+    queue.HookCount  = 0;
+    queue.Stats      = { 0, 0, 0, 0 };
+    queue.FrameStats = { 0, 0, 0, 0 };
+
+    queue.Bounds.MinX  = new float[capacity];
+    queue.Bounds.MinY  = new float[capacity];
+    queue.Bounds.MaxX  = new float[capacity];
+    queue.Bounds.MaxY  = new float[capacity];
+    queue.VisibleMask  = new uint32_t[GetCullMaskWords(capacity)];
+
+    // Unbounded until a view is set
+    queue.View = { -FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX };
+}
+
+void DestroyRenderQueue(RenderQueue& queue)
+{
+    delete[] queue.VisibleMask;
+    delete[] queue.Bounds.MaxY;
+    delete[] queue.Bounds.MaxX;
+    delete[] queue.Bounds.MinY;
+    delete[] queue.Bounds.MinX;
+    delete[] queue.Sprites;
+    delete[] queue.Scratch;
+    delete[] queue.Entries;
+
+    queue.Sprites  = nullptr;
+    queue.Scratch  = nullptr;
+    queue.Entries  = nullptr;
+    queue.Capacity = 0;
+    queue.Count    = 0;
+}
+
+void SetRenderQueueView(RenderQueue& queue, const ScreenRect& view)
+{
+    queue.View = view;
+}
+
+void AddRenderLayerHook(RenderQueue& queue, const uint32_t layer, const RenderLayerCallback callback, void* user)
+{
+    if (queue.HookCount == g_maxRenderLayerHooks) {
+        LogError("gfxError: Out of render layer hooks :: AddRenderLayerHook()");
+        return;
+    }
+
+    uint32_t position = queue.HookCount;
+
+    while (position > 0 && queue.Hooks[position - 1].Layer > layer) {
+        queue.Hooks[position] = queue.Hooks[position - 1];
+        --position;
+    }
+
+    queue.Hooks[position] = { layer, callback, user };
+    queue.HookCount++;
+}
+
+void RemoveRenderLayerHook(RenderQueue& queue, void* user)
+{
+    uint32_t kept = 0;
+
+    for (uint32_t index = 0; index < queue.HookCount; ++index)
+    {
+        if (queue.Hooks[index].User != user) {
+            queue.Hooks[kept++] = queue.Hooks[index];
+        }
+    }
+
+    queue.HookCount = kept;
+}
+
+void RenderQueueSubmit(RenderQueue& queue, const uint64_t key, Sprite& sprite)
+{
+    if (queue.Count == queue.Capacity) {
+        LogError("gfxError: Render queue is full, the sprite is dropped :: RenderQueueSubmit()");
+        return;
+    }
+
+    queue.Entries[queue.Count] = { key, queue.Count };
+    queue.Sprites[queue.Count] = &sprite;
+
+    queue.Bounds.MinX[queue.Count] = sprite.Position.X;
+    queue.Bounds.MinY[queue.Count] = sprite.Position.Y;
+    queue.Bounds.MaxX[queue.Count] = sprite.Position.X + sprite.Size.X * sprite.Scale.X;
+    queue.Bounds.MaxY[queue.Count] = sprite.Position.Y + sprite.Size.Y * sprite.Scale.Y;
+
+    queue.Count++;
+    queue.Stats.Submitted++;
+}
+
+void SortRenderQueue(RenderQueue& queue)
+{
+    constexpr const uint32_t bucketCount = 1u << g_renderSortRadixBits;
+    constexpr const uint32_t passCount = 64 / g_renderSortRadixBits;
+
+    RenderSortEntry* source = queue.Entries;
+    RenderSortEntry* target = queue.Scratch;
+
+    for (uint32_t pass = 0; pass < passCount; ++pass)
+    {
+        const uint32_t shift = pass * g_renderSortRadixBits;
+        uint32_t histogram[bucketCount] = { 0 };
+
+        for (uint32_t index = 0; index < queue.Count; ++index) {
+            histogram[(source[index].Key >> shift) & (bucketCount - 1)]++;
+        }
+
+        // Every key shares this digit, the pass wouldn't move anything
+        if (queue.Count == 0 || histogram[(source[0].Key >> shift) & (bucketCount - 1)] == queue.Count) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+
+        for (uint32_t bucket = 0; bucket < bucketCount; ++bucket)
+        {
+            const uint32_t count = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += count;
+        }
+
+        // Scattered in input order, which is what keeps the sort stable
+        for (uint32_t index = 0; index < queue.Count; ++index)
+        {
+            const uint32_t bucket = (source[index].Key >> shift) & (bucketCount - 1);
+            target[histogram[bucket]++] = source[index];
+        }
+
+        RenderSortEntry* swap = source;
+        source = target;
+        target = swap;
+
+        queue.Stats.SortPasses++;
+    }
+
+    // The result always ends up in Entries
+    if (source != queue.Entries)
+    {
+        queue.Scratch = queue.Entries;
+        queue.Entries = source;
+    }
+}
+
+// Keeps the visible entries in submission order, so the stable sort still sees them as submitted
+inline void CullRenderQueue(RenderQueue& queue)
+{
+    const uint32_t visibleCount = CullBounds(queue.Bounds, queue.Count, queue.View, queue.VisibleMask);
+
+    queue.Stats.Culled += queue.Count - visibleCount;
+    queue.Stats.Drawn  += visibleCount;
+
+    if (visibleCount == queue.Count) {
+        return;
+    }
+
+    uint32_t kept = 0;
+
+    for (uint32_t index = 0; index < queue.Count; ++index)
+    {
+        if (queue.VisibleMask[index / 32] & (1u << (index % 32))) {
+            queue.Entries[kept++] = queue.Entries[index];
+        }
+    }
+
+    queue.Count = kept;
+}
+
+void FlushRenderQueue(RenderQueue& queue, SpriteBatch& batch, const Vec2& workResScale)
+{
+    // Entries still map 1:1 to submissions here, Item is the bounds index
+    CullRenderQueue(queue);
+    SortRenderQueue(queue);
+
+    uint32_t hook = 0;
+
+    for (uint32_t index = 0; index < queue.Count; ++index)
+    {
+        const uint32_t layer = (uint32_t)(queue.Entries[index].Key >> 56);
+
+        // Hooks of the layers below this item go in between, the batched sprites before them first
+        if (hook < queue.HookCount && queue.Hooks[hook].Layer < layer) {
+            FlushSpriteBatch(batch);
+        }
+
+        for (; hook < queue.HookCount && queue.Hooks[hook].Layer < layer; ++hook) {
+            queue.Hooks[hook].Callback(queue.Hooks[hook].User);
+        }
+
+        SpriteDraw(*queue.Sprites[queue.Entries[index].Item], batch, workResScale);
+    }
+
+    FlushSpriteBatch(batch);
+
+    for (; hook < queue.HookCount; ++hook) {
+        queue.Hooks[hook].Callback(queue.Hooks[hook].User);
+    }
+
+    queue.Count = 0;
+    queue.FrameStats = queue.Stats;
+    queue.Stats = { 0, 0, 0, 0 };
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include "culling.h"
+#include "sprite.h"
+#include "sprite_batch.h"
+
+#include <cstdint>
+
+constexpr const uint32_t g_maxRenderCommands = 4096;
+constexpr const uint32_t g_renderSortRadixBits = 8;
+constexpr const uint32_t g_maxRenderLayerHooks = 8;
+
+// Sort key layout, most significant bits first:
+//   Opaque       Layer 8 | 0 | Program 8 | Texture 16 | Depth 24 (front to back) | 7 unused
+//   Translucent  Layer 8 | 1 | Depth 24 (back to front) | Program 8 | Texture 16 | 7 unused
+// Translucent items keep their depth order over state changes so blending stays correct
+constexpr const uint32_t g_renderLayerBits = 8;
+constexpr const uint32_t g_renderProgramBits = 8;
+constexpr const uint32_t g_renderTextureBits = 16;
+constexpr const uint32_t g_renderDepthBits = 24;
+
+typedef struct {
+    uint64_t Key;
+    uint32_t Item;
+} RenderSortEntry;
+
+// Draws something the queue doesn't batch, called with the sprite batch flushed
+typedef void (*RenderLayerCallback)(void* user);
+
+typedef struct {
+    uint32_t Layer;
+    RenderLayerCallback Callback;
+    void* User;
+} RenderLayerHook;
+
+typedef struct {
+    uint32_t Submitted;
+    uint32_t Culled;        // Outside the view, never sorted nor batched
+    uint32_t Drawn;
+    uint32_t SortPasses;    // Radix passes actually run, digits shared by every key are skipped
+} RenderQueueStats;
+
+typedef struct {
+    RenderSortEntry* Entries;
+    RenderSortEntry* Scratch;
+    Sprite** Sprites;
+    BoundsSoA Bounds;           // Work resolution units, indexed like Sprites
+    uint32_t* VisibleMask;
+    ScreenRect View;
+    RenderLayerHook Hooks[g_maxRenderLayerHooks];  // Sorted by layer, registration order breaks ties
+    uint32_t HookCount;
+    uint32_t Count;
+    uint32_t Capacity;
+    RenderQueueStats Stats;
+    RenderQueueStats FrameStats;
+} RenderQueue;
+
+// Depth is normalized, 0 is the front
+uint64_t MakeRenderSortKey(const uint32_t layer, const bool translucent, const uint32_t program,
+                           const uint32_t texture, const float depth);
+
+void CreateRenderQueue(RenderQueue& queue, const uint32_t capacity = g_maxRenderCommands);
+void DestroyRenderQueue(RenderQueue& queue);
+
+// Sprites outside this rectangle are dropped at flush time
+void SetRenderQueueView(RenderQueue& queue, const ScreenRect& view);
+
+// The callback runs after the queued sprites of its layer and before the ones of the next layer
+void AddRenderLayerHook(RenderQueue& queue, const uint32_t layer, const RenderLayerCallback callback, void* user);
+void RemoveRenderLayerHook(RenderQueue& queue, void* user);
+
+// The sprite is read at flush time, it has to stay alive until then
+void RenderQueueSubmit(RenderQueue& queue, const uint64_t key, Sprite& sprite);
+
+// Stable LSD radix sort of the keys, equal keys keep their submission order
+void SortRenderQueue(RenderQueue& queue);
+
+// Culls, sorts, feeds the batch in key order and empties the queue
+void FlushRenderQueue(RenderQueue& queue, SpriteBatch& batch, const Vec2& workResScale);
+
+#endif // RENDER_QUEUE_H
\ No newline at end of file
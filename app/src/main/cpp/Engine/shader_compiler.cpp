@@ -2,23 +2,23 @@
 
 #include "utils.h"
 
-void DebugShaderCompileError(const uint32_t id)
+void DebugShaderCompileError(const uint32_t id, const Allocator& scratch)
 {
     int32_t errorStrSize = 0;
     glGetShaderiv(id, GL_INFO_LOG_LENGTH, &errorStrSize);
 
     if (errorStrSize)
     {
-        char* buffer = new char[errorStrSize];
+        char* buffer = AllocateArray<char>(scratch, (uint32_t)errorStrSize);
 
         glGetShaderInfoLog(id, errorStrSize, nullptr, buffer);
         LogError("Shader Compilation Error: %s", buffer);
 
-        delete[] buffer;
+        FreeArray(scratch, buffer);
     }
 }
 
-void CompileShader(const char* code, const ShaderType& type, Shader& object)
+void CompileShader(const char* code, const ShaderType& type, Shader& object, const Allocator& scratch)
 {
     object.Type = type;
     object.Id = glCreateShader((uint32_t)type);
@@ -35,10 +35,39 @@ void CompileShader(const char* code, const ShaderType& type, Shader& object)
 
         if (!compileStatus)
         {
-            DebugShaderCompileError(object.Id);
+            DebugShaderCompileError(object.Id, scratch);
             glDeleteShader(object.Id);
 
             object.Id = 0;
         }
     }
+}
+
+bool LinkShaderProgram(const uint32_t program, const uint32_t vertexShader, const uint32_t pixelShader,
+                       const Allocator& scratch)
+{
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, pixelShader);
+    glLinkProgram(program);
+
+    int32_t linkStatus = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+
+    if (!linkStatus)
+    {
+        int32_t errorStrSize = 0;
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &errorStrSize);
+
+        if (errorStrSize)
+        {
+            char* buffer = AllocateArray<char>(scratch, (uint32_t)errorStrSize);
+
+            glGetProgramInfoLog(program, errorStrSize, nullptr, buffer);
+            LogError("Shader Link Error: %s", buffer);
+
+            FreeArray(scratch, buffer);
+        }
+    }
+
+    return linkStatus != 0;
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef SHADER_COMPILER_H
 #define SHADER_COMPILER_H
 
+#include "allocator.h"
+
 #include <GLES2/gl2.h>
 
 typedef enum class SHADER_TYPE : uint32_t {
@@ -13,6 +15,11 @@ typedef struct {
     ShaderType Type;
 } Shader;
 
-void CompileShader(const char* code, const ShaderType& type, Shader& object);
+// The scratch allocator only holds the info log of a failed compile or link
+void CompileShader(const char* code, const ShaderType& type, Shader& object, const Allocator& scratch = g_heapAllocator);
+
+// Attaches both stages and links, false (with the info log printed) when the link fails
+bool LinkShaderProgram(const uint32_t program, const uint32_t vertexShader, const uint32_t pixelShader,
+                       const Allocator& scratch = g_heapAllocator);
 
 #endif // SHADER_COMPILER_H
\ No newline at end of file
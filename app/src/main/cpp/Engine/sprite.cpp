@@ -19,53 +19,47 @@ inline void SetupVertexData(Sprite& sprite, const Vec2& workResScale)
     float r, g, b, a;
     DwordToColorNormalized(sprite.Color, r, g, b, a);
 
-    sprite.BufferData[0] = { { posX    , posY    , 0.0f }, { r, g, b, a }, { texWidthX      , texHeightY       } };
-    sprite.BufferData[1] = { { posSizeX, posSizeY, 0.0f }, { r, g, b, a }, { texWidthOffsetX, texHeightOffsetY } };
-    sprite.BufferData[2] = { { posX    , posSizeY, 0.0f }, { r, g, b, a }, { texWidthX      , texHeightOffsetY } };
-    sprite.BufferData[3] = { { posSizeX, posY    , 0.0f }, { r, g, b, a }, { texWidthOffsetX, texHeightY       } };
-}
-
-inline void InitializeSprite(Sprite& sprite, const uint32_t program, const Vec2& workResScale)
-{
-    SetupVertexData(sprite, workResScale);
-
-    const VertexElement layout[] = {
-        VertexElement::Position,
-        VertexElement::Color,
-        VertexElement::TexCoord
-    }; const uint32_t nLayout = sizeof(layout) / sizeof(VertexElement);
-
-    sprite.VertexBuffer.Stride = sizeof(SpriteVertex);
-    sprite.VertexBuffer.Size   = sizeof(sprite.BufferData);
-    sprite.VertexBuffer.Data   = (void*)sprite.BufferData;
+    // Tight-fit polygon, vertices are normalized to the region so they map to both rects the same way
+    if (sprite.Mesh != nullptr && sprite.Mesh->Region == sprite.TexRect)
+    {
+        const SpriteMesh& mesh = *sprite.Mesh;
 
-    CreateVertexBuffer(program, layout, nLayout, sprite.VertexBuffer, true);
+        for (uint32_t index = 0; index < mesh.VertexCount; ++index)
+        {
+            const float u = mesh.Vertices[index][0];
+            const float v = mesh.Vertices[index][1];
 
-    const uint16_t indices[] = { 0, 1, 2, 0, 3, 1 };
+            sprite.BufferData[index] = { { posX + (posSizeX - posX) * u, posY + (posSizeY - posY) * v, 0.0f }, { r, g, b, a },
+                                         { texWidthX + (texWidthOffsetX - texWidthX) * u, texHeightY + (texHeightOffsetY - texHeightY) * v }, 0.0f };
+        }
 
-    sprite.IndexBuffer.Stride = sizeof(uint16_t);
-    sprite.IndexBuffer.Size   = sizeof(indices) / sizeof(uint16_t);
-    sprite.IndexBuffer.Data   = (void*)indices;
+        sprite.VertexCount = mesh.VertexCount;
+        return;
+    }
 
-    CreateIndexBuffer(sprite.IndexBuffer);
-}
+    // Texture slot is assigned by the batch
+    sprite.BufferData[0] = { { posX    , posY    , 0.0f }, { r, g, b, a }, { texWidthX      , texHeightY       }, 0.0f };
+    sprite.BufferData[1] = { { posSizeX, posSizeY, 0.0f }, { r, g, b, a }, { texWidthOffsetX, texHeightOffsetY }, 0.0f };
+    sprite.BufferData[2] = { { posX    , posSizeY, 0.0f }, { r, g, b, a }, { texWidthX      , texHeightOffsetY }, 0.0f };
+    sprite.BufferData[3] = { { posSizeX, posY    , 0.0f }, { r, g, b, a }, { texWidthOffsetX, texHeightY       }, 0.0f };
 
-inline void UpdateVertexBufferData(Sprite& sprite)
-{
-    UpdateVertexBuffer(sprite.BufferData, sizeof(sprite.BufferData), sprite.VertexBuffer);
+    sprite.VertexCount = 4;
 }
 
-void CreateSprite(Sprite& sprite, const uint32_t program, const Vec2& workResScale, Texture2D& texture, const Vec2& position)
+void CreateSprite(Sprite& sprite, const Vec2& workResScale, Texture2D& texture, const Vec2& position)
 {
     if (texture.Data != nullptr)
     {
         sprite.Texture  = &texture;
         sprite.Position = position;
         sprite.Size     = { (float)texture.Width, (float)texture.Height };
+        sprite.Scale    = { 1.0f, 1.0f };
         sprite.TexRect  = { 0.0f, 0.0f, texture.Width, texture.Height };
         sprite.Color    = 0xFFFFFFFF;
+        sprite.Mesh     = nullptr;
 
-        InitializeSprite(sprite, program, workResScale);
+        SetupVertexData(sprite, workResScale);
+        sprite.NeedBufferUpdate = false;
     } else {
         LogError("gfxError: Texture2D might not have been initialized :: CreateSprite()");
     }
@@ -73,10 +67,8 @@ void CreateSprite(Sprite& sprite, const uint32_t program, const Vec2& workResSca
 
 void DestroySprite(Sprite& sprite)
 {
-    DestroyIndexBuffer(sprite.IndexBuffer);
-    DestroyVertexBuffer(sprite.VertexBuffer);
-
     sprite.Texture  = nullptr;
+    sprite.Mesh     = nullptr;
     sprite.TexRect  = { 0.0f, 0.0f, 0, 0 };
     sprite.Position = { 0.0f, 0.0f };
     sprite.Size     = { 0.0f, 0.0f };
@@ -103,7 +95,7 @@ void SpriteSetSize(Sprite& sprite, const Vec2& size)
 
 void SpriteSetScale(Sprite& sprite, const Vec2& scale)
 {
-    if (scale != Vec2(1.0f, 1.0f))
+    if (scale != sprite.Scale)
     {
         sprite.Scale = scale;
         sprite.NeedBufferUpdate = true;
@@ -130,25 +122,33 @@ void SpriteSetTexRect(Sprite& sprite, const Rect2D& texrect)
     }
 }
 
-void SpriteDraw(Sprite& sprite, const Vec2& workResScale)
+void SpriteSetMesh(Sprite& sprite, const SpriteMesh* mesh)
+{
+    // Fewer than 3 vertices make no triangle, the batch would silently draw nothing
+    if (mesh && (mesh->VertexCount < 3 || mesh->VertexCount > g_maxMeshVertices))
+    {
+        LogError("gfxError: Sprite mesh has %u vertices, keeping the quad :: SpriteSetMesh()", mesh->VertexCount);
+        mesh = nullptr;
+    }
+
+    if (mesh != sprite.Mesh)
+    {
+        sprite.Mesh = mesh;
+        sprite.NeedBufferUpdate = true;
+    }
+}
+
+void SpriteDraw(Sprite& sprite, SpriteBatch& batch, const Vec2& workResScale)
 {
     if (sprite.NeedBufferUpdate)
     {
         SetupVertexData(sprite, workResScale);
-        UpdateVertexBufferData(sprite);
-
         sprite.NeedBufferUpdate = false;
     }
 
-    glBindTexture(GL_TEXTURE_2D, sprite.Texture->Id);
-
-    BindVertexBuffer(sprite.VertexBuffer);
-    BindIndexBuffer(sprite.IndexBuffer);
-
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-    glBindTexture(GL_TEXTURE_2D, 0);
+    if (sprite.VertexCount == 4) {
+        SpriteBatchDraw(batch, *sprite.Texture, sprite.BufferData);
+    } else {
+        SpriteBatchDrawMesh(batch, *sprite.Texture, sprite.BufferData, sprite.VertexCount);
+    }
 }
\ No newline at end of file
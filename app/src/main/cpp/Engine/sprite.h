@@ -2,17 +2,11 @@
 #define SPRITE_H
 
 #include "utils.h"
-#include "vertex_buffer.h"
-#include "index_buffer.h"
+#include "sprite_batch.h"
+#include "sprite_mesh.h"
 #include "texture2d.h"
 #include "gfx_math.h"
 
-typedef struct {
-    float Position[3];
-    float Color[4];
-    float TexCoord[2];
-} SpriteVertex;
-
 typedef struct {
     Vec2 Position;
     Vec2 Size;
@@ -20,19 +14,20 @@ typedef struct {
     Rect2D TexRect;
     uint32_t Color;
     Texture2D* Texture;
-    VertexBuffer VertexBuffer;
-    IndexBuffer IndexBuffer;
-    SpriteVertex BufferData[4];
+    const SpriteMesh* Mesh;         // Used instead of the quad while its region matches TexRect, needs 3 to g_maxMeshVertices vertices
+    SpriteVertex BufferData[g_maxMeshVertices];
+    uint32_t VertexCount;
     bool NeedBufferUpdate = true;
 } Sprite;
 
-void CreateSprite(Sprite& sprite, const uint32_t program, const Vec2& workResScale, Texture2D& texture, const Vec2& position = { 0.0f, 0.0f });
+void CreateSprite(Sprite& sprite, const Vec2& workResScale, Texture2D& texture, const Vec2& position = { 0.0f, 0.0f });
 void DestroySprite(Sprite& sprite);
 void SpriteSetPosition(Sprite& sprite, const Vec2& position);
 void SpriteSetSize(Sprite& sprite, const Vec2& size);
 void SpriteSetScale(Sprite& sprite, const Vec2& scale);
 void SpriteSetColor(Sprite& sprite, const uint32_t color);
 void SpriteSetTexRect(Sprite& sprite, const Rect2D& texrect);
-void SpriteDraw(Sprite& sprite, const Vec2& workResScale);
+void SpriteSetMesh(Sprite& sprite, const SpriteMesh* mesh);
+void SpriteDraw(Sprite& sprite, SpriteBatch& batch, const Vec2& workResScale);
 
 #endif // SPRITE_H
\ No newline at end of file
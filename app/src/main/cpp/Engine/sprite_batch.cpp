@@ -0,0 +1,236 @@
+#include "sprite_batch.h"
+
+#include "utils.h"
+
+#include <cstring>
+
+void CreateSpriteBatch(SpriteBatch& batch, const uint32_t program, QuadIndexBuffer& indexBuffer, const uint32_t capacity)
+{
+    // Polygon indices are always 16-bit
+    batch.Capacity = [&]() {
+        const uint32_t maxQuads = (indexBuffer.MaxQuads < g_maxShortIndexQuads) ? indexBuffer.MaxQuads : g_maxShortIndexQuads;
+        return (capacity > maxQuads) ? maxQuads : capacity;
+    }();
+
+    batch.VertexCount = 0;
+    batch.IndexCount  = 0;
+    batch.HasMeshes   = false;
+    batch.QuadIndices = &indexBuffer;
+    batch.Placeholder = nullptr;
+    batch.Stats       = { 0, 0, 0 };
+    batch.FrameStats  = { 0, 0, 0 };
+
+    batch.TextureCount = 0;
+    batch.MaxTextures  = [&]() {
+        int32_t units = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &units);
+
+        if (units < 1) {
+            return 1u;
+        } return ((uint32_t)units > g_maxBatchTextures) ? g_maxBatchTextures : (uint32_t)units;
+    }();
+
+    LogDebug("SpriteBatch texture units -> %d", batch.MaxTextures);
+
+    batch.Vertices = new SpriteVertex[4 * batch.Capacity];
+    batch.Indices  = new uint16_t[6 * batch.Capacity];
+
+    const VertexElement layout[] = {
+        VertexElement::Position,
+        VertexElement::Color,
+        VertexElement::TexCoord,
+        VertexElement::TexIndex
+    }; const uint32_t nLayout = sizeof(layout) / sizeof(VertexElement);
+
+    batch.Buffer.Stride = sizeof(SpriteVertex);
+    batch.Buffer.Size   = 4 * batch.Capacity * sizeof(SpriteVertex);
+    batch.Buffer.Data   = nullptr;
+
+    CreateVertexBuffer(program, layout, nLayout, batch.Buffer, true);
+
+    batch.TexturesLocation = batch.Buffer.HasLocations ? glGetUniformLocation(program, "Textures") : -1;
+
+    batch.MeshIndexBuffer.Stride = sizeof(uint16_t);
+    batch.MeshIndexBuffer.Size   = 6 * batch.Capacity;
+    batch.MeshIndexBuffer.Data   = nullptr;
+
+    CreateIndexBuffer(batch.MeshIndexBuffer);
+
+    ReserveQuadIndexBuffer(indexBuffer, batch.Capacity);
+}
+
+void DestroySpriteBatch(SpriteBatch& batch)
+{
+    DestroyIndexBuffer(batch.MeshIndexBuffer);
+    DestroyVertexBuffer(batch.Buffer);
+
+    delete[] batch.Indices;
+    delete[] batch.Vertices;
+
+    batch.Indices      = nullptr;
+    batch.Vertices     = nullptr;
+    batch.Capacity     = 0;
+    batch.VertexCount  = 0;
+    batch.IndexCount   = 0;
+    batch.TextureCount = 0;
+}
+
+inline uint32_t FindTextureSlot(const SpriteBatch& batch, const Texture2D& texture)
+{
+    for (uint32_t slot = 0; slot < batch.TextureCount; ++slot)
+    {
+        if (batch.Textures[slot] == &texture) {
+            return slot;
+        }
+    }
+
+    return batch.TextureCount;
+}
+
+// Makes room for the primitive and returns the texture slot its vertices have to sample
+inline uint32_t PrepareBatch(SpriteBatch& batch, const Texture2D& source, const uint32_t vertexCount, const uint32_t indexCount)
+{
+    // Textures still streaming in are drawn with the placeholder, same UVs since it is a single color
+    const Texture2D& texture = (source.IsReady || !batch.Placeholder) ? source : *batch.Placeholder;
+
+    if (batch.VertexCount + vertexCount > 4 * batch.Capacity || batch.IndexCount + indexCount > 6 * batch.Capacity) {
+        FlushSpriteBatch(batch);
+    }
+
+    uint32_t slot = FindTextureSlot(batch, texture);
+
+    // Every texture unit is taken by another texture
+    if (slot == batch.MaxTextures) {
+        FlushSpriteBatch(batch);
+        slot = 0;
+    }
+
+    if (slot == batch.TextureCount) {
+        batch.Textures[batch.TextureCount++] = &texture;
+    }
+
+    return slot;
+}
+
+inline void AppendVertices(SpriteBatch& batch, const SpriteVertex* source, const uint32_t count, const uint32_t slot)
+{
+    SpriteVertex* vertices = &batch.Vertices[batch.VertexCount];
+    memcpy(vertices, source, count * sizeof(SpriteVertex));
+
+    for (uint32_t index = 0; index < count; ++index) {
+        vertices[index].TexIndex = (float)slot;
+    }
+
+    batch.VertexCount += count;
+    batch.Stats.Sprites++;
+}
+
+void SpriteBatchDraw(SpriteBatch& batch, const Texture2D& texture, const SpriteVertex* quad)
+{
+    const uint32_t slot = PrepareBatch(batch, texture, 4, 6);
+
+    const uint16_t base = (uint16_t)batch.VertexCount;
+    uint16_t* indices = &batch.Indices[batch.IndexCount];
+
+    // Same pattern as the shared quad index buffer, only uploaded when polygons are mixed in
+    indices[0] = base + 0;
+    indices[1] = base + 1;
+    indices[2] = base + 2;
+    indices[3] = base + 0;
+    indices[4] = base + 3;
+    indices[5] = base + 1;
+
+    batch.IndexCount += 6;
+
+    AppendVertices(batch, quad, 4, slot);
+}
+
+void SpriteBatchDrawMesh(SpriteBatch& batch, const Texture2D& texture, const SpriteVertex* vertices, const uint32_t count)
+{
+    if (count < 3 || count > 4 * batch.Capacity) {
+        return;
+    }
+
+    const uint32_t slot = PrepareBatch(batch, texture, count, 3 * (count - 2));
+
+    const uint16_t base = (uint16_t)batch.VertexCount;
+    uint16_t* indices = &batch.Indices[batch.IndexCount];
+
+    for (uint32_t index = 1; index + 1 < count; ++index)
+    {
+        *indices++ = base;
+        *indices++ = base + index;
+        *indices++ = base + index + 1;
+    }
+
+    batch.IndexCount += 3 * (count - 2);
+    batch.HasMeshes = true;
+
+    AppendVertices(batch, vertices, count, slot);
+}
+
+void FlushSpriteBatch(SpriteBatch& batch)
+{
+    if (batch.IndexCount == 0) {
+        return;
+    }
+
+    // Fresh storage on every flush, the GPU may still be reading the previous batch
+    OrphanVertexBuffer(batch.Vertices, batch.VertexCount * sizeof(SpriteVertex), batch.Buffer);
+
+    for (uint32_t slot = 0; slot < batch.TextureCount; ++slot)
+    {
+        glActiveTexture(GL_TEXTURE0 + slot);
+        glBindTexture(GL_TEXTURE_2D, batch.Textures[slot]->Id);
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+
+    // The program may be linked after the batch was created, look the locations up on the first flush after that
+    if (!batch.Buffer.HasLocations)
+    {
+        ResolveVertexBufferLocations(batch.Buffer);
+
+        if (batch.Buffer.HasLocations) {
+            batch.TexturesLocation = glGetUniformLocation(batch.Buffer.Program, "Textures");
+        }
+    }
+
+    // Sampler i reads texture unit i
+    if (batch.TexturesLocation >= 0) {
+        const int32_t units[g_maxBatchTextures] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+        glUniform1iv(batch.TexturesLocation, batch.MaxTextures, units);
+    }
+
+    BindVertexBufferAttribs(batch.Buffer);
+
+    if (batch.HasMeshes)
+    {
+        OrphanIndexBuffer(batch.Indices, batch.IndexCount * sizeof(uint16_t), batch.MeshIndexBuffer);
+        BindIndexBuffer(batch.MeshIndexBuffer);
+
+        glDrawElements(GL_TRIANGLES, batch.IndexCount, GL_UNSIGNED_SHORT, nullptr);
+    }
+
+    else
+    {
+        BindIndexBuffer(batch.QuadIndices->Buffer);
+        glDrawElements(GL_TRIANGLES, batch.IndexCount, (uint32_t)batch.QuadIndices->Type, nullptr);
+    }
+
+    batch.Stats.DrawCalls++;
+    batch.Stats.TextureBinds += batch.TextureCount;
+
+    batch.VertexCount  = 0;
+    batch.IndexCount   = 0;
+    batch.HasMeshes    = false;
+    batch.TextureCount = 0;
+}
+
+void EndSpriteBatch(SpriteBatch& batch)
+{
+    FlushSpriteBatch(batch);
+
+    batch.FrameStats = batch.Stats;
+    batch.Stats = { 0, 0, 0 };
+}
\ No newline at end of file
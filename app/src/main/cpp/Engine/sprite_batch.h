@@ -0,0 +1,59 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include "vertex_buffer.h"
+#include "index_buffer.h"
+#include "texture2d.h"
+
+#include <cstdint>
+
+constexpr const uint32_t g_maxBatchQuads = 1024;
+constexpr const uint32_t g_maxBatchTextures = 8;    // Must match the sampler array of the pixel shader
+
+typedef struct {
+    float Position[3];
+    float Color[4];
+    float TexCoord[2];
+    float TexIndex;
+} SpriteVertex;
+
+typedef struct {
+    uint32_t DrawCalls;
+    uint32_t Sprites;
+    uint32_t TextureBinds;
+} SpriteBatchStats;
+
+typedef struct {
+    VertexBuffer Buffer;
+    IndexBuffer MeshIndexBuffer;
+    SpriteVertex* Vertices;
+    uint16_t* Indices;
+    uint32_t VertexCount;
+    uint32_t IndexCount;
+    uint32_t Capacity;              // In quads, 4 vertices and 6 indices each
+    bool HasMeshes;
+    const Texture2D* Textures[g_maxBatchTextures];
+    uint32_t TextureCount;
+    uint32_t MaxTextures;
+    QuadIndexBuffer* QuadIndices;
+    int32_t TexturesLocation;       // Sampler array uniform, looked up along with the attribute locations
+    const Texture2D* Placeholder;   // Drawn instead of textures that aren't ready, optional
+    SpriteBatchStats Stats;
+    SpriteBatchStats FrameStats;
+} SpriteBatch;
+
+void CreateSpriteBatch(SpriteBatch& batch, const uint32_t program, QuadIndexBuffer& indexBuffer, const uint32_t capacity = g_maxBatchQuads);
+void DestroySpriteBatch(SpriteBatch& batch);
+
+// Queues 4 vertices, the batch is flushed first when it is full or runs out of texture units
+void SpriteBatchDraw(SpriteBatch& batch, const Texture2D& texture, const SpriteVertex* quad);
+
+// Queues a convex polygon drawn as a triangle fan, batches holding polygons upload their own indices
+void SpriteBatchDrawMesh(SpriteBatch& batch, const Texture2D& texture, const SpriteVertex* vertices, const uint32_t count);
+
+void FlushSpriteBatch(SpriteBatch& batch);
+
+// Flushes whatever is left and publishes the frame stats
+void EndSpriteBatch(SpriteBatch& batch);
+
+#endif // SPRITE_BATCH_H
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "sprite_mesh.h"
+
+#include "utils.h"
+
+void CreateSpriteMeshAtlas(Asset& asset, SpriteMeshAtlas& atlas)
+{
+    atlas.Meshes    = nullptr;
+    atlas.MeshCount = 0;
+
+    uint32_t header[3] = { 0, 0, 0 };   // Magic, version, mesh count
+
+    if (asset.GetLength() < sizeof(header)) {
+        LogError("gfxError: Sprite mesh file is too small :: CreateSpriteMeshAtlas()");
+        return;
+    }
+
+    asset.Read((char*)header, sizeof(header));
+
+    if (header[0] != g_spriteMeshMagic || header[1] != g_spriteMeshVersion) {
+        LogError("gfxError: Unknown sprite mesh file format :: CreateSpriteMeshAtlas()");
+        return;
+    }
+
+    // 64-bit so a huge count in a corrupt header can't wrap around and pass
+    const uint64_t recordsSize = (uint64_t)header[2] * sizeof(SpriteMesh);
+
+    if (asset.GetLength() - sizeof(header) < recordsSize) {
+        LogError("gfxError: Truncated sprite mesh file :: CreateSpriteMeshAtlas()");
+        return;
+    }
+
+    atlas.MeshCount = header[2];
+    atlas.Meshes    = new SpriteMesh[atlas.MeshCount];
+
+    asset.Read((char*)atlas.Meshes, atlas.MeshCount * sizeof(SpriteMesh));
+
+    for (uint32_t index = 0; index < atlas.MeshCount; ++index)
+    {
+        if (atlas.Meshes[index].VertexCount > g_maxMeshVertices) {
+            atlas.Meshes[index].VertexCount = 0;    // Never matched, the sprite falls back to its quad
+        }
+    }
+}
+
+void DestroySpriteMeshAtlas(SpriteMeshAtlas& atlas)
+{
+    delete[] atlas.Meshes;
+
+    atlas.Meshes    = nullptr;
+    atlas.MeshCount = 0;
+}
+
+const SpriteMesh* FindSpriteMesh(const SpriteMeshAtlas& atlas, const Rect2D& region)
+{
+    for (uint32_t index = 0; index < atlas.MeshCount; ++index)
+    {
+        const SpriteMesh& mesh = atlas.Meshes[index];
+
+        if (mesh.Region == region && mesh.VertexCount >= 3) {
+            return &mesh;
+        }
+    }
+
+    return nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef SPRITE_MESH_H
+#define SPRITE_MESH_H
+
+#include "asset.h"
+#include "gfx_math.h"
+
+#include <cstdint>
+
+// Generated offline by tools/sprite_mesher, keep the record layout in sync with it
+constexpr const uint32_t g_spriteMeshMagic = 0x48534D53;    // "SMSH"
+constexpr const uint32_t g_spriteMeshVersion = 1;
+constexpr const uint32_t g_maxMeshVertices = 8;
+
+typedef struct {
+    Rect2D Region;
+    uint32_t VertexCount;
+    float Vertices[g_maxMeshVertices][2];   // Convex polygon, normalized to the region
+} SpriteMesh;
+
+typedef struct {
+    SpriteMesh* Meshes;
+    uint32_t MeshCount;
+} SpriteMeshAtlas;
+
+void CreateSpriteMeshAtlas(Asset& asset, SpriteMeshAtlas& atlas);
+void DestroySpriteMeshAtlas(SpriteMeshAtlas& atlas);
+const SpriteMesh* FindSpriteMesh(const SpriteMeshAtlas& atlas, const Rect2D& region);
+
+#endif // SPRITE_MESH_H
\ No newline at end of file
@@ -1,36 +1,323 @@
 #include "texture2d.h"
 
+#include "graphics_context.h"
+#include "pixel_ops.h"
+#include "qoi.h"
+#include "texture_upload.h"
+#include "utils.h"
+
+#include <cstdlib>
+#include <cstring>
+
 #define STB_IMAGE_STATIC
 #include "stb_image/stb_image.h"
 
-void CreateTexture2D(Asset& asset, Texture2D& texture, const bool filtered, const bool repeat)
+inline TextureFormat SelectTextureFormat(const Texture2D& texture, const uint32_t flags)
+{
+    if (flags & TextureImportLuminanceAlpha) {
+        return TextureFormat::LuminanceAlpha;
+    }
+
+    if (flags & TextureImportRGB565) {
+        return TextureFormat::RGB565;
+    }
+
+    if (flags & TextureImportRGBA4444) {
+        return TextureFormat::RGBA4444;
+    }
+
+    if (flags & TextureImportAutoFormat)
+    {
+        const uint32_t count = texture.Width * texture.Height;
+
+        if (IsGreyscale(texture.Data, count)) {
+            return TextureFormat::LuminanceAlpha;
+        }
+
+        if (IsOpaque(texture.Data, count)) {
+            return TextureFormat::RGB565;
+        }
+    }
+
+    return TextureFormat::RGBA8;
+}
+
+// Converts the RGBA8 pixels to the texel layout of the format, the caller frees the result with the same allocator
+inline uint8_t* ConvertTextureLevel(const TextureFormat& format, const uint32_t width, const uint32_t height,
+                                    const uint8_t* pixels, const bool dither, const Allocator& allocator)
+{
+    const uint32_t count = width * height;
+    uint8_t* converted = AllocateArray<uint8_t>(allocator, GetTextureFormatSize(format) * count);
+
+    switch (format)
+    {
+    case TextureFormat::RGBA8:
+        memcpy(converted, pixels, 4 * count);
+        break;
+
+    case TextureFormat::LuminanceAlpha:
+        ConvertToLuminanceAlpha(pixels, converted, count);
+        break;
+
+    case TextureFormat::RGB565:
+        ConvertToRGB565(pixels, (uint16_t*)converted, width, height, dither);
+        break;
+
+    case TextureFormat::RGBA4444:
+        ConvertToRGBA4444(pixels, (uint16_t*)converted, width, height, dither);
+        break;
+    }
+
+    return converted;
+}
+
+// Converts the RGBA8 pixels to the texture format and uploads them as the given level
+inline void UploadTextureLevel(const TextureFormat& format, const uint32_t level, const uint32_t width,
+                               const uint32_t height, const uint8_t* pixels, const bool dither, const Allocator& scratch)
+{
+    const TextureFormatGL formatGL = GetTextureFormatGL(format);
+
+    // RGBA8 is already in its final layout
+    if (format == TextureFormat::RGBA8) {
+        glTexImage2D(GL_TEXTURE_2D, level, formatGL.Format, width, height, 0, formatGL.Format, formatGL.Type, pixels);
+        return;
+    }
+
+    uint8_t* converted = ConvertTextureLevel(format, width, height, pixels, dither, scratch);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, formatGL.Alignment);
+    glTexImage2D(GL_TEXTURE_2D, level, formatGL.Format, width, height, 0, formatGL.Format, formatGL.Type, converted);
+
+    // Back to the GL default
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    FreeArray(scratch, converted);
+}
+
+// Uploads right away, or only allocates the storage and leaves the texels to the queue
+inline void SubmitTextureLevel(Texture2D& texture, const uint32_t level, const uint32_t width, const uint32_t height,
+                               const uint8_t* pixels, const bool dither, TextureUploadQueue* queue, const Allocator& scratch)
 {
+    if (!queue) {
+        UploadTextureLevel(texture.Format, level, width, height, pixels, dither, scratch);
+        return;
+    }
+
+    const TextureFormatGL formatGL = GetTextureFormatGL(texture.Format);
+    glTexImage2D(GL_TEXTURE_2D, level, formatGL.Format, width, height, 0, formatGL.Format, formatGL.Type, nullptr);
+
+    // Queued texels live across frames and are released by the queue
+    QueueTextureUpload(*queue, texture, level, width, height,
+                       ConvertTextureLevel(texture.Format, width, height, pixels, dither, g_heapAllocator));
+}
+
+inline bool IsPowerOfTwo(const uint32_t value)
+{
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+// Builds the chain from the decoded pixels and uploads every level down to 1x1
+inline void UploadTextureMipChain(Texture2D& texture, const bool dither, TextureUploadQueue* queue, const Allocator& scratch)
+{
+    const bool isPremultiplied = (texture.Flags & TextureImportPremultiplyAlpha) != 0;
+
+    uint32_t width  = texture.Width;
+    uint32_t height = texture.Height;
+
+    // Filtering runs on premultiplied pixels, otherwise transparent texels bleed their color into the edges
+    uint8_t* level = AllocateArray<uint8_t>(scratch, 4 * width * height);
+    memcpy(level, texture.Data, 4 * width * height);
+
+    if (!isPremultiplied) {
+        PremultiplyAlpha(level, width * height);
+    }
+
+    uint8_t* straight = isPremultiplied ? nullptr : AllocateArray<uint8_t>(scratch, 4 * width * height);
+    uint32_t index = 0;
+
+    for (;; ++index)
+    {
+        if (isPremultiplied) {
+            SubmitTextureLevel(texture, index, width, height, level, dither, queue, scratch);
+        }
+
+        else {
+            memcpy(straight, level, 4 * width * height);
+            UnpremultiplyAlpha(straight, width * height);
+
+            SubmitTextureLevel(texture, index, width, height, straight, dither, queue, scratch);
+        }
+
+        if (width == 1 && height == 1) {
+            break;
+        }
+
+        uint8_t* next = AllocateArray<uint8_t>(scratch, 4 * ((width > 1) ? width / 2 : 1) * ((height > 1) ? height / 2 : 1));
+        DownsampleBox(level, width, height, next);
+
+        FreeArray(scratch, level);
+        level = next;
+
+        width  = (width > 1) ? width / 2 : 1;
+        height = (height > 1) ? height / 2 : 1;
+    }
+
+    texture.Levels = index + 1;
+
+    FreeArray(scratch, straight);
+    FreeArray(scratch, level);
+}
+
+// Allocates width x height RGBA8 pixels with malloc, null when the size doesn't fit in 32 bits or we are out of memory
+inline uint8_t* AllocateTexturePixels(const uint32_t width, const uint32_t height, const char* caller)
+{
+    const uint64_t size = 4ull * width * height;
+
+    if (size > UINT32_MAX) {
+        LogError("gfxError: Texture of %ux%u pixels is too large :: %s()", width, height, caller);
+        return nullptr;
+    }
+
+    uint8_t* pixels = (uint8_t*)malloc((size_t)size);
+
+    if (!pixels) {
+        LogError("gfxError: Out of memory allocating %ux%u pixels :: %s()", width, height, caller);
+    } return pixels;
+}
+
+// Both decoders hand back malloc'd memory, so Data has a single release path in DestroyTexture2D
+inline uint8_t* DecodeTexturePixels(const uint8_t* buffer, const uint32_t length, Texture2D& texture)
+{
+    if (IsQoiImage(buffer, length))
+    {
+        QoiDecoder decoder;
+
+        if (!CreateQoiDecoder(buffer, length, decoder)) {
+            LogError("gfxError: Invalid QOI header :: CreateTexture2D()");
+            return nullptr;
+        }
+
+        uint8_t* pixels = AllocateTexturePixels(decoder.Header.Width, decoder.Header.Height, "CreateTexture2D");
+
+        if (!pixels) {
+            return nullptr;
+        }
+
+        const uint32_t count = decoder.Header.Width * decoder.Header.Height;
+
+        if (DecodeQoiPixels(decoder, pixels, count) != count) {
+            LogError("gfxError: Truncated QOI image :: CreateTexture2D()");
+            free(pixels);
+            return nullptr;
+        }
+
+        texture.Width  = decoder.Header.Width;
+        texture.Height = decoder.Header.Height;
+
+        return pixels;
+    }
+
+    return stbi_load_from_memory(buffer, length, (int32_t*)&texture.Width, (int32_t*)&texture.Height, nullptr, 4);
+}
+
+// Shared tail of both constructors, Data, Width and Height must already be set
+inline void InitTexture2D(Texture2D& texture, const bool filtered, const bool repeat, const uint32_t flags,
+                          TextureUploadQueue* queue, const Allocator& scratch)
+{
+    texture.Flags = flags;
+
+    if (!texture.Data) {
+        texture.Width  = 0;
+        texture.Height = 0;
+    }
+
     glGenTextures(1, &texture.Id);
     glBindTexture(GL_TEXTURE_2D, texture.Id);
 
-    const uint32_t length = asset.GetLength();
-    uint8_t* buffer = new uint8_t[length];
+    if (flags & TextureImportPremultiplyAlpha) {
+        PremultiplyAlpha(texture.Data, texture.Width * texture.Height);
+    }
 
-    asset.Read((char*)buffer, length);
-    texture.Data = stbi_load_from_memory(buffer, length, (int32_t*)&texture.Width,
-                                        (int32_t*)&texture.Height, nullptr, 4);
+    texture.Format = SelectTextureFormat(texture, flags);
+    LogDebug("Texture2D %dx%d, format %d", texture.Width, texture.Height, (int32_t)texture.Format);
+
+    const bool dither = (flags & TextureImportDither) != 0;
+
+    // Empty textures have nothing worth streaming
+    TextureUploadQueue* uploadQueue = ((flags & TextureImportStreamed) && texture.Data) ? queue : nullptr;
+    texture.IsReady = (uploadQueue == nullptr);
+
+    // Plain GLES2 only allows mipmapped textures with power of two sizes, resampling would blur atlas regions together
+    const bool canMipmap = (IsPowerOfTwo(texture.Width) && IsPowerOfTwo(texture.Height)) ||
+                           GraphicsContext::HasExtension("GL_OES_texture_npot");
+
+    const bool wantsMipmaps = (flags & TextureImportMipmaps) && texture.Data;
 
-    delete[] buffer;
+    if (wantsMipmaps && !canMipmap) {
+        LogDebug("Texture2D %dx%d isn't a power of two, mipmaps skipped", texture.Width, texture.Height);
+    }
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texture.Width, texture.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, texture.Data);
+    if (wantsMipmaps && canMipmap) {
+        UploadTextureMipChain(texture, dither, uploadQueue, scratch);
+    }
+
+    else {
+        texture.Levels = 1;
+
+        SubmitTextureLevel(texture, 0, texture.Width, texture.Height, texture.Data, dither, uploadQueue, scratch);
+    }
 
     const int32_t filter = filtered ? GL_LINEAR : GL_NEAREST;
     const int32_t wrap = repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE;
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    const int32_t minFilter = [&]() {
+        if (texture.Levels == 1) {
+            return filter;
+        } return filtered ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST;
+    }();
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
 
-
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
+void CreateTexture2D(Asset& asset, Texture2D& texture, const bool filtered, const bool repeat,
+                     const uint32_t flags, TextureUploadQueue* queue, const Allocator& scratch)
+{
+    const uint32_t length = asset.GetLength();
+    uint8_t* buffer = AllocateArray<uint8_t>(scratch, length);
+
+    asset.Read((char*)buffer, length);
+
+    texture.Width  = 0;
+    texture.Height = 0;
+    texture.Data   = DecodeTexturePixels(buffer, length, texture);
+
+    FreeArray(scratch, buffer);
+
+    InitTexture2D(texture, filtered, repeat, flags, queue, scratch);
+}
+
+void CreateTexture2DFromPixels(const uint8_t* pixels, const uint32_t width, const uint32_t height, Texture2D& texture,
+                               const bool filtered, const bool repeat, const uint32_t flags, TextureUploadQueue* queue,
+                               const Allocator& scratch)
+{
+    texture.Width  = width;
+    texture.Height = height;
+
+    // Same allocator as the decoders, DestroyTexture2D releases both the same way
+    texture.Data = AllocateTexturePixels(width, height, "CreateTexture2DFromPixels");
+
+    if (texture.Data) {
+        memcpy(texture.Data, pixels, 4 * width * height);
+    }
+
+    InitTexture2D(texture, filtered, repeat, flags, queue, scratch);
+}
+
 void DestroyTexture2D(Texture2D& texture)
 {
     stbi_image_free(texture.Data);
@@ -38,9 +325,48 @@ void DestroyTexture2D(Texture2D& texture)
 
     texture.Width  = 0;
     texture.Height = 0;
+    texture.Levels = 0;
+    texture.IsReady = false;
 }
 
 void BindTexture2D(const Texture2D& texture)
 {
     glBindTexture(GL_TEXTURE_2D, texture.Id);
+}
+
+uint32_t GetTextureFormatSize(const TextureFormat& format)
+{
+    return (format == TextureFormat::RGBA8) ? 4 : 2;
+}
+
+TextureFormatGL GetTextureFormatGL(const TextureFormat& format)
+{
+    switch (format)
+    {
+    case TextureFormat::LuminanceAlpha:
+        return { GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, 2 };
+    case TextureFormat::RGB565:
+        return { GL_RGB, GL_UNSIGNED_SHORT_5_6_5, 2 };
+    case TextureFormat::RGBA4444:
+        return { GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, 2 };
+    case TextureFormat::RGBA8:
+        break;
+    } return { GL_RGBA, GL_UNSIGNED_BYTE, 4 };
+}
+
+uint32_t GetTexture2DMemorySize(const Texture2D& texture)
+{
+    uint32_t width  = texture.Width;
+    uint32_t height = texture.Height;
+    uint32_t size = 0;
+
+    for (uint32_t level = 0; level < texture.Levels; ++level)
+    {
+        size += width * height * GetTextureFormatSize(texture.Format);
+
+        width  = (width > 1) ? width / 2 : 1;
+        height = (height > 1) ? height / 2 : 1;
+    }
+
+    return size;
 }
\ No newline at end of file
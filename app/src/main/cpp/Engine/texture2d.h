@@ -1,20 +1,64 @@
 #ifndef TEXTURE2D_H
 #define TEXTURE2D_H
 
+#include "allocator.h"
 #include "asset.h"
 
 #include <GLES2/gl2.h>
 #include <cstdint>
 
+typedef enum TEXTURE_IMPORT_FLAGS : uint32_t {
+    TextureImportNone             = 0,
+    TextureImportPremultiplyAlpha = 1 << 0,
+    TextureImportLuminanceAlpha   = 1 << 1,     // 16 bpp, RGB collapsed to luma
+    TextureImportRGB565           = 1 << 2,     // 16 bpp, alpha dropped
+    TextureImportRGBA4444         = 1 << 3,     // 16 bpp
+    TextureImportAutoFormat       = 1 << 4,     // LuminanceAlpha for greyscale, RGB565 for opaque, RGBA8 otherwise
+    TextureImportDither           = 1 << 5,     // Ordered dither when quantizing to RGB565 / RGBA4444
+    TextureImportMipmaps          = 1 << 6,     // Full mip chain, ignored for NPOT images when the GPU can't mip them
+    TextureImportStreamed         = 1 << 7      // Texels uploaded in strips over the next frames, see texture_upload.h
+} TextureImportFlags;
+
+typedef enum class TEXTURE_FORMAT : uint32_t {
+    RGBA8,
+    LuminanceAlpha,
+    RGB565,
+    RGBA4444
+} TextureFormat;
+
 typedef struct {
     uint32_t Id;
     uint32_t Width;
     uint32_t Height;
-    uint8_t* Data;
+    uint32_t Levels;
+    uint8_t* Data;              // Decoded RGBA8 copy
+    uint32_t Flags;
+    TextureFormat Format;
+    bool IsReady;               // False while a streamed upload is still in flight
 } Texture2D;
 
-void CreateTexture2D(Asset& asset, Texture2D& texture, const bool filtered, const bool repeat);
+typedef struct {
+    uint32_t Format;
+    uint32_t Type;
+    uint32_t Alignment;         // GL_UNPACK_ALIGNMENT for tightly packed rows
+} TextureFormatGL;
+
+typedef struct TEXTURE_UPLOAD_QUEUE TextureUploadQueue;
+
+// Streamed textures are queued by address, it has to stay valid until the texture is ready or destroyed.
+// The scratch allocator holds the encoded file, converted levels and the mip chain, nothing outlives the call
+void CreateTexture2D(Asset& asset, Texture2D& texture, const bool filtered, const bool repeat,
+                     const uint32_t flags = TextureImportNone, TextureUploadQueue* queue = nullptr,
+                     const Allocator& scratch = g_heapAllocator);
+void CreateTexture2DFromPixels(const uint8_t* pixels, const uint32_t width, const uint32_t height, Texture2D& texture,
+                               const bool filtered, const bool repeat, const uint32_t flags = TextureImportNone,
+                               TextureUploadQueue* queue = nullptr, const Allocator& scratch = g_heapAllocator);
 void DestroyTexture2D(Texture2D& texture);
 void BindTexture2D(const Texture2D& texture);
+uint32_t GetTextureFormatSize(const TextureFormat& format);
+TextureFormatGL GetTextureFormatGL(const TextureFormat& format);
+
+// Bytes taken on the GPU by every level, drivers may pad on top of it
+uint32_t GetTexture2DMemorySize(const Texture2D& texture);
 
 #endif // TEXTURE2D_H
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "texture_cache.h"
+
+#include "utils.h"
+
+#include <cstring>
+
+inline CachedTexture* FindCachedTexture(TextureCache& cache, const char* path)
+{
+    for (uint32_t index = 0; index < g_maxCachedTextures; ++index)
+    {
+        CachedTexture& entry = cache.Entries[index];
+
+        if (entry.IsUsed && strcmp(entry.Path, path) == 0) {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+inline CachedTexture* FindCachedTexture(TextureCache& cache, const Texture2D* texture)
+{
+    for (uint32_t index = 0; index < g_maxCachedTextures; ++index)
+    {
+        CachedTexture& entry = cache.Entries[index];
+
+        if (entry.IsUsed && &entry.Texture == texture) {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+inline CachedTexture* FindFreeEntry(TextureCache& cache)
+{
+    for (uint32_t index = 0; index < g_maxCachedTextures; ++index)
+    {
+        if (!cache.Entries[index].IsUsed) {
+            return &cache.Entries[index];
+        }
+    }
+
+    return nullptr;
+}
+
+inline void EvictCachedTexture(TextureCache& cache, CachedTexture& entry)
+{
+    LogDebug("TextureCache evict %s, %d bytes", entry.Path, entry.GpuBytes);
+
+    CancelTextureUploads(*cache.Uploads, entry.Texture);
+    DestroyTexture2D(entry.Texture);
+
+    cache.Stats.ResidentBytes -= entry.GpuBytes;
+    cache.Stats.ResidentCount--;
+    cache.Stats.Evictions++;
+
+    entry.IsUsed = false;
+}
+
+// Least recently used among the unreferenced entries
+inline CachedTexture* FindEvictionCandidate(TextureCache& cache)
+{
+    CachedTexture* candidate = nullptr;
+
+    for (uint32_t index = 0; index < g_maxCachedTextures; ++index)
+    {
+        CachedTexture& entry = cache.Entries[index];
+
+        if (entry.IsUsed && entry.RefCount == 0 && (!candidate || entry.LastUsed < candidate->LastUsed)) {
+            candidate = &entry;
+        }
+    }
+
+    return candidate;
+}
+
+void CreateTextureCache(TextureCache& cache, AssetManager& assets, TextureUploadQueue& uploads, const uint32_t budget)
+{
+    cache.Entries = new CachedTexture[g_maxCachedTextures];
+
+    for (uint32_t index = 0; index < g_maxCachedTextures; ++index) {
+        cache.Entries[index].IsUsed = false;
+    }
+
+    cache.Tick    = 0;
+    cache.Budget  = budget;
+    cache.Assets  = &assets;
+    cache.Uploads = &uploads;
+    cache.Stats   = { 0, 0, 0, 0, 0 };
+}
+
+void DestroyTextureCache(TextureCache& cache)
+{
+    for (uint32_t index = 0; index < g_maxCachedTextures; ++index)
+    {
+        CachedTexture& entry = cache.Entries[index];
+
+        if (entry.IsUsed)
+        {
+            if (entry.RefCount > 0) {
+                LogError("gfxError: %s is still referenced :: DestroyTextureCache()", entry.Path);
+            }
+
+            CancelTextureUploads(*cache.Uploads, entry.Texture);
+            DestroyTexture2D(entry.Texture);
+        }
+    }
+
+    delete[] cache.Entries;
+
+    cache.Entries = nullptr;
+    cache.Stats   = { 0, 0, 0, 0, 0 };
+}
+
+Texture2D* AcquireTexture(TextureCache& cache, const char* path, const bool filtered, const bool repeat, const uint32_t flags,
+                          const Allocator& scratch)
+{
+    CachedTexture* entry = FindCachedTexture(cache, path);
+
+    if (entry)
+    {
+        if (entry->Filtered != filtered || entry->Repeat != repeat || entry->Flags != flags) {
+            LogError("gfxError: %s is already cached with other settings, sharing it as is :: AcquireTexture()", path);
+        }
+
+        entry->RefCount++;
+        entry->LastUsed = ++cache.Tick;
+
+        cache.Stats.Hits++;
+        return &entry->Texture;
+    }
+
+    if (strlen(path) >= g_maxTexturePathLength) {
+        LogError("gfxError: Texture path is too long :: AcquireTexture()");
+        return nullptr;
+    }
+
+    // Make room for the new entry before loading, the slots are the only hard limit
+    entry = FindFreeEntry(cache);
+
+    if (!entry)
+    {
+        CachedTexture* candidate = FindEvictionCandidate(cache);
+
+        if (!candidate) {
+            LogError("gfxError: Every cached texture is referenced :: AcquireTexture()");
+            return nullptr;
+        }
+
+        EvictCachedTexture(cache, *candidate);
+        entry = candidate;
+    }
+
+    Asset asset = cache.Assets->OpenAsset(path);
+
+    if (!asset.IsOpen()) {
+        LogError("gfxError: Failed to open the texture asset file :: AcquireTexture()");
+        return nullptr;
+    }
+
+    CreateTexture2D(asset, entry->Texture, filtered, repeat, flags, cache.Uploads, scratch);
+    asset.Close();
+
+    strcpy(entry->Path, path);
+
+    entry->Filtered = filtered;
+    entry->Repeat   = repeat;
+    entry->Flags    = flags;
+    entry->RefCount = 1;
+    entry->GpuBytes = GetTexture2DMemorySize(entry->Texture);
+    entry->LastUsed = ++cache.Tick;
+    entry->IsUsed   = true;
+
+    cache.Stats.ResidentBytes += entry->GpuBytes;
+    cache.Stats.ResidentCount++;
+    cache.Stats.Loads++;
+
+    TrimTextureCache(cache);
+    return &entry->Texture;
+}
+
+void ReleaseTexture(TextureCache& cache, const Texture2D* texture)
+{
+    CachedTexture* entry = FindCachedTexture(cache, texture);
+
+    if (!entry || entry->RefCount == 0) {
+        LogError("gfxError: Texture isn't referenced by the cache :: ReleaseTexture()");
+        return;
+    }
+
+    // Kept resident, the next screen may well ask for it again
+    entry->RefCount--;
+    entry->LastUsed = ++cache.Tick;
+
+    TrimTextureCache(cache);
+}
+
+void SetTextureCacheBudget(TextureCache& cache, const uint32_t budget)
+{
+    cache.Budget = budget;
+    TrimTextureCache(cache);
+}
+
+void TrimTextureCache(TextureCache& cache)
+{
+    while (cache.Stats.ResidentBytes > cache.Budget)
+    {
+        CachedTexture* candidate = FindEvictionCandidate(cache);
+
+        // Whatever is left is in use, the budget is a target rather than a hard cap
+        if (!candidate) {
+            break;
+        }
+
+        EvictCachedTexture(cache, *candidate);
+    }
+}
\ No newline at end of file
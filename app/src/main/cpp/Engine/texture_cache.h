@@ -0,0 +1,57 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include "asset_manager.h"
+#include "texture2d.h"
+#include "texture_upload.h"
+
+#include <cstdint>
+
+constexpr const uint32_t g_maxCachedTextures = 64;
+constexpr const uint32_t g_maxTexturePathLength = 128;
+constexpr const uint32_t g_defaultTextureBudget = 48 * 1024 * 1024;    // Bytes
+
+typedef struct {
+    char Path[g_maxTexturePathLength];
+    Texture2D Texture;
+    bool Filtered;
+    bool Repeat;
+    uint32_t Flags;
+    uint32_t RefCount;
+    uint32_t GpuBytes;      // Estimate, every level at the size of its format
+    uint64_t LastUsed;      // Tick of the last acquire or release
+    bool IsUsed;
+} CachedTexture;
+
+typedef struct {
+    uint32_t ResidentBytes;
+    uint32_t ResidentCount;
+    uint32_t Hits;
+    uint32_t Loads;
+    uint32_t Evictions;
+} TextureCacheStats;
+
+// Textures are shared by asset path and stay resident after their last release,
+// unreferenced ones are evicted least recently used first once the budget is exceeded
+typedef struct {
+    CachedTexture* Entries;     // Fixed array, texture addresses stay valid while referenced
+    uint64_t Tick;
+    uint32_t Budget;
+    AssetManager* Assets;
+    TextureUploadQueue* Uploads;
+    TextureCacheStats Stats;
+} TextureCache;
+
+void CreateTextureCache(TextureCache& cache, AssetManager& assets, TextureUploadQueue& uploads,
+                        const uint32_t budget = g_defaultTextureBudget);
+void DestroyTextureCache(TextureCache& cache);
+
+// Loads the texture on a miss, or reloads it if it was evicted since its last use. Scratch is only used by loads
+Texture2D* AcquireTexture(TextureCache& cache, const char* path, const bool filtered, const bool repeat,
+                          const uint32_t flags = TextureImportNone, const Allocator& scratch = g_heapAllocator);
+void ReleaseTexture(TextureCache& cache, const Texture2D* texture);
+
+void SetTextureCacheBudget(TextureCache& cache, const uint32_t budget);
+void TrimTextureCache(TextureCache& cache);
+
+#endif // TEXTURE_CACHE_H
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "texture_upload.h"
+
+#include "clock.h"
+#include "utils.h"
+
+inline void RemoveTextureUpload(TextureUploadQueue& queue, const uint32_t position)
+{
+    FreeArray(g_heapAllocator, queue.Uploads[position].Data);
+
+    // Shifted rather than swapped, uploads finish in the order they were queued
+    for (uint32_t index = position; index + 1 < queue.Count; ++index) {
+        queue.Uploads[index] = queue.Uploads[index + 1];
+    }
+
+    --queue.Count;
+}
+
+inline bool HasPendingLevels(const TextureUploadQueue& queue, const Texture2D* texture)
+{
+    for (uint32_t index = 0; index < queue.Count; ++index)
+    {
+        if (queue.Uploads[index].Texture == texture) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+inline void UploadTextureRows(const TextureUpload& upload, const uint32_t firstRow, const uint32_t rowCount)
+{
+    const TextureFormatGL formatGL = GetTextureFormatGL(upload.Texture->Format);
+    const uint32_t rowSize = upload.Width * GetTextureFormatSize(upload.Texture->Format);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, formatGL.Alignment);
+    glTexSubImage2D(GL_TEXTURE_2D, upload.Level, 0, firstRow, upload.Width, rowCount,
+                    formatGL.Format, formatGL.Type, upload.Data + firstRow * rowSize);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+void CreateTextureUploadQueue(TextureUploadQueue& queue, const uint32_t bytesPerFrame, const uint32_t microsecondsPerFrame)
+{
+    queue.Count = 0;
+    queue.BytesPerFrame = bytesPerFrame;
+    queue.MicrosecondsPerFrame = microsecondsPerFrame;
+    queue.Stats = { 0, 0, 0 };
+}
+
+void DestroyTextureUploadQueue(TextureUploadQueue& queue)
+{
+    for (uint32_t index = 0; index < queue.Count; ++index) {
+        FreeArray(g_heapAllocator, queue.Uploads[index].Data);
+    }
+
+    queue.Count = 0;
+}
+
+void QueueTextureUpload(TextureUploadQueue& queue, Texture2D& texture, const uint32_t level,
+                        const uint32_t width, const uint32_t height, uint8_t* data)
+{
+    texture.IsReady = false;
+
+    // No room left, pay for the whole level now rather than lose it
+    if (queue.Count == g_maxTextureUploads)
+    {
+        LogError("gfxError: Texture upload queue is full, uploading synchronously :: QueueTextureUpload()");
+
+        const TextureUpload upload = { &texture, level, width, height, data, 0 };
+        UploadTextureRows(upload, 0, height);
+
+        FreeArray(g_heapAllocator, data);
+
+        texture.IsReady = !HasPendingLevels(queue, &texture);
+        return;
+    }
+
+    queue.Uploads[queue.Count++] = { &texture, level, width, height, data, 0 };
+}
+
+void ProcessTextureUploads(TextureUploadQueue& queue)
+{
+    queue.Stats = { 0, 0, 0 };
+
+    if (queue.Count == 0) {
+        return;
+    }
+
+    Clock timer;
+
+    // Callers may rely on the unit 0 binding, it is restored once the strips are out
+    int32_t boundTexture = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
+
+    uint32_t boundId = (uint32_t)boundTexture;
+
+    while (queue.Count > 0)
+    {
+        TextureUpload& upload = queue.Uploads[0];
+
+        const uint32_t rowSize = upload.Width * GetTextureFormatSize(upload.Texture->Format);
+        const uint32_t rowsLeft = upload.Height - upload.Row;
+
+        // Strip sized for the copy, shrunk to what is left of the frame budget
+        const uint32_t budgetLeft = (queue.Stats.BytesUploaded < queue.BytesPerFrame) ? queue.BytesPerFrame - queue.Stats.BytesUploaded : 0;
+        const uint32_t stripSize = (budgetLeft < g_textureUploadStripSize) ? budgetLeft : g_textureUploadStripSize;
+
+        uint32_t rowCount = (rowSize > 0) ? stripSize / rowSize : rowsLeft;
+        rowCount = (rowCount == 0) ? 1 : rowCount;
+        rowCount = (rowCount > rowsLeft) ? rowsLeft : rowCount;
+
+        if (boundId != upload.Texture->Id) {
+            glBindTexture(GL_TEXTURE_2D, upload.Texture->Id);
+            boundId = upload.Texture->Id;
+        }
+
+        UploadTextureRows(upload, upload.Row, rowCount);
+
+        upload.Row += rowCount;
+
+        queue.Stats.BytesUploaded += rowCount * rowSize;
+        queue.Stats.Strips++;
+
+        if (upload.Row == upload.Height)
+        {
+            Texture2D* texture = upload.Texture;
+            RemoveTextureUpload(queue, 0);
+
+            if (!HasPendingLevels(queue, texture)) {
+                texture->IsReady = true;
+                queue.Stats.Completed++;
+            }
+        }
+
+        const bool isOverBytes = queue.Stats.BytesUploaded >= queue.BytesPerFrame;
+        const bool isOverTime = timer.GetElapsedTime() * 1000000.0f >= (float)queue.MicrosecondsPerFrame;
+
+        if (isOverBytes || isOverTime) {
+            break;
+        }
+    }
+
+    if (boundId != (uint32_t)boundTexture) {
+        glBindTexture(GL_TEXTURE_2D, (uint32_t)boundTexture);
+    }
+}
+
+void CancelTextureUploads(TextureUploadQueue& queue, const Texture2D& texture)
+{
+    uint32_t index = 0;
+
+    while (index < queue.Count)
+    {
+        if (queue.Uploads[index].Texture == &texture) {
+            RemoveTextureUpload(queue, index);
+        } else {
+            ++index;
+        }
+    }
+}
\ No newline at end of file
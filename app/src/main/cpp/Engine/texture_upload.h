@@ -0,0 +1,51 @@
+#ifndef TEXTURE_UPLOAD_H
+#define TEXTURE_UPLOAD_H
+
+#include "texture2d.h"
+
+#include <cstdint>
+
+constexpr const uint32_t g_maxTextureUploads = 64;                 // Pending levels, not textures
+constexpr const uint32_t g_textureUploadStripSize = 16 * 1024;     // Bytes per glTexSubImage2D call
+constexpr const uint32_t g_defaultUploadBytesPerFrame = 256 * 1024;
+constexpr const uint32_t g_defaultUploadMicrosecondsPerFrame = 2000;
+
+typedef struct {
+    Texture2D* Texture;
+    uint32_t Level;
+    uint32_t Width;
+    uint32_t Height;
+    uint8_t* Data;          // Converted texels in the layout of the texture format, owned by the queue (g_heapAllocator)
+    uint32_t Row;           // Next row to upload
+} TextureUpload;
+
+typedef struct {
+    uint32_t BytesUploaded;
+    uint32_t Strips;
+    uint32_t Completed;     // Textures that became ready
+} TextureUploadStats;
+
+typedef struct TEXTURE_UPLOAD_QUEUE {
+    TextureUpload Uploads[g_maxTextureUploads];
+    uint32_t Count;
+    uint32_t BytesPerFrame;
+    uint32_t MicrosecondsPerFrame;
+    TextureUploadStats Stats;
+} TextureUploadQueue;
+
+void CreateTextureUploadQueue(TextureUploadQueue& queue, const uint32_t bytesPerFrame = g_defaultUploadBytesPerFrame,
+                              const uint32_t microsecondsPerFrame = g_defaultUploadMicrosecondsPerFrame);
+void DestroyTextureUploadQueue(TextureUploadQueue& queue);
+
+// Takes ownership of the data, which must come from g_heapAllocator (AllocateArray).
+// The level storage must already be allocated with glTexImage2D
+void QueueTextureUpload(TextureUploadQueue& queue, Texture2D& texture, const uint32_t level,
+                        const uint32_t width, const uint32_t height, uint8_t* data);
+
+// Uploads row strips in queue order until either budget runs out, at least one strip per call
+void ProcessTextureUploads(TextureUploadQueue& queue);
+
+// Drops the pending levels of a texture about to be destroyed
+void CancelTextureUploads(TextureUploadQueue& queue, const Texture2D& texture);
+
+#endif // TEXTURE_UPLOAD_H
\ No newline at end of file
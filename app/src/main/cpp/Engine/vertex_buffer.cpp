@@ -2,29 +2,39 @@
 
 #include "utils.h"
 
-inline void DefineVertexAttribPointer(const uint32_t program, const VertexElement& element,
-                                      const uint32_t stride, uint16_t& offset)
+inline int32_t GetVertexAttribLocation(const uint32_t program, const VertexElement& element)
 {
-    // Element attribute location
-    const uint32_t attribLocation = [&]() {
-        uint32_t tmpLocation;
-        switch (element) {
-            case VertexElement::Position:
-                tmpLocation = (uint32_t)glGetAttribLocation(program, "Position");
-                break;
-            case VertexElement::Color:
-                tmpLocation = (uint32_t)glGetAttribLocation(program, "Color");
-                break;
-            case VertexElement::TexCoord:
-                tmpLocation = (uint32_t)glGetAttribLocation(program, "TexCoord");
-                break;
-            case VertexElement::Normal:
-                tmpLocation = (uint32_t)glGetAttribLocation(program, "Normal");
-                break;
-        } return tmpLocation;
-    }();
+    switch (element) {
+        case VertexElement::Position:
+            return glGetAttribLocation(program, "Position");
+        case VertexElement::Color:
+            return glGetAttribLocation(program, "Color");
+        case VertexElement::TexCoord:
+            return glGetAttribLocation(program, "TexCoord");
+        case VertexElement::Normal:
+            return glGetAttribLocation(program, "Normal");
+        case VertexElement::TexIndex:
+            return glGetAttribLocation(program, "TexIndex");
+        case VertexElement::Corner:
+            return glGetAttribLocation(program, "Corner");
+        case VertexElement::Animation:
+            return glGetAttribLocation(program, "Animation");
+        case VertexElement::Motion:
+            return glGetAttribLocation(program, "Motion");
+    } return -1;
+}
 
-    LogDebug("AttribLocation -> %d", attribLocation);
+inline int32_t GetVertexBufferLocation(const VertexBuffer& buffer, const VertexElement& element)
+{
+    if (buffer.HasLocations) {
+        return buffer.Locations[(uint32_t)element];
+    } return GetVertexAttribLocation(buffer.Program, element);
+}
+
+inline void DefineVertexAttribPointer(const VertexBuffer& buffer, const VertexElement& element, uint32_t& offset)
+{
+    // Element attribute location
+    const int32_t attribLocation = GetVertexBufferLocation(buffer, element);
 
     // Element size
     const uint32_t elementSize = [&]() {
@@ -42,10 +52,27 @@ inline void DefineVertexAttribPointer(const uint32_t program, const VertexElemen
             case VertexElement::Normal:
                 tmpSize = 3;    // N (XYZ)
                 break;
+            case VertexElement::TexIndex:
+                tmpSize = 1;    // Texture slot
+                break;
+            case VertexElement::Corner:
+                tmpSize = 2;    // Quad corner (XY)
+                break;
+            case VertexElement::Animation:
+                tmpSize = 4;    // Clip, start time, scale (XY)
+                break;
+            case VertexElement::Motion:
+                tmpSize = 4;    // Velocity (XY), spawn time, unused
+                break;
         } return tmpSize;
     }();
 
-    glVertexAttribPointer(attribLocation, elementSize, GL_FLOAT, GL_FALSE, stride, (void*)offset);
+    // Unused by the shader or the program isn't linked yet, the element still takes its space
+    if (attribLocation >= 0) {
+        glEnableVertexAttribArray((uint32_t)attribLocation);
+        glVertexAttribPointer((uint32_t)attribLocation, elementSize, GL_FLOAT, GL_FALSE, buffer.Stride, (void*)(uintptr_t)offset);
+    }
+
     offset += elementSize * sizeof(float);
 }
 
@@ -54,16 +81,26 @@ void CreateVertexBuffer(const uint32_t program, const VertexElement* layout,
 {
     const uint32_t usage = dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW;
 
+    // Keep the layout around, attribute pointers must be re-specified whenever another buffer was bound
+    buffer.Program = program;
+    buffer.LayoutCount = (count > g_maxVertexElements) ? g_maxVertexElements : count;
+
+    for (uint32_t index = 0; index < buffer.LayoutCount; ++index) {
+        buffer.Layout[index] = layout[index];
+    }
+
+    buffer.HasLocations = false;
+    ResolveVertexBufferLocations(buffer);
+
     glGenBuffers(1, &buffer.Id);
 
     glBindBuffer(GL_ARRAY_BUFFER, buffer.Id);
     glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)buffer.Size, buffer.Data, usage);
 
-    uint16_t offset = 0;
+    uint32_t offset = 0;
 
-    for (uint32_t index = 0; index < count; ++index) {
-        glEnableVertexAttribArray(index);
-        DefineVertexAttribPointer(program, layout[index], buffer.Stride, offset);
+    for (uint32_t index = 0; index < buffer.LayoutCount; ++index) {
+        DefineVertexAttribPointer(buffer, buffer.Layout[index], offset);
     }
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -79,9 +116,261 @@ void BindVertexBuffer(const VertexBuffer& buffer)
     glBindBuffer(GL_ARRAY_BUFFER, buffer.Id);
 }
 
+void BindVertexBufferAttribs(const VertexBuffer& buffer, const uint32_t baseOffset)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, buffer.Id);
+
+    // Arrays left enabled by another layout would keep reading from the previous buffer
+    const VertexElement elements[] = {
+        VertexElement::Position,
+        VertexElement::Color,
+        VertexElement::TexCoord,
+        VertexElement::Normal,
+        VertexElement::TexIndex,
+        VertexElement::Corner,
+        VertexElement::Animation,
+        VertexElement::Motion
+    };
+
+    for (const VertexElement& element : elements)
+    {
+        bool isUsed = false;
+
+        for (uint32_t index = 0; index < buffer.LayoutCount; ++index) {
+            isUsed |= (buffer.Layout[index] == element);
+        }
+
+        const int32_t location = GetVertexBufferLocation(buffer, element);
+
+        if (!isUsed && location >= 0) {
+            glDisableVertexAttribArray((uint32_t)location);
+        }
+    }
+
+    uint32_t offset = baseOffset;
+
+    for (uint32_t index = 0; index < buffer.LayoutCount; ++index) {
+        DefineVertexAttribPointer(buffer, buffer.Layout[index], offset);
+    }
+}
+
+void ResolveVertexBufferLocations(VertexBuffer& buffer)
+{
+    if (buffer.HasLocations) {
+        return;
+    }
+
+    int32_t linkStatus = 0;
+    glGetProgramiv(buffer.Program, GL_LINK_STATUS, &linkStatus);
+
+    if (!linkStatus) {
+        return;
+    }
+
+    for (uint32_t element = 0; element < g_maxVertexElements; ++element) {
+        buffer.Locations[element] = GetVertexAttribLocation(buffer.Program, (VertexElement)element);
+    }
+
+    buffer.HasLocations = true;
+}
+
+void DisableVertexBufferAttribs(const VertexBuffer& buffer)
+{
+    for (uint32_t index = 0; index < buffer.LayoutCount; ++index)
+    {
+        const int32_t location = GetVertexBufferLocation(buffer, buffer.Layout[index]);
+
+        if (location >= 0) {
+            glDisableVertexAttribArray((uint32_t)location);
+        }
+    }
+}
+
 void UpdateVertexBuffer(const void* data, const uint32_t size, const VertexBuffer& buffer)
 {
     glBindBuffer(GL_ARRAY_BUFFER, buffer.Id);
     glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void OrphanVertexBuffer(const void* data, const uint32_t size, const VertexBuffer& buffer)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, buffer.Id);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)buffer.Size, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/// STREAMING
+
+inline uint32_t RangeEnd(const DirtyRange& range)
+{
+    return range.Offset + range.Size;
+}
+
+inline void MergeDirtyRanges(DirtyRange& lhe, const DirtyRange& rhe)
+{
+    const uint32_t end = (RangeEnd(lhe) > RangeEnd(rhe)) ? RangeEnd(lhe) : RangeEnd(rhe);
+
+    lhe.Offset = (lhe.Offset < rhe.Offset) ? lhe.Offset : rhe.Offset;
+    lhe.Size   = end - lhe.Offset;
+}
+
+inline void RemoveDirtyRange(DirtyRange* ranges, uint32_t& count, const uint32_t position)
+{
+    for (uint32_t index = position; index + 1 < count; ++index) {
+        ranges[index] = ranges[index + 1];
+    }
+
+    --count;
+}
+
+inline void InsertDirtyRange(DirtyRange* ranges, uint32_t& count, const DirtyRange& range)
+{
+    // Out of slots, collapse the two closest neighbours to make room
+    if (count == g_maxDirtyRanges)
+    {
+        uint32_t closest = 0;
+        uint32_t closestGap = UINT32_MAX;
+
+        for (uint32_t index = 0; index + 1 < count; ++index)
+        {
+            const uint32_t gap = ranges[index + 1].Offset - RangeEnd(ranges[index]);
+
+            if (gap < closestGap) {
+                closestGap = gap;
+                closest = index;
+            }
+        }
+
+        MergeDirtyRanges(ranges[closest], ranges[closest + 1]);
+        RemoveDirtyRange(ranges, count, closest + 1);
+    }
+
+    // Keep the ranges sorted by offset
+    uint32_t position = 0;
+
+    while (position < count && ranges[position].Offset < range.Offset) {
+        ++position;
+    }
+
+    for (uint32_t index = count; index > position; --index) {
+        ranges[index] = ranges[index - 1];
+    }
+
+    ranges[position] = range;
+    ++count;
+
+    // Coalesce overlapping spans and spans separated by a gap too small to be worth another call
+    uint32_t index = 0;
+
+    while (index + 1 < count)
+    {
+        if (ranges[index + 1].Offset <= RangeEnd(ranges[index]) + g_dirtyRangeMergeGap) {
+            MergeDirtyRanges(ranges[index], ranges[index + 1]);
+            RemoveDirtyRange(ranges, count, index + 1);
+        } else {
+            ++index;
+        }
+    }
+}
+
+void CreateStreamingVertexBuffer(const uint32_t program, const VertexElement* layout, const uint32_t count,
+                                 const VertexBuffer& source, StreamingVertexBuffer& buffer,
+                                 const StreamingMode& mode, const uint32_t bufferCount)
+{
+    buffer.Mode    = mode;
+    buffer.Current = 0;
+    buffer.Stats   = { 0, 0, 0 };
+
+    // Orphaning hands the synchronization to the driver, a single buffer is enough
+    buffer.BufferCount = [&]() {
+        if (mode == StreamingMode::Orphan || bufferCount == 0) {
+            return 1u;
+        } return (bufferCount > g_maxStreamingBuffers) ? g_maxStreamingBuffers : bufferCount;
+    }();
+
+    for (uint32_t index = 0; index < buffer.BufferCount; ++index)
+    {
+        buffer.Buffers[index].Stride = source.Stride;
+        buffer.Buffers[index].Size   = source.Size;
+        buffer.Buffers[index].Data   = source.Data;
+
+        CreateVertexBuffer(program, layout, count, buffer.Buffers[index], true);
+
+        buffer.DirtyCount[index] = 0;
+    }
+}
+
+void DestroyStreamingVertexBuffer(const StreamingVertexBuffer& buffer)
+{
+    for (uint32_t index = 0; index < buffer.BufferCount; ++index) {
+        DestroyVertexBuffer(buffer.Buffers[index]);
+    }
+}
+
+void MarkStreamingVertexBufferDirty(StreamingVertexBuffer& buffer, const uint32_t offset, const uint32_t size)
+{
+    const uint32_t bufferSize = buffer.Buffers[0].Size;
+
+    if (size == 0 || offset >= bufferSize) {
+        return;
+    }
+
+    const DirtyRange range = { offset, (offset + size > bufferSize) ? bufferSize - offset : size };
+
+    // Every buffer in the ring holds a stale copy of the span until it gets its own upload
+    for (uint32_t index = 0; index < buffer.BufferCount; ++index) {
+        InsertDirtyRange(buffer.DirtyRanges[index], buffer.DirtyCount[index], range);
+    }
+}
+
+void FlushStreamingVertexBuffer(StreamingVertexBuffer& buffer)
+{
+    buffer.Stats = { 0, 0, 0 };
+
+    // Advance to the buffer the GPU is least likely to still be reading
+    buffer.Current = (buffer.Current + 1) % buffer.BufferCount;
+
+    const VertexBuffer& current = buffer.Buffers[buffer.Current];
+    uint32_t& dirtyCount = buffer.DirtyCount[buffer.Current];
+
+    glBindBuffer(GL_ARRAY_BUFFER, current.Id);
+
+    if (dirtyCount > 0)
+    {
+        if (buffer.Mode == StreamingMode::Orphan)
+        {
+            // The old storage is detached, so the whole content has to be sent again
+            glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)current.Size, nullptr, GL_STREAM_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, current.Size, current.Data);
+
+            buffer.Stats.BytesUploaded += current.Size;
+            buffer.Stats.UploadCalls++;
+            buffer.Stats.Orphans++;
+        }
+
+        else
+        {
+            const DirtyRange* ranges = buffer.DirtyRanges[buffer.Current];
+
+            for (uint32_t index = 0; index < dirtyCount; ++index)
+            {
+                const uint8_t* data = (const uint8_t*)current.Data + ranges[index].Offset;
+                glBufferSubData(GL_ARRAY_BUFFER, ranges[index].Offset, ranges[index].Size, data);
+
+                buffer.Stats.BytesUploaded += ranges[index].Size;
+                buffer.Stats.UploadCalls++;
+            }
+        }
+
+        dirtyCount = 0;
+    }
+
+    BindVertexBufferAttribs(current);
+}
+
+const VertexBuffer& GetStreamingVertexBufferCurrent(const StreamingVertexBuffer& buffer)
+{
+    return buffer.Buffers[buffer.Current];
 }
\ No newline at end of file
@@ -6,16 +6,71 @@
 #include <GLES2/gl2.h>
 #include <cstdint>
 
+constexpr const uint32_t g_maxVertexElements = 8;
+constexpr const uint32_t g_maxStreamingBuffers = 3;
+constexpr const uint32_t g_maxDirtyRanges = 16;
+constexpr const uint32_t g_dirtyRangeMergeGap = 256;    // Bytes
+
+static_assert((uint32_t)VertexElement::Motion < g_maxVertexElements, "Locations must cover every VertexElement");
+
+typedef enum class STREAMING_MODE {
+    Ring,       // Cycle through N buffers, upload only the dirty byte spans
+    Orphan      // Single buffer, re-specify the storage before every upload
+} StreamingMode;
+
 typedef struct {
     uint32_t Id;
     uint32_t Stride;
     uint32_t Size;
     void* Data;
+    uint32_t Program;
+    uint32_t LayoutCount;
+    VertexElement Layout[g_maxVertexElements];
+    int32_t Locations[g_maxVertexElements];    // Indexed by VertexElement, valid once HasLocations is set
+    bool HasLocations;
 } VertexBuffer;
 
+typedef struct {
+    uint32_t Offset;
+    uint32_t Size;
+} DirtyRange;
+
+typedef struct {
+    uint32_t BytesUploaded;
+    uint32_t UploadCalls;
+    uint32_t Orphans;
+} VertexBufferStats;
+
+typedef struct {
+    VertexBuffer Buffers[g_maxStreamingBuffers];
+    DirtyRange DirtyRanges[g_maxStreamingBuffers][g_maxDirtyRanges];
+    uint32_t DirtyCount[g_maxStreamingBuffers];
+    uint32_t BufferCount;
+    uint32_t Current;
+    StreamingMode Mode;
+    VertexBufferStats Stats;
+} StreamingVertexBuffer;
+
 void CreateVertexBuffer(const uint32_t program, const VertexElement* layout, const uint32_t count, VertexBuffer& buffer, const bool dynamic);
 void DestroyVertexBuffer(const VertexBuffer& buffer);
 void BindVertexBuffer(const VertexBuffer& buffer);
+void BindVertexBufferAttribs(const VertexBuffer& buffer, const uint32_t baseOffset = 0);
+
+// Caches the attribute locations once the program is linked, buffers created before that look them up on every bind
+void ResolveVertexBufferLocations(VertexBuffer& buffer);
+
+// Buffers drawn with another program leave their arrays enabled at locations the next program may not use
+void DisableVertexBufferAttribs(const VertexBuffer& buffer);
 void UpdateVertexBuffer(const void* data, const uint32_t size, const VertexBuffer& buffer);
+void OrphanVertexBuffer(const void* data, const uint32_t size, const VertexBuffer& buffer);
+
+// The source VertexBuffer must have Stride, Size and Data set, just like CreateVertexBuffer
+void CreateStreamingVertexBuffer(const uint32_t program, const VertexElement* layout, const uint32_t count,
+                                 const VertexBuffer& source, StreamingVertexBuffer& buffer,
+                                 const StreamingMode& mode, const uint32_t bufferCount = g_maxStreamingBuffers);
+void DestroyStreamingVertexBuffer(const StreamingVertexBuffer& buffer);
+void MarkStreamingVertexBufferDirty(StreamingVertexBuffer& buffer, const uint32_t offset, const uint32_t size);
+void FlushStreamingVertexBuffer(StreamingVertexBuffer& buffer);
+const VertexBuffer& GetStreamingVertexBufferCurrent(const StreamingVertexBuffer& buffer);
 
 #endif // VERTEX_BUFFER_H
\ No newline at end of file
@@ -5,7 +5,11 @@ typedef enum class VERTEX_ELEMENT {
     Position,
     Color,
     TexCoord,
-    Normal
+    Normal,
+    TexIndex,
+    Corner,
+    Animation,
+    Motion
 } VertexElement;
 
 #endif // VERTEX_LAYOUT_H
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 // Engine
 #include "Engine/utils.h"
+#include "Engine/allocator.h"
+#include "Engine/allocation_tracker.h"
 #include "Engine/asset_manager.h"
 #include "Engine/clock.h"
 #include "Engine/touchscreen.h"
@@ -12,7 +14,18 @@
 #include "Engine/vertex_buffer.h"
 #include "Engine/index_buffer.h"
 #include "Engine/texture2d.h"
+#include "Engine/texture_upload.h"
+#include "Engine/texture_cache.h"
+#include "Engine/sprite_batch.h"
+#include "Engine/sprite_mesh.h"
 #include "Engine/sprite.h"
+#include "Engine/render_queue.h"
+#include "Engine/animation.h"
+#include "Engine/gpu_sprite_layer.h"
+#include "Engine/bitmap_font.h"
+#include "Engine/collision.h"
+#include "Engine/collision_mask.h"
+#include "Engine/entity_store.h"
 
 // JNI
 #include <jni.h>
@@ -33,8 +46,21 @@ static Clock g_mainClock;
 static TouchScreen g_displayInput;
 static GraphicsContext g_gfxContext;
 static AssetManager g_assetManager;
+static QuadIndexBuffer g_quadIndexBuffer;
+static SpriteBatch g_spriteBatch;
+static LinearArena g_frameArena;
+static LinearArena g_scratchArena;
+static TextureUploadQueue g_textureUploads;
+static Texture2D g_placeholderTexture;
+static TextureCache g_textureCache;
+static RenderQueue g_renderQueue;
+static EntityStore g_entityStore;
+static CollisionGrid g_collisionGrid;
+static TextLayoutCache g_textLayouts;
+static DistanceFieldRenderer g_distanceFieldText;
 
 static uint32_t g_shaderProgram = 0;
+static uint32_t g_gpuSpriteProgram = 0;
 static uint32_t g_vertexShaderId = 0;
 static uint32_t g_pixelShaderId = 0;
 
@@ -46,6 +72,8 @@ static Matrix g_projection;
 
 static Vec2 g_workRes;
 
+static float g_engineTime = 0.0f;
+
 namespace Application
 {
     void Create();
@@ -58,34 +86,153 @@ Java_com_carloid_cppandroidengine_EngineGLRenderer_ApplicationCreate(JNIEnv* env
 {
     g_workRes = { (float)width, (float)height };
 
+    // Transient memory of the engine, loads rewind the scratch arena and the frame arena is reset every frame
+    CreateLinearArena(g_frameArena, g_frameArenaSize);
+    CreateLinearArena(g_scratchArena, g_scratchArenaSize);
+
     g_displayInput.Create((uint32_t*)env, width, height);
     g_gfxContext.Create(width, height);
 
+    // Shared by every quad based draw, grown on demand
+    CreateQuadIndexBuffer(g_quadIndexBuffer, g_gfxContext.SupportsUintIndices());
+
     AAssetManager* assetManagerPtr = AAssetManager_fromJava(env, assetManager);
     g_assetManager.Create(assetManagerPtr);
 
     g_shaderProgram = glCreateProgram();
 
+    // Locations are resolved on the first flush after linking, so the program doesn't need to be linked yet
+    CreateSpriteBatch(g_spriteBatch, g_shaderProgram, g_quadIndexBuffer);
+
+    // Faint premultiplied grey, sprites show their footprint while their texture streams in
+    const uint8_t placeholderPixel[4] = { 0x40, 0x40, 0x40, 0x40 };
+
+    CreateTextureUploadQueue(g_textureUploads);
+    CreateTexture2DFromPixels(placeholderPixel, 1, 1, g_placeholderTexture, false, true);
+
+    g_spriteBatch.Placeholder = &g_placeholderTexture;
+
+    CreateTextureCache(g_textureCache, g_assetManager, g_textureUploads);
+    CreateRenderQueue(g_renderQueue);
+    SetRenderQueueView(g_renderQueue, { 0.0f, g_workRes.X, g_workRes.Y, 0.0f });
+
+    CreateEntityStore(g_entityStore);
+    CreateCollisionGrid(g_collisionGrid);
+    CreateTextLayoutCache(g_textLayouts);
+
     Application::Create();
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_carloid_cppandroidengine_EngineGLRenderer_ApplicationUpdate(JNIEnv* env, jobject obj)
 {
+    BeginAllocationFrame();
+
     float deltaTime = g_mainClock.GetElapsedTime();
     g_mainClock.Restart();
 
+    // Shared clock of everything evaluated on the GPU, the CPU reads the same value for its side
+    g_engineTime += deltaTime;
+
+    // Strips of streamed textures, before anything samples them this frame
+    SetAllocationTag(AllocationTag::Textures);
+    ProcessTextureUploads(g_textureUploads);
+
+    // Moving entities are integrated before the game sees them, bounds events are readable during the update
+    SetAllocationTag(AllocationTag::Entities);
+    UpdateEntityKinematics(g_entityStore, deltaTime);
+    UpdateEntityGpuSprites(g_entityStore, g_engineTime);
+    UpdateEntityCollisions(g_entityStore, g_collisionGrid);
+
+    // Clips switched by the game show their first frame right away and start advancing next frame
+    UpdateEntityAnimations(g_entityStore, deltaTime);
+
+    SetAllocationTag(AllocationTag::Game);
     Application::Update(deltaTime);
+
+    // Every entity with a sprite is queued, the game only moves the handles around
+    SetAllocationTag(AllocationTag::Render);
+    SubmitEntitySprites(g_entityStore, g_renderQueue, g_shaderProgram);
+
+    // Sprites drawn through gfxDrawSprite go first, the sorted submissions follow
+    const Vec2 workResScale = { (float)g_gfxContext.GetDisplayWidth() / g_workRes.X,
+                                (float)g_gfxContext.GetDisplayHeight() / g_workRes.Y };
+
+    FlushSpriteBatch(g_spriteBatch);
+    FlushRenderQueue(g_renderQueue, g_spriteBatch, workResScale);
+
+    EndSpriteBatch(g_spriteBatch);
+
+    if (g_distanceFieldText.Program != 0) {
+        EndSpriteBatch(g_distanceFieldText.Batch);
+    }
+
+    ResetLinearArena(g_frameArena);
+    EndAllocationFrame();
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_carloid_cppandroidengine_MainActivity_ApplicationDestroy(JNIEnv* env, jobject obj)
 {
     Application::Destroy();
+
+    if (g_distanceFieldText.Program != 0) {
+        DestroyDistanceFieldRenderer(g_distanceFieldText);
+    }
+
+    DestroyTextLayoutCache(g_textLayouts);
+    DestroyCollisionGrid(g_collisionGrid);
+    DestroyEntityStore(g_entityStore);
+    DestroyRenderQueue(g_renderQueue);
+    DestroyTextureCache(g_textureCache);
+
+    DestroySpriteBatch(g_spriteBatch);
+    DestroyQuadIndexBuffer(g_quadIndexBuffer);
+
+    DestroyTexture2D(g_placeholderTexture);
+    DestroyTextureUploadQueue(g_textureUploads);
+
+    DestroyLinearArena(g_scratchArena);
+    DestroyLinearArena(g_frameArena);
 }
 
 // Inline function aliases
 
+/// MEMORY
+
+// Everything allocated from it is released at the end of the frame
+inline Allocator getFrameAllocator()
+{
+    return GetArenaAllocator(g_frameArena);
+}
+
+// Load time temporaries, allocate them inside a ScratchScope opened on getScratchArena()
+inline LinearArena& getScratchArena()
+{
+    return g_scratchArena;
+}
+
+inline Allocator getScratchAllocator()
+{
+    return GetArenaAllocator(g_scratchArena);
+}
+
+// From here on every frame is expected to stay off the heap, see allocation_tracker.h
+inline void setAllocationSteadyState(const bool isSteady)
+{
+    SetAllocationSteadyState(isSteady);
+}
+
+inline const AllocationStats& getAllocationStats()
+{
+    return GetAllocationStats();
+}
+
+inline void logAllocationFrame()
+{
+    LogAllocationFrame(GetAllocationStats().LastFrame);
+}
+
 /// TOUCHSCREEN
 
 inline float getTouchScreenX(const TouchScreenId& id)
@@ -109,6 +256,184 @@ inline bool hasTouchEvent()
     return getTouchScreenX(id) != -1.0f && getTouchScreenY(id) != -1.0f;
 }
 
+/// ENTITY
+
+inline EntityId createEntity()
+{
+    return CreateEntity(g_entityStore);
+}
+
+inline void destroyEntity(const EntityId entity)
+{
+    DestroyEntity(g_entityStore, entity);
+}
+
+inline bool isEntityAlive(const EntityId entity)
+{
+    return IsEntityAlive(g_entityStore, entity);
+}
+
+inline void addTransform(const EntityId entity, const Vec2& position, const Vec2& scale = { 1.0f, 1.0f })
+{
+    AddTransform(g_entityStore, entity, position, scale);
+}
+
+inline void addSprite(const EntityId entity, Texture2D& texture, const Rect2D& texRect, const uint32_t color,
+                      const uint32_t layer, const float depth = 0.0f)
+{
+    AddSprite(g_entityStore, entity, texture, texRect, color, layer, depth);
+}
+
+inline void addVelocity(const EntityId entity, const Vec2& velocity, const Vec2& acceleration = { 0.0f, 0.0f })
+{
+    AddVelocity(g_entityStore, entity, velocity, acceleration);
+}
+
+inline void addCollider(const EntityId entity, const Vec2& offset = { 0.0f, 0.0f }, const Vec2& extent = { 1.0f, 1.0f },
+                        const uint32_t layer = 1, const uint32_t mask = 0xFFFFFFFF)
+{
+    AddCollider(g_entityStore, entity, offset, extent, layer, mask);
+}
+
+// Clip ids come from the library given to setEntityAnimations
+inline void addAnimator(const EntityId entity, const uint32_t clip, const float speed = 1.0f)
+{
+    AddAnimator(g_entityStore, entity, clip, speed);
+}
+
+// Spawns at the entity position with its scale, the layer draws and moves it from then on
+inline void addGpuSprite(const EntityId entity, GpuSpriteLayer& layer, const uint32_t clip,
+                         const Vec2& velocity, const uint32_t color = 0xFFFFFFFF)
+{
+    AddGpuSprite(g_entityStore, entity, layer, clip, velocity, color, g_engineTime);
+}
+
+inline Vec2& getEntityPosition(const EntityId entity)
+{
+    return GetEntityPosition(g_entityStore, entity);
+}
+
+inline Vec2& getEntityScale(const EntityId entity)
+{
+    return GetEntityScale(g_entityStore, entity);
+}
+
+inline Vec2& getEntityVelocity(const EntityId entity)
+{
+    return GetEntityVelocity(g_entityStore, entity);
+}
+
+inline Vec2& getEntityAcceleration(const EntityId entity)
+{
+    return GetEntityAcceleration(g_entityStore, entity);
+}
+
+inline void setEntityBounds(const EntityId entity, const Vec2& min, const Vec2& max, const BoundsMode& mode,
+                            const Vec2& wrapSpan = { 0.0f, 0.0f })
+{
+    SetEntityBounds(g_entityStore, entity, min, max, mode, wrapSpan);
+}
+
+// Entities that left their bounds during this frame's kinematics pass
+inline const KinematicsEvent* getKinematicsEvents(uint32_t& count)
+{
+    count = g_entityStore.EventCount;
+    return g_entityStore.Events;
+}
+
+// Overlapping collider pairs found by the broadphase before this frame's update
+inline const EntityCollision* getEntityCollisions(uint32_t& count)
+{
+    count = g_entityStore.CollisionCount;
+    return g_entityStore.Collisions;
+}
+
+inline uint32_t queryEntities(const ScreenRect& region, const uint32_t layerMask, EntityId* results, const uint32_t maxResults)
+{
+    return QueryEntities(g_entityStore, g_collisionGrid, region, layerMask, results, maxResults);
+}
+
+// Tests the box against the collider bounds of the last broadphase build, four at a time
+inline uint32_t overlapEntities(const ScreenRect& box, const uint32_t layerMask, EntityId* results = nullptr, const uint32_t maxResults = 0)
+{
+    return OverlapEntities(g_entityStore, box, layerMask, results, maxResults);
+}
+
+inline bool testEntityMasks(const EntityId lhe, const EntityId rhe)
+{
+    return TestEntityMasks(g_entityStore, lhe, rhe);
+}
+
+// Sprite regions found in the atlas get the pixel narrowphase in testEntityMasks
+inline void setEntityCollisionMasks(const CollisionMaskAtlas* atlas)
+{
+    g_entityStore.CollisionMasks = atlas;
+}
+
+inline const CollisionStats& getCollisionStats()
+{
+    return g_collisionGrid.Stats;
+}
+
+inline Vec2 getEntitySize(const EntityId entity)
+{
+    return GetEntitySize(g_entityStore, entity);
+}
+
+inline bool getEntityCollider(const EntityId entity, Vec2& position, Vec2& size)
+{
+    return GetEntityCollider(g_entityStore, entity, position, size);
+}
+
+inline void setEntityTexRect(const EntityId entity, const Rect2D& texRect)
+{
+    SetEntityTexRect(g_entityStore, entity, texRect);
+}
+
+inline void setEntityColor(const EntityId entity, const uint32_t color)
+{
+    SetEntityColor(g_entityStore, entity, color);
+}
+
+// Sprite regions found in the atlas are drawn with their tight-fit polygon
+inline void setEntitySpriteMeshes(const SpriteMeshAtlas* atlas)
+{
+    g_entityStore.Meshes = atlas;
+}
+
+// Remove every animator before swapping or clearing the library, their clip ids index into it
+inline void setEntityAnimations(const AnimationLibrary* library)
+{
+    g_entityStore.Animations = library;
+}
+
+inline void playEntityAnimation(const EntityId entity, const uint32_t clip, const bool restart = false)
+{
+    PlayEntityAnimation(g_entityStore, entity, clip, restart);
+}
+
+inline void setEntityAnimationSpeed(const EntityId entity, const float speed)
+{
+    SetEntityAnimationSpeed(g_entityStore, entity, speed);
+}
+
+inline void setEntityMotion(const EntityId entity, const Vec2& position, const Vec2& velocity)
+{
+    SetEntityMotion(g_entityStore, entity, position, velocity, g_engineTime);
+}
+
+inline void setEntityGpuClip(const EntityId entity, const uint32_t clip)
+{
+    SetEntityGpuClip(g_entityStore, entity, clip, g_engineTime);
+}
+
+// Clips that looped or finished during this frame's animation pass
+inline const AnimationEvent* getAnimationEvents(uint32_t& count)
+{
+    count = g_entityStore.AnimationEventCount;
+    return g_entityStore.AnimationEvents;
+}
+
 /// ASSET
 
 inline Asset openAsset(const char* filename)
@@ -143,7 +468,8 @@ inline void gfxClearBackBuffer(const uint32_t color)
 
 inline void gfxCompileShaderFromCode(const char* code, const ShaderType& type, Shader& object)
 {
-    CompileShader(code, type, object);
+    ScratchScope scratch(g_scratchArena);
+    CompileShader(code, type, object, getScratchAllocator());
 }
 
 inline void gfxCompileShaderFromAsset(const char* filename, const ShaderType& type, Shader& object)
@@ -152,15 +478,18 @@ inline void gfxCompileShaderFromAsset(const char* filename, const ShaderType& ty
 
     if (shaderAsset.IsOpen())
     {
+        ScratchScope scratch(g_scratchArena);
+        const Allocator allocator = getScratchAllocator();
+
         const uint32_t length = shaderAsset.GetLength();
-        char* buffer = new char[length + 1];
+        char* buffer = AllocateArray<char>(allocator, length + 1);
 
         shaderAsset.Read(buffer, length);
         buffer[length] = '\0';
 
-        CompileShader(buffer, type, object);
+        CompileShader(buffer, type, object, allocator);
 
-        delete[] buffer;
+        FreeArray(allocator, buffer);
 
         shaderAsset.Close();
     }
@@ -218,6 +547,32 @@ inline void gfxUpdateVertexBuffer(const void* data, const uint32_t size, const V
     UpdateVertexBuffer(data, size, buffer);
 }
 
+inline void gfxCreateStreamingVertexBuffer(const VertexElement* layout, const uint32_t count, const VertexBuffer& source,
+                                           StreamingVertexBuffer& buffer, const StreamingMode& mode = StreamingMode::Ring)
+{
+    CreateStreamingVertexBuffer(g_shaderProgram, layout, count, source, buffer, mode);
+}
+
+inline void gfxDestroyStreamingVertexBuffer(const StreamingVertexBuffer& buffer)
+{
+    DestroyStreamingVertexBuffer(buffer);
+}
+
+inline void gfxMarkVertexBufferDirty(StreamingVertexBuffer& buffer, const uint32_t offset, const uint32_t size)
+{
+    MarkStreamingVertexBufferDirty(buffer, offset, size);
+}
+
+inline void gfxFlushStreamingVertexBuffer(StreamingVertexBuffer& buffer)
+{
+    FlushStreamingVertexBuffer(buffer);
+}
+
+inline VertexBufferStats gfxGetVertexBufferStats(const StreamingVertexBuffer& buffer)
+{
+    return buffer.Stats;
+}
+
 inline void gfxSetPrimitiveType(const PrimitiveType& type)
 {
     g_primitiveType = type;
@@ -228,9 +583,39 @@ inline void gfxDraw(const uint32_t offset, const uint32_t count)
     g_gfxContext.Draw(g_primitiveType, offset, count);
 }
 
-inline void gfxDrawIndexed(const uint32_t count)
+inline void gfxDrawIndexed(const uint32_t count, const IndexType& indexType = IndexType::UnsignedShort)
+{
+    g_gfxContext.DrawIndexed(g_primitiveType, count, indexType);
+}
+
+inline void gfxReserveQuadIndices(const uint32_t quadCount)
 {
-    g_gfxContext.DrawIndexed(g_primitiveType, count);
+    ReserveQuadIndexBuffer(g_quadIndexBuffer, quadCount);
+}
+
+inline void gfxDrawQuads(const VertexBuffer& buffer, const uint32_t quadCount)
+{
+    gfxReserveQuadIndices(quadCount);
+    BindIndexBuffer(g_quadIndexBuffer.Buffer);
+
+    const uint32_t maxQuads = g_quadIndexBuffer.QuadCapacity;
+    const IndexType indexType = g_quadIndexBuffer.Type;
+
+    if (quadCount <= maxQuads) {
+        g_gfxContext.DrawIndexed(PrimitiveType::TriangleList, 6 * quadCount, indexType);
+        return;
+    }
+
+    // Indices can't address the whole batch, draw it in chunks by moving the attribute base instead
+    for (uint32_t first = 0; first < quadCount; first += maxQuads)
+    {
+        const uint32_t chunk = (quadCount - first < maxQuads) ? quadCount - first : maxQuads;
+
+        BindVertexBufferAttribs(buffer, 4 * first * buffer.Stride);
+        g_gfxContext.DrawIndexed(PrimitiveType::TriangleList, 6 * chunk, indexType);
+    }
+
+    BindVertexBufferAttribs(buffer);
 }
 
 inline void gfxSetWorldMatrix(const Matrix& mtx)
@@ -270,6 +655,11 @@ inline void gfxDisableDepthBufferTesting()
     g_gfxContext.DisableDepthBufferTesting();
 }
 
+inline void gfxSetBlendMode(const BlendMode& mode)
+{
+    g_gfxContext.SetBlendMode(mode);
+}
+
 inline void gfxCreateIndexBuffer(IndexBuffer& buffer)
 {
     CreateIndexBuffer(buffer);
@@ -285,13 +675,16 @@ inline void gfxBindIndexBuffer(const IndexBuffer& buffer)
     BindIndexBuffer(buffer);
 }
 
-inline void gfxCreateTexture2D(const char* path, Texture2D& texture, const bool filtered = true, const bool repeat = false)
+inline void gfxCreateTexture2D(const char* path, Texture2D& texture, const bool filtered = true, const bool repeat = false,
+                               const uint32_t flags = TextureImportNone)
 {
     Asset textureAsset = openAsset(path);
 
     if (textureAsset.IsOpen())
     {
-        CreateTexture2D(textureAsset, texture, filtered, repeat);
+        ScratchScope scratch(g_scratchArena);
+
+        CreateTexture2D(textureAsset, texture, filtered, repeat, flags, &g_textureUploads, getScratchAllocator());
         textureAsset.Close();
     } else {
         LogError("gfxError: Failed to open the texture asset file :: gfxCreateTexture2D()");
@@ -300,6 +693,7 @@ inline void gfxCreateTexture2D(const char* path, Texture2D& texture, const bool
 
 inline void gfxDestroyTexture2D(Texture2D& texture)
 {
+    CancelTextureUploads(g_textureUploads, texture);
     DestroyTexture2D(texture);
 }
 
@@ -308,9 +702,57 @@ inline void gfxBindTexture2D(const Texture2D& texture)
     BindTexture2D(texture);
 }
 
+// Shared by path and owned by the cache, pair every acquire with a release
+inline Texture2D* gfxAcquireTexture2D(const char* path, const bool filtered = true, const bool repeat = false,
+                                      const uint32_t flags = TextureImportNone)
+{
+    ScratchScope scratch(g_scratchArena);
+    return AcquireTexture(g_textureCache, path, filtered, repeat, flags, getScratchAllocator());
+}
+
+inline void gfxReleaseTexture2D(const Texture2D* texture)
+{
+    ReleaseTexture(g_textureCache, texture);
+}
+
+inline void gfxSetTextureBudget(const uint32_t bytes)
+{
+    SetTextureCacheBudget(g_textureCache, bytes);
+}
+
+inline const TextureCacheStats& gfxGetTextureCacheStats()
+{
+    return g_textureCache.Stats;
+}
+
+inline bool gfxIsTexture2DReady(const Texture2D& texture)
+{
+    return texture.IsReady;
+}
+
+inline void gfxSetTextureUploadBudget(const uint32_t bytesPerFrame, const uint32_t microsecondsPerFrame)
+{
+    g_textureUploads.BytesPerFrame = bytesPerFrame;
+    g_textureUploads.MicrosecondsPerFrame = microsecondsPerFrame;
+}
+
+inline const TextureUploadStats& gfxGetTextureUploadStats()
+{
+    return g_textureUploads.Stats;
+}
+
 inline void gfxSetWorkResolution(const Vec2& workRes)
 {
     g_workRes = workRes;
+
+    // Sprites live in work resolution units, so does the default camera
+    SetRenderQueueView(g_renderQueue, { 0.0f, workRes.X, workRes.Y, 0.0f });
+}
+
+// Visible area in work resolution units, submitted sprites outside of it are culled
+inline void gfxSetCameraRect(const ScreenRect& view)
+{
+    SetRenderQueueView(g_renderQueue, view);
 }
 
 inline Vec2 gfxGetWorkResolution()
@@ -328,7 +770,7 @@ inline Vec2 gfxGetWorkResScale()
 
 inline void gfxCreateSprite(Sprite& sprite, Texture2D& texture, const Vec2& position = { 0.0f, 0.0f })
 {
-    CreateSprite(sprite, g_shaderProgram, gfxGetWorkResScale(), texture, position);
+    CreateSprite(sprite, gfxGetWorkResScale(), texture, position);
 }
 
 inline void gfxDestroySprite(Sprite& sprite)
@@ -361,9 +803,261 @@ inline void gfxSpriteSetTexRect(Sprite& sprite, const Rect2D& texrect)
     SpriteSetTexRect(sprite, texrect);
 }
 
+inline void gfxSpriteSetMesh(Sprite& sprite, const SpriteMesh* mesh)
+{
+    SpriteSetMesh(sprite, mesh);
+}
+
+inline void gfxCreateSpriteMeshAtlas(const char* path, SpriteMeshAtlas& atlas)
+{
+    Asset meshAsset = openAsset(path);
+
+    if (meshAsset.IsOpen())
+    {
+        CreateSpriteMeshAtlas(meshAsset, atlas);
+        meshAsset.Close();
+    } else {
+        LogError("gfxError: Failed to open the sprite mesh asset file :: gfxCreateSpriteMeshAtlas()");
+    }
+}
+
+inline void gfxDestroySpriteMeshAtlas(SpriteMeshAtlas& atlas)
+{
+    DestroySpriteMeshAtlas(atlas);
+}
+
+// Reads the decoded copy the texture keeps, build the masks right after importing it
+inline void gfxCreateCollisionMaskAtlas(const Texture2D& texture, const Rect2D* regions, const uint32_t count,
+                                        CollisionMaskAtlas& atlas, const uint8_t alphaThreshold = g_defaultMaskAlphaThreshold)
+{
+    CreateCollisionMaskAtlas(texture, regions, count, atlas, alphaThreshold);
+}
+
+inline void gfxDestroyCollisionMaskAtlas(CollisionMaskAtlas& atlas)
+{
+    DestroyCollisionMaskAtlas(atlas);
+}
+
+inline void gfxCreateAnimationLibrary(const char* path, AnimationLibrary& library)
+{
+    Asset animationAsset = openAsset(path);
+
+    if (animationAsset.IsOpen())
+    {
+        ScratchScope scratch(g_scratchArena);
+
+        CreateAnimationLibrary(animationAsset, library, getScratchAllocator());
+        animationAsset.Close();
+    } else {
+        LogError("gfxError: Failed to open the animation asset file :: gfxCreateAnimationLibrary()");
+    }
+}
+
+inline void gfxDestroyAnimationLibrary(AnimationLibrary& library)
+{
+    DestroyAnimationLibrary(library);
+}
+
+inline uint32_t gfxFindAnimationClip(const AnimationLibrary& library, const char* name)
+{
+    return FindAnimationClip(library, name);
+}
+
+inline const SpriteMesh* gfxFindSpriteMesh(const SpriteMeshAtlas& atlas, const Rect2D& region)
+{
+    return FindSpriteMesh(atlas, region);
+}
+
 inline void gfxDrawSprite(Sprite& sprite)
 {
-    SpriteDraw(sprite, gfxGetWorkResScale());
+    SpriteDraw(sprite, g_spriteBatch, gfxGetWorkResScale());
+}
+
+// Drawn after Application::Update in sort key order, submission order only breaks ties
+inline void gfxSubmitSprite(Sprite& sprite, const uint32_t layer, const float depth = 0.0f, const bool translucent = true)
+{
+    const uint64_t key = MakeRenderSortKey(layer, translucent, g_shaderProgram, sprite.Texture->Id, depth);
+    RenderQueueSubmit(g_renderQueue, key, sprite);
+}
+
+// Seconds since the engine started, the time GPU sprite layers are evaluated at this frame
+inline float getEngineTime()
+{
+    return g_engineTime;
+}
+
+inline void DrawGpuSpriteLayerHook(void* user)
+{
+    DrawGpuSpriteLayer(*(GpuSpriteLayer*)user, g_projection * g_view * g_world, gfxGetWorkResScale(), g_engineTime);
+    glUseProgram(g_shaderProgram);
+}
+
+// Drawn by the render queue after the sprites of its layer, the pixel shader is shared with the sprite program
+inline void gfxCreateGpuSpriteLayer(GpuSpriteLayer& layer, const Texture2D& texture, const AnimationLibrary& animations,
+                                    const uint32_t renderLayer, const uint32_t capacity = g_maxGpuSprites)
+{
+    if (g_gpuSpriteProgram == 0)
+    {
+        Shader vertexShader;
+        gfxCompileShaderFromAsset("shaders/gpu_sprite_vertex_shader.glsl", ShaderType::VertexShader, vertexShader);
+
+        g_gpuSpriteProgram = glCreateProgram();
+
+        ScratchScope scratch(g_scratchArena);
+
+        if (!LinkShaderProgram(g_gpuSpriteProgram, vertexShader.Id, g_pixelShaderId, getScratchAllocator())) {
+            LogError("gfxError: GPU sprite program failed to link :: gfxCreateGpuSpriteLayer()");
+        }
+
+        glUseProgram(g_shaderProgram);
+    }
+
+    CreateGpuSpriteLayer(layer, g_gpuSpriteProgram, g_quadIndexBuffer, texture, animations, capacity);
+    AddRenderLayerHook(g_renderQueue, renderLayer, DrawGpuSpriteLayerHook, &layer);
+}
+
+inline void gfxDestroyGpuSpriteLayer(GpuSpriteLayer& layer)
+{
+    RemoveRenderLayerHook(g_renderQueue, &layer);
+    DestroyGpuSpriteLayer(layer);
+}
+
+// Clip ids are the ones of the library the layer was created with, the clip starts now unless told otherwise
+inline uint32_t gfxAddGpuSprite(GpuSpriteLayer& layer, const uint32_t clip, const Vec2& position, const Vec2& velocity,
+                                const Vec2& scale, const uint32_t color, const float startTime = g_engineTime)
+{
+    return AddGpuSprite(layer, clip, position, velocity, scale, color, startTime);
+}
+
+inline void gfxRemoveGpuSprite(GpuSpriteLayer& layer, const uint32_t sprite)
+{
+    RemoveGpuSprite(layer, sprite);
+}
+
+inline void gfxSetGpuSpriteClip(GpuSpriteLayer& layer, const uint32_t sprite, const uint32_t clip, const float startTime = g_engineTime)
+{
+    SetGpuSpriteClip(layer, sprite, clip, startTime);
+}
+
+inline void gfxSetGpuSpritePosition(GpuSpriteLayer& layer, const uint32_t sprite, const Vec2& position)
+{
+    SetGpuSpritePosition(layer, sprite, position);
+}
+
+inline void gfxSetGpuSpriteMotion(GpuSpriteLayer& layer, const uint32_t sprite, const Vec2& position, const Vec2& velocity)
+{
+    SetGpuSpriteMotion(layer, sprite, position, velocity, g_engineTime);
+}
+
+inline Vec2 gfxGetGpuSpritePosition(const GpuSpriteLayer& layer, const uint32_t sprite)
+{
+    return GetGpuSpritePosition(layer, sprite, g_engineTime);
+}
+
+inline void gfxSetGpuSpriteLayerTint(GpuSpriteLayer& layer, const uint32_t color)
+{
+    SetGpuSpriteLayerTint(layer, color);
+}
+
+inline Vec2 gfxGetGpuSpriteSize(const GpuSpriteLayer& layer, const uint32_t sprite)
+{
+    return GetGpuSpriteSize(layer, sprite, g_engineTime);
+}
+
+inline VertexBufferStats gfxGetGpuSpriteLayerStats(const GpuSpriteLayer& layer)
+{
+    return layer.Stream.Stats;
+}
+
+// Distance field pages should be imported filtered and without premultiplying, the alpha holds distances
+inline void gfxCreateBitmapFont(const char* path, const Texture2D& texture, BitmapFont& font)
+{
+    Asset fontAsset = openAsset(path);
+
+    if (fontAsset.IsOpen())
+    {
+        ScratchScope scratch(g_scratchArena);
+
+        CreateBitmapFont(fontAsset, texture, font, getScratchAllocator());
+        fontAsset.Close();
+    } else {
+        LogError("gfxError: Failed to open the font asset file :: gfxCreateBitmapFont()");
+        return;
+    }
+
+    // The distance field program shares the sprite vertex shader, linked the first time such a font shows up
+    if (font.DistanceSpread > 0.0f && g_distanceFieldText.Program == 0)
+    {
+        Shader pixelShader;
+        gfxCompileShaderFromAsset("shaders/sdf_text_pixel_shader.glsl", ShaderType::PixelShader, pixelShader);
+
+        const uint32_t program = glCreateProgram();
+
+        ScratchScope scratch(g_scratchArena);
+
+        if (!LinkShaderProgram(program, g_vertexShaderId, pixelShader.Id, getScratchAllocator())) {
+            LogError("gfxError: Distance field text program failed to link :: gfxCreateBitmapFont()");
+        }
+
+        CreateDistanceFieldRenderer(g_distanceFieldText, program, g_quadIndexBuffer);
+        glUseProgram(g_shaderProgram);
+    }
+}
+
+inline void gfxDestroyBitmapFont(BitmapFont& font)
+{
+    ForgetTextLayouts(g_textLayouts, font);
+    DestroyBitmapFont(font);
+}
+
+inline void DrawTextLayerHook(void* user)
+{
+    DistanceFieldRenderer* distanceField = (g_distanceFieldText.Program != 0) ? &g_distanceFieldText : nullptr;
+    FlushTextLayer(*(TextLayer*)user, g_spriteBatch, distanceField, g_projection * g_view * g_world);
+}
+
+// Text drawn into the layer during the update shows up after the sprites of that render layer
+inline void gfxCreateTextLayer(TextLayer& layer, const uint32_t renderLayer, const uint32_t capacity = g_maxTextLayerGlyphs)
+{
+    CreateTextLayer(layer, g_textLayouts, capacity);
+    AddRenderLayerHook(g_renderQueue, renderLayer, DrawTextLayerHook, &layer);
+}
+
+inline void gfxDestroyTextLayer(TextLayer& layer)
+{
+    RemoveRenderLayerHook(g_renderQueue, &layer);
+    DestroyTextLayer(layer);
+}
+
+// Immediate mode, call it every frame the text should be visible. Unchanged strings reuse their cached layout
+inline void gfxDrawText(TextLayer& layer, const TextStyle& style, const char* text, const Vec2& position)
+{
+    DrawText(layer, style, text, position, gfxGetWorkResScale());
+}
+
+inline Vec2 gfxMeasureText(const TextStyle& style, const char* text)
+{
+    return MeasureText(g_textLayouts, style, text);
+}
+
+inline const TextLayoutStats& gfxGetTextLayoutStats()
+{
+    return g_textLayouts.Stats;
+}
+
+inline const RenderQueueStats& gfxGetRenderQueueStats()
+{
+    return g_renderQueue.FrameStats;
+}
+
+inline void gfxFlushSprites()
+{
+    FlushSpriteBatch(g_spriteBatch);
+}
+
+inline SpriteBatchStats gfxGetSpriteBatchStats()
+{
+    return g_spriteBatch.FrameStats;
 }
 
 #endif // ENGINE_H
\ No newline at end of file
@@ -1,42 +1,24 @@
 #include "engine.h"
 
-#include <vector>
-
-typedef struct {
-    float Position[3];
-    float Color[4];
-    float TexCoord[2];
-} Vertex;
-
-typedef struct {
-    uint32_t Id;
-    Vec2 Position;
-    Vec2 Size;
-    Vec2 Scale;
-    Rect2D TexRect;
-    uint32_t Color;
-} BatchedSprite;
-
-typedef struct {
-    float FrameStep;
-    std::vector<Rect2D> Frames;
-} Animation;
-
-typedef struct {
-    uint32_t GlyphOffset;
-    uint32_t GlyphCount;
-    Rect2D BaseRect;
-    BatchedSprite* Glyphs;
-} BitmapText;
+#include <cfloat>
+
+typedef enum class RENDER_LAYER : uint32_t {
+    Background,
+    World,
+    Obstacles,      // GPU sprite layer only, between the ground and the dino
+    Player,
+    Interface
+} RenderLayer;
+
+typedef enum class COLLISION_LAYER : uint32_t {
+    Player   = 1 << 0,
+    Obstacle = 1 << 1,
+    Interface = 1 << 2
+} CollisionLayer;
 
 // Engine settings
-constexpr const uint32_t g_maxSprites = 50;
 const Vec2 g_gameWorkRes = { 1280.0f, 720.0f };
 
-// Buffer measures
-constexpr const uint32_t g_vertexBufferSize = 4 * g_maxSprites * sizeof(Vertex);
-constexpr const uint32_t g_indexBufferSize = 6 * g_maxSprites * sizeof(uint16_t);
-
 // Sprite scale
 constexpr const float g_commonScale = 1.5f;
 constexpr const float g_crexLogoScale = 4.0f;
@@ -54,7 +36,6 @@ constexpr const float g_cloudsDistance = 400.0f;
 constexpr const float g_cloudsSpeed = 200.0f;
 constexpr const float g_fadeStep = 0.7f;
 constexpr const float g_recoverTime = 0.2f;
-constexpr const float g_dinoCollisionThreshold = 0.9f;
 constexpr const float g_scoreStep = 0.1f;
 constexpr const float g_colorFadingDelay = 2.0f;
 
@@ -72,6 +53,7 @@ constexpr const uint32_t g_greyColor = 0x505050FF;
 constexpr const uint32_t g_maxClouds = 3;
 constexpr const uint32_t g_maxCactus = 4;
 constexpr const uint32_t g_scoreToFade = 100;
+constexpr const uint32_t g_scoreDigits = 5;
 
 // Vec2 constants
 const Vec2 g_touchHintPos = { 470.0f, 350.0f };
@@ -82,29 +64,25 @@ const Vec2 g_highScorePos = { 820.0f, 100.0f };
 const Vec2 g_highIndicatorPos = { 740.0f, 100.0f };
 const Vec2 g_moonPos = { 800.0f, 190.0f };
 
-const Rect2D g_cactusRect[] = {
-    { 447.0f, 3.0f, 30, 66 },   // Single small cactus
-    { 482.0f, 3.0f, 64, 66 },   // Double small cactus
-    { 654.0f, 3.0f, 46, 96 },   // Single big cactus
-    { 654.0f, 3.0f, 94, 96 },   // Double big cactus
-    { 654.0f, 3.0f,146, 96 },   // Triple big cactus
+const char* g_cactusClipNames[] = {
+    "cactus_0",     // Single small cactus
+    "cactus_1",     // Double small cactus
+    "cactus_2",     // Single big cactus
+    "cactus_3",     // Double big cactus
+    "cactus_4",     // Triple big cactus
 };
 
-uint32_t g_spriteId = 0;
 uint32_t g_clearColor = g_whiteColor;
 uint32_t g_objectsColor = g_greyColor;
 uint32_t g_touchHintAlpha = 255;
-uint32_t g_dinoAnimationIndex = 0;
-uint32_t g_pteroAnimationIndex = 0;
 uint32_t g_currentScore = 0;
 uint32_t g_highScore = 0;
 
 float g_objectsVelocity = 1.0f;
+float g_scrollSpeed = 0.0f;     // Speed the scrolling objects were last given, the ramp is applied when an obstacle respawns
 float g_gravity = 0.0f;
 float g_alphaTimer = 0.0f;
 float g_moveTimer = 0.0f;
-float g_dinoAnimationTimer = 0.0f;
-float g_pteroAnimationTimer = 0.0f;
 float g_respawnTimer = 0.0f;
 float g_scoreTimer = 0.0f;
 float g_colorFadeTimer = 0.0f;
@@ -121,62 +99,57 @@ bool g_isRespawning = false;
 bool g_isNightTime = false;
 bool g_isFadingTime = false;
 
-char g_scoreBuffer[5];
-char g_highScoreBuffer[5];
-
-Texture2D g_spritesTex;
-
-VertexBuffer g_spritesBuffer;
-IndexBuffer g_spritesIndexBuffer;
-
-Vertex* g_spritesVertices;
-uint16_t* g_spritesIndices;
-
-const uint32_t nIndices = g_indexBufferSize / sizeof(uint16_t);
-
-BatchedSprite dino;
-BatchedSprite ground;
-BatchedSprite clouds[g_maxClouds];
-BatchedSprite crexLogo;
-BatchedSprite developerInfo;
-BatchedSprite touchHint;
-BatchedSprite cactus[g_maxCactus];
-BatchedSprite gameOver;
-BatchedSprite retry;
-BatchedSprite highIndicator;
-BatchedSprite moon;
-BatchedSprite pterodactyl;
-
-Animation dinoIdle;
-Animation dinoRun;
-Animation dinoDuckRun;
-Animation dinoDied;
-
-Animation pterodactylAnim;
-
-BitmapText currentScore;
-BitmapText highScore;
-
-Animation* g_dinoAnimation = &dinoIdle;
-Animation* g_pteroAnimation = &pterodactylAnim;
+char g_scoreBuffer[g_scoreDigits + 1];
+char g_highScoreBuffer[g_scoreDigits + 1];
+
+Texture2D* g_spritesTex = nullptr;
+Texture2D* g_scoreFontTex = nullptr;
+SpriteMeshAtlas g_spriteMeshes;
+CollisionMaskAtlas g_collisionMasks;
+AnimationLibrary g_animations;
+BitmapFont g_scoreFont;
+TextLayer g_hudText;
+GpuSpriteLayer g_cloudSprites;
+GpuSpriteLayer g_obstacleSprites;
+
+EntityId dino;
+EntityId ground;
+EntityId clouds[g_maxClouds];
+EntityId crexLogo;
+EntityId developerInfo;
+EntityId touchHint;
+EntityId cactus[g_maxCactus];
+EntityId gameOver;
+EntityId retry;
+EntityId highIndicator;
+EntityId moon;
+EntityId pterodactyl;
+
+uint32_t dinoIdle;
+uint32_t dinoRun;
+uint32_t dinoDuckRun;
+uint32_t dinoDied;
+
+uint32_t pterodactylAnim;
+uint32_t pterodactylStill;
+uint32_t cloudClip;
+uint32_t cactusClips[sizeof(g_cactusClipNames) / sizeof(g_cactusClipNames[0])];
 
 void SetupSprites();
-void UpdateVertexData(const BatchedSprite& sprite);
-void SetupIndexData();
-void FlushBufferData();
-void SetupAnimations();
-void SetObjectAboveGround(BatchedSprite& object);
-void UpdateSpriteAnimation(BatchedSprite& sprite, const Animation& animation, float& timer, uint32_t& index);
+EntityId CreateSpriteEntity(const Rect2D& texRect, const Vec2& position, const Vec2& scale, const uint32_t color,
+                            const RenderLayer& layer, const float depth = 0.0f);
+EntityId CreateGpuSpriteEntity(GpuSpriteLayer& layer, const uint32_t clip, const Vec2& position, const Vec2& scale, const uint32_t color);
+void SetupCollisionMasks();
+void SetObjectAboveGround(const EntityId object);
+void SetRespawnBounds(const EntityId object);
+void PlaceObstacle(const EntityId object, const float positionX);
+void RespawnObject(const EntityId object);
+void SetScrollVelocity(const bool isScrolling);
+void SetScrollSpeed(const float speed);
+Vec2 GetScrollingVelocity(const EntityId object);
 uint32_t GenerateRandomNumRange(const uint32_t min, const uint32_t max);
-bool HasAABBCollided(const BatchedSprite& lhe, const BatchedSprite& rhe, const Vec2 lheRectThreshold = { 1.0f }, const Vec2 rheRectThreshold = { 1.0f });
-bool CheckTouchAgainstSprite(const BatchedSprite& sprite);
+bool CheckTouchAgainstSprite(const EntityId sprite);
 void RestartObjectsPosition();
-void Uint32ToStr(const uint32_t integer, char* buffer, const uint32_t size);
-void SetupBitmapText(BitmapText& text, const Vec2& position, const Vec2& scale, const uint32_t glyphCount, const Rect2D& base);
-void DestroyBitmapText(BitmapText& text);
-void SetBitmapTextString(BitmapText& text, const char* buffer, const uint32_t size);
-void SetBitmapTextVerticalPos(BitmapText& text, const float position);
-void SetBitmapTextVerticalColor(BitmapText& text, const uint32_t color);
 float Lerp(const float lhe, const float rhe, const float delta);
 bool IsTheBestDayOfTheWeek();   // Jessica's Easter Egg
 
@@ -185,13 +158,6 @@ void Application::Create()
     // Seed the RNG
     srand(time(0));
 
-    g_spritesVertices = new Vertex[4 * g_maxSprites];
-    g_spritesIndices = new uint16_t[6 * g_maxSprites];
-
-    // Clear the buffer data
-    memset(g_spritesVertices, 0, g_vertexBufferSize);
-    memset(g_spritesIndices, 0, g_indexBufferSize);
-
     gfxSetWorkResolution(g_gameWorkRes);  // 720p as default work resolution
     glViewport(0, 0, gfxGetDisplayWidth(), gfxGetDisplayHeight());
 
@@ -204,41 +170,48 @@ void Application::Create()
     gfxBindShader(vertexShader);
     gfxBindShader(pixelShader);
 
-    gfxCreateTexture2D("textures/game_sprites.png", g_spritesTex, false, true);
-    gfxBindTexture2D(g_spritesTex);
+    // Greyscale art tinted by vertex color, auto format picks luminance-alpha at half the memory
+    // Mips only pay off when the work resolution is minified onto a smaller panel
+    const Vec2 workResScale = gfxGetWorkResScale();
+    const uint32_t mipFlag = (workResScale.X < 1.0f || workResScale.Y < 1.0f) ? TextureImportMipmaps : TextureImportNone;
 
-    SetupSprites();
-    SetupAnimations();
+    g_spritesTex = gfxAcquireTexture2D("textures/game_sprites.qoi", false, true, TextureImportPremultiplyAlpha | TextureImportAutoFormat | mipFlag);
 
-    const Vec2 currentPos = { g_currentScorePos.X, -g_gameWorkRes.Y };
-    const Vec2 highPos    = { g_highScorePos.X, -g_gameWorkRes.Y };
-    const Rect2D baseRect = { 1293.0f, 2.0f, 20, 21 };
+    // Tight-fit polygons for the regions that have one, the rest are drawn as quads
+    gfxCreateSpriteMeshAtlas("textures/game_sprites.mesh", g_spriteMeshes);
+    setEntitySpriteMeshes(&g_spriteMeshes);
 
-    SetupBitmapText(currentScore, currentPos, { g_commonScale }, sizeof(g_scoreBuffer), baseRect);
-    SetupBitmapText(highScore, highPos, { g_commonScale }, sizeof(g_highScoreBuffer), baseRect);
+    // Clips are looked up by name once, the engine advances every animated sprite
+    gfxCreateAnimationLibrary("textures/game_sprites.anim", g_animations);
+    setEntityAnimations(&g_animations);
 
-    g_spritesBuffer.Stride = sizeof(Vertex);
-    g_spritesBuffer.Size   = g_vertexBufferSize;
-    g_spritesBuffer.Data   = (void*)g_spritesVertices;
+    dinoIdle         = gfxFindAnimationClip(g_animations, "dino_idle");
+    dinoRun          = gfxFindAnimationClip(g_animations, "dino_run");
+    dinoDuckRun      = gfxFindAnimationClip(g_animations, "dino_duck");
+    dinoDied         = gfxFindAnimationClip(g_animations, "dino_dead");
+    pterodactylAnim  = gfxFindAnimationClip(g_animations, "ptero");
+    pterodactylStill = gfxFindAnimationClip(g_animations, "ptero_still");
+    cloudClip        = gfxFindAnimationClip(g_animations, "cloud");
 
-    const VertexElement layout[] = {
-        VertexElement::Position,
-        VertexElement::Color,
-        VertexElement::TexCoord
-    }; const uint32_t nLayout = sizeof(layout) / sizeof(VertexElement);
+    for (uint32_t index = 0; index < sizeof(cactusClips) / sizeof(cactusClips[0]); ++index) {
+        cactusClips[index] = gfxFindAnimationClip(g_animations, g_cactusClipNames[index]);
+    }
 
-    gfxCreateVertexBuffer(layout, nLayout, g_spritesBuffer, true);
-    gfxBindVertexBuffer(g_spritesBuffer);
+    // Objects that only scroll are moved and animated by the vertex shader, they are uploaded when they respawn
+    gfxCreateGpuSpriteLayer(g_cloudSprites, *g_spritesTex, g_animations, (uint32_t)RenderLayer::Background, g_maxClouds);
+    gfxCreateGpuSpriteLayer(g_obstacleSprites, *g_spritesTex, g_animations, (uint32_t)RenderLayer::Obstacles, g_maxCactus + 1);
 
-    // Setup index data before binding it to the buffer
-    SetupIndexData();
-    
-    g_spritesIndexBuffer.Stride = sizeof(uint16_t);
-    g_spritesIndexBuffer.Size   = g_indexBufferSize;
-    g_spritesIndexBuffer.Data   = (void*)g_spritesIndices;
+    SetupSprites();
+    SetupCollisionMasks();
+
+    // Distance field digits at twice the art size, they stay sharp at any work resolution scale.
+    // Drawn on top of the interface sprites
+    g_scoreFontTex = gfxAcquireTexture2D("textures/score_font_sdf.qoi", true, false, TextureImportAutoFormat);
+    gfxCreateBitmapFont("textures/score_font_sdf.fnt", *g_scoreFontTex, g_scoreFont);
+    gfxCreateTextLayer(g_hudText, (uint32_t)RenderLayer::Interface);
 
-    gfxCreateIndexBuffer(g_spritesIndexBuffer);
-    gfxBindIndexBuffer(g_spritesIndexBuffer);
+    FormatUint32(g_scoreBuffer, sizeof(g_scoreBuffer), g_currentScore, g_scoreDigits);
+    FormatUint32(g_highScoreBuffer, sizeof(g_highScoreBuffer), g_highScore, g_scoreDigits);
 
     const Vec2 displayRes = { (float)gfxGetDisplayWidth(), (float)gfxGetDisplayHeight() };
     const ScreenRect projRect = { 0.0f, displayRes.X, displayRes.Y, 0.0f };
@@ -251,6 +224,14 @@ void Application::Create()
 
     // 2D rendering, disable depth test stage
     gfxDisableDepthBufferTesting();
+
+    // The sprite shader outputs premultiplied colors, transparent texels blend away instead of being discarded
+    gfxSetBlendMode(BlendMode::PremultipliedAlpha);
+
+    // Everything is loaded up front, the game loop is expected to run without touching the heap
+#if TRACK_ALLOCATIONS == 1
+    setAllocationSteadyState(true);
+#endif
 }
 
 void Application::Update(const float deltaTime)
@@ -260,14 +241,10 @@ void Application::Update(const float deltaTime)
 
     // Update timers
 
-    g_dinoAnimationTimer += deltaTime;
-    g_pteroAnimationTimer += deltaTime;
     g_alphaTimer += deltaTime;
     g_scoreTimer += deltaTime;
     g_colorFadeTimer = g_isFadingTime ? g_colorFadeTimer + deltaTime : 0.0f;
 
-    UpdateSpriteAnimation(dino, *g_dinoAnimation, g_dinoAnimationTimer, g_dinoAnimationIndex);
-
     if (g_isRespawning)
     {
         g_respawnTimer += deltaTime;
@@ -286,7 +263,7 @@ void Application::Update(const float deltaTime)
             g_gravity = -g_jumpForce;
             g_isJumping = true;
 
-            g_dinoAnimation = &dinoIdle;
+            playEntityAnimation(dino, dinoIdle);
         }
     }
 
@@ -295,10 +272,9 @@ void Application::Update(const float deltaTime)
     {
         if (!g_isJumping)
         {
-            g_dinoAnimation = &dinoDuckRun;
+            playEntityAnimation(dino, dinoDuckRun);
             g_isDucking = true;
 
-            UpdateSpriteAnimation(dino, *g_dinoAnimation, g_dinoAnimationTimer, g_dinoAnimationIndex);
             SetObjectAboveGround(dino);
         } else {
             g_jumpInfluence = 3.0f;
@@ -310,7 +286,7 @@ void Application::Update(const float deltaTime)
     {
         if (g_isDucking)
         {
-            g_dinoAnimation = &dinoRun;
+            playEntityAnimation(dino, dinoRun);
             g_isDucking = false;
         }
     }
@@ -318,7 +294,7 @@ void Application::Update(const float deltaTime)
     // Do that little horizontal padding after being in game (only happens once)
 
     if (g_isFirstMove) {
-        dino.Position.X += 50.0f * deltaTime;
+        getEntityPosition(dino).X += 50.0f * deltaTime;
         g_moveTimer += deltaTime;
     }
 
@@ -331,10 +307,10 @@ void Application::Update(const float deltaTime)
         if (!g_isPlaying && g_isInPauseScreen)
         {
             if (g_isFadingOut) {
-                touchHint.Position = { -g_gameWorkRes.X, 0.0f };
+                getEntityPosition(touchHint) = { -g_gameWorkRes.X, 0.0f };
                 g_isFadingOut = false;
             } else {
-                touchHint.Position = g_touchHintPos;
+                getEntityPosition(touchHint) = g_touchHintPos;
                 g_isFadingOut = true;
             }
         }
@@ -348,17 +324,15 @@ void Application::Update(const float deltaTime)
 
     // Apply the force
     if (!g_isDinoDead) {
-        dino.Position.Y += g_gravity * deltaTime;
+        getEntityPosition(dino).Y += g_gravity * deltaTime;
     }
 
     // Animate things when playing
 
     if (g_isPlaying && !g_isFirstMove)
     {
-        UpdateSpriteAnimation(pterodactyl, *g_pteroAnimation, g_pteroAnimationTimer, g_pteroAnimationIndex);
-
         if (g_isJumping) {
-            g_dinoAnimation = &dinoIdle;
+            playEntityAnimation(dino, dinoIdle);
         }
 
         if (g_scoreTimer > g_scoreStep)
@@ -369,8 +343,7 @@ void Application::Update(const float deltaTime)
                 g_currentScore = 99999;
             }
 
-            Uint32ToStr(g_currentScore, g_scoreBuffer, sizeof(g_scoreBuffer));
-            SetBitmapTextString(currentScore, g_scoreBuffer, sizeof(g_scoreBuffer));
+            FormatUint32(g_scoreBuffer, sizeof(g_scoreBuffer), g_currentScore, g_scoreDigits);
 
             g_scoreTimer = 0.0f;
         }
@@ -412,28 +385,13 @@ void Application::Update(const float deltaTime)
             }
         }
 
-        // Scroll the ground infinitely
-        ground.Position.X -= g_objectsSpeed * g_objectsVelocity * deltaTime;
-
-        // Scroll the clouds
-        for (uint32_t index = 0; index < g_maxClouds; ++index)
-        {
-            // Move
-            BatchedSprite* actualCloud = &clouds[index];
-            actualCloud->Position.X -= g_cloudsSpeed * deltaTime;
-        }
-
-        // Scroll the cactus
-        for (uint32_t index = 0; index < g_maxCactus; ++index) {
-            cactus[index].Position.X -= g_objectsSpeed * g_objectsVelocity * deltaTime;
-        }
-
-        // Scroll the pterodactyl
-        pterodactyl.Position.X -= g_objectsSpeed * (g_objectsVelocity + 0.15f) * deltaTime;
     }
 
+    // Moved by the engine at the start of the next frame
+    SetScrollVelocity(g_isPlaying && !g_isFirstMove);
+
     // Check ground collision
-    if (dino.Position.Y + (dino.Size.Y * dino.Scale.Y) > ground.Position.Y + (ground.Size.Y * ground.Scale.Y))
+    if (getEntityPosition(dino).Y + getEntitySize(dino).Y > getEntityPosition(ground).Y + getEntitySize(ground).Y)
     {
         g_jumpInfluence = 1.0f;
         SetObjectAboveGround(dino);
@@ -441,96 +399,78 @@ void Application::Update(const float deltaTime)
         if (!g_isPlaying && g_isJumping)
         {
             // Hide main menu title's
-            touchHint.Position     = { -g_gameWorkRes.X, 0.0f };
-            crexLogo.Position      = { -g_gameWorkRes.X, 0.0f };
-            developerInfo.Position = { -g_gameWorkRes.X, 0.0f };
-            highIndicator.Position = g_highIndicatorPos;
-
-            SetBitmapTextVerticalPos(currentScore, g_currentScorePos.Y);
-            SetBitmapTextVerticalPos(highScore, g_highScorePos.Y);
+            getEntityPosition(touchHint)     = { -g_gameWorkRes.X, 0.0f };
+            getEntityPosition(crexLogo)      = { -g_gameWorkRes.X, 0.0f };
+            getEntityPosition(developerInfo) = { -g_gameWorkRes.X, 0.0f };
+            getEntityPosition(highIndicator) = g_highIndicatorPos;
 
             g_isFirstMove = true;
             g_isPlaying = true;
 
-            g_dinoAnimation = &dinoRun;
+            playEntityAnimation(dino, dinoRun);
             g_isInPauseScreen = false;
 
             g_scoreTimer = 0.0f;
         }
 
         if (g_isPlaying && !g_isFirstMove && !g_isDucking) {
-            g_dinoAnimation = &dinoRun;
+            playEntityAnimation(dino, dinoRun);
         }
 
         g_isJumping = false;
     }
 
-    if (ground.Position.X < -((ground.Size.X * ground.Scale.X) / 2.0f)) {
-        ground.Position.X = 0.0f;
-    }
+    // Objects that scrolled past the left border, the ground wraps around by itself
 
-    for (uint32_t index = 0; index < g_maxClouds; ++index)
-    {
-        BatchedSprite* actualCloud = &clouds[index];
+    uint32_t eventCount;
+    const KinematicsEvent* events = getKinematicsEvents(eventCount);
 
-        // Check collision with the left-most border
-        if (actualCloud->Position.X < -(actualCloud->Size.X * actualCloud->Scale.X))
-        {
-            // Randomly regenerate the Y position of the cloud
-            const float cloudsRangeY = (float)GenerateRandomNumRange(g_cloudsMaxUpRange, g_cloudsMaxDownRange);
-            actualCloud->Position = { g_gameWorkRes.X, cloudsRangeY };
+    bool hasRespawned = false;
+
+    for (uint32_t index = 0; index < eventCount; ++index)
+    {
+        if (events[index].Mode == BoundsMode::Respawn) {
+            RespawnObject(events[index].Entity);
+            hasRespawned = true;
         }
+    }
 
-        UpdateVertexData(clouds[index]);
+    // The speed ramp catches up here instead of re-uploading every mover each score step
+    if (hasRespawned && g_scrollSpeed > 0.0f) {
+        SetScrollSpeed(g_objectsSpeed * g_objectsVelocity);
     }
 
-    // Check objects collision
+    // Check objects collision, the dino moved this update so its box is tested against every obstacle
+    // and the ones it overlaps are refined with the pixel masks
 
-    for (uint32_t index = 0; index < g_maxCactus; ++index)
-    {
-        if (cactus[index].Position.X < -(cactus[index].Size.X * cactus[index].Scale.X))
-        {
-            const uint32_t cactusRect = GenerateRandomNumRange(0, 4);
-            const float offset = 0.1f * GenerateRandomNumRange(7, 11);
+    Vec2 dinoPos, dinoSize;
+    getEntityCollider(dino, dinoPos, dinoSize);
 
-            cactus[index].TexRect    = g_cactusRect[cactusRect];
-            cactus[index].Size       = { (float)cactus[index].TexRect.Width, (float)cactus[index].TexRect.Height };
-            cactus[index].Position.X = (g_gameWorkRes.X + 200.0f) * g_maxCactus;// * offset;
+    const ScreenRect dinoBox = { dinoPos.X, dinoPos.X + dinoSize.X, dinoPos.Y + dinoSize.Y, dinoPos.Y };
 
-            SetObjectAboveGround(cactus[index]);
-        }
+    EntityId obstacles[g_maxCactus + 1];
+    const uint32_t obstacleCount = overlapEntities(dinoBox, (uint32_t)CollisionLayer::Obstacle, obstacles, g_maxCactus + 1);
 
-        if (HasAABBCollided(dino, cactus[index], { g_dinoCollisionThreshold })) {
+    for (uint32_t index = 0; index < obstacleCount; ++index)
+    {
+        if (testEntityMasks(dino, obstacles[index])) {
             g_isPlaying = false;
             g_isDinoDead = true;
         }
-
-        cactus[index].Color = g_objectsColor;
-        UpdateVertexData(cactus[index]);
-    }
-
-    if (pterodactyl.Position.X < -(pterodactyl.Size.X * pterodactyl.Scale.X)) {
-        pterodactyl.Position.X = g_gameWorkRes.X * (float)GenerateRandomNumRange(2, 6);
-    }
-
-    if (HasAABBCollided(dino, pterodactyl, { 0.9f, 0.8f }, { 0.5f, 0.9f })) {
-        g_isPlaying = false;
-        g_isDinoDead = true;
     }
 
     // Ded :P
 
     if (g_isDinoDead)
     {
-        g_dinoAnimation = &dinoDied;
+        playEntityAnimation(dino, dinoDied);
 
         // Update high score
         if (g_currentScore > g_highScore)
         {
             g_highScore = g_currentScore;
 
-            Uint32ToStr(g_highScore, g_highScoreBuffer, sizeof(g_highScoreBuffer));
-            SetBitmapTextString(highScore, g_highScoreBuffer, sizeof(g_highScoreBuffer));
+            FormatUint32(g_highScoreBuffer, sizeof(g_highScoreBuffer), g_highScore, g_scoreDigits);
         }
 
         if (CheckTouchAgainstSprite(retry))
@@ -558,437 +498,339 @@ void Application::Update(const float deltaTime)
     }
 
     // Show game_over and retry_button when dino is ded :P
-    gameOver.Position = g_isDinoDead ? g_gameOverPos : Vec2(-g_gameWorkRes.X, 0.0f);
-    retry.Position = g_isDinoDead ? g_retryButtonPos : Vec2(-g_gameWorkRes.X, 0.0f);
+    getEntityPosition(gameOver) = g_isDinoDead ? g_gameOverPos : Vec2(-g_gameWorkRes.X, 0.0f);
+    getEntityPosition(retry) = g_isDinoDead ? g_retryButtonPos : Vec2(-g_gameWorkRes.X, 0.0f);
 
     // Update object colors
 
-    dino.Color = g_objectsColor;
-    ground.Color = g_objectsColor;
-    gameOver.Color = g_objectsColor;
-    retry.Color = g_objectsColor;
-    highIndicator.Color = g_objectsColor;
-    pterodactyl.Color = g_objectsColor;
-
-    SetBitmapTextVerticalColor(currentScore, g_objectsColor);
-    SetBitmapTextVerticalColor(highScore, g_objectsColor);
-
-    // Update dynamic buffer data changes
-    UpdateVertexData(touchHint);
-    UpdateVertexData(dino);
-    UpdateVertexData(ground);
-    UpdateVertexData(crexLogo);
-    UpdateVertexData(developerInfo);
-    UpdateVertexData(gameOver);
-    UpdateVertexData(retry);
-    UpdateVertexData(highIndicator);
-    UpdateVertexData(moon);
-    UpdateVertexData(pterodactyl);
-
-    // Flush ModelViewProj and map updated dynamic buffer data
-    FlushBufferData();
-    gfxFlushMVPMatrix();
+    setEntityColor(dino, g_objectsColor);
+    setEntityColor(ground, g_objectsColor);
+    setEntityColor(gameOver, g_objectsColor);
+    setEntityColor(retry, g_objectsColor);
+    setEntityColor(highIndicator, g_objectsColor);
+
+    gfxSetGpuSpriteLayerTint(g_obstacleSprites, g_objectsColor);
+
+    // Scores show up once the first run started, the layouts are cached until the digits change
+    if (!g_isInPauseScreen)
+    {
+        const TextStyle scoreStyle = { &g_scoreFont, { g_commonScale * 0.5f }, g_objectsColor, TextAlign::Left, 0.0f,
+                                       0.0f, 0, { 0.0f, 0.0f }, 0 };
 
+        gfxDrawText(g_hudText, scoreStyle, g_scoreBuffer, g_currentScorePos);
+        gfxDrawText(g_hudText, scoreStyle, g_highScoreBuffer, g_highScorePos);
+    }
+
+    gfxFlushMVPMatrix();
     gfxClearBackBuffer(g_clearColor);
-    gfxDrawIndexed(nIndices);
 }
 
 void Application::Destroy()
 {
-    gfxDestroyTexture2D(g_spritesTex);
+    gfxDestroyTextLayer(g_hudText);
+    gfxDestroyBitmapFont(g_scoreFont);
+    gfxReleaseTexture2D(g_scoreFontTex);
+
+    gfxDestroyGpuSpriteLayer(g_obstacleSprites);
+    gfxDestroyGpuSpriteLayer(g_cloudSprites);
 
-    gfxDestroyIndexBuffer(g_spritesIndexBuffer);
-    gfxDestroyVertexBuffer(g_spritesBuffer);
+    setEntityCollisionMasks(nullptr);
+    gfxDestroyCollisionMaskAtlas(g_collisionMasks);
 
-    DestroyBitmapText(currentScore);
+    // The animators live until the store is destroyed, they stop reading clips once the library is unset
+    setEntityAnimations(nullptr);
+    gfxDestroyAnimationLibrary(g_animations);
 
-    // After GPU unbind buffer data, make sure to deallocate the used heap memory
-    delete[] g_spritesIndices;
-    delete[] g_spritesVertices;
+    setEntitySpriteMeshes(nullptr);
+    gfxDestroySpriteMeshAtlas(g_spriteMeshes);
+    gfxReleaseTexture2D(g_spritesTex);
 }
 
 void SetupSprites()
 {
+    // Sprites are drawn by the engine every frame, depth orders them inside their layer (0 is the front)
+
     // Moon
 
-    moon.Id       = g_spriteId++;
-    moon.Scale    = { g_commonScale };
-    moon.TexRect  = { 1154.0f, 2.0f, 40, 80 };
-    moon.Size     = { (float)moon.TexRect.Width, (float)moon.TexRect.Height };
-    moon.Position = g_moonPos;
-    moon.Color    = g_whiteColor;
+    moon = CreateSpriteEntity({ 1154.0f, 2.0f, 40, 80 }, g_moonPos, { g_commonScale }, g_whiteColor, RenderLayer::Background, 0.5f);
 
     // Clouds
 
     for (uint32_t index = 0; index < g_maxClouds; ++index)
     {
         const float maxCloudRangeY = (float)GenerateRandomNumRange(g_cloudsMaxUpRange, g_cloudsMaxDownRange);
+        const Vec2 cloudPos = { g_gameWorkRes.X + (index * g_cloudsDistance), maxCloudRangeY };
 
-        clouds[index].Id       = g_spriteId++;
-        clouds[index].Scale    = { g_commonScale };
-        clouds[index].TexRect  = { 166.0f, 0.0f, 92, 29 };
-        clouds[index].Size     = { (float)clouds[index].TexRect.Width, (float)clouds[0].TexRect.Height };
-        clouds[index].Position = { g_gameWorkRes.X + (index * g_cloudsDistance), maxCloudRangeY };
-        clouds[index].Color    = g_objectsColor;
-
-        UpdateVertexData(clouds[index]);
+        clouds[index] = CreateGpuSpriteEntity(g_cloudSprites, cloudClip, cloudPos, { g_commonScale }, g_objectsColor);
+        SetRespawnBounds(clouds[index]);
     }
 
     // Dino
 
-    dino.Id       = g_spriteId++;
-    dino.Scale    = { g_commonScale };
-    dino.TexRect  = { 1680.0f, 4.0f, 81, 92 };
-    dino.Size     = { (float)dino.TexRect.Width, (float)dino.TexRect.Height };
-    dino.Color    = g_objectsColor;
-    dino.Position = { g_dinoPosX, 0.0f };
+    dino = CreateSpriteEntity({ 1680.0f, 4.0f, 81, 92 }, { g_dinoPosX, 0.0f }, { g_commonScale }, g_objectsColor, RenderLayer::Player);
+    addCollider(dino, { 0.0f, 0.0f }, { 1.0f, 1.0f }, (uint32_t)CollisionLayer::Player, (uint32_t)CollisionLayer::Obstacle);
+    addAnimator(dino, dinoIdle);
 
     // Ground
 
-    ground.Id       = g_spriteId++;
-    ground.Scale    = { g_commonScale };
-    ground.TexRect  = { 0.0f, 103.0f, 2446 * 2, 26 };
-    ground.Size     = { (float)ground.TexRect.Width, (float)ground.TexRect.Height };
-    ground.Position = { 0.0f, g_gameWorkRes.Y - (ground.Size.Y * ground.Scale.Y) - 50.0f };
-    ground.Color    = g_objectsColor;
+    const Rect2D groundRect = { 0.0f, 103.0f, 2446 * 2, 26 };
+    const Vec2 groundPos = { 0.0f, g_gameWorkRes.Y - (groundRect.Height * g_commonScale) - 50.0f };
+
+    ground = CreateSpriteEntity(groundRect, groundPos, { g_commonScale }, g_objectsColor, RenderLayer::World, 0.75f);
+
+    // The texture holds the ground twice, jumping back by half of it is seamless
+    const float groundHalfWidth = getEntitySize(ground).X / 2.0f;
+
+    addVelocity(ground, { 0.0f, 0.0f });
+    setEntityBounds(ground, { -groundHalfWidth, -FLT_MAX }, { FLT_MAX, FLT_MAX }, BoundsMode::Wrap, { groundHalfWidth, 0.0f });
 
     SetObjectAboveGround(dino);
 
     // C-Rex Logo
 
-    crexLogo.Id       = g_spriteId++;
-    crexLogo.Scale    = { g_crexLogoScale, g_crexLogoScale };
-    crexLogo.TexRect  = { 1293.0f, 58.0f, 178, 25 };
-    crexLogo.Size     = { (float)crexLogo.TexRect.Width, (float)crexLogo.TexRect.Height };
-    crexLogo.Position = { 295.0f, 100.0f };
-    crexLogo.Color    = g_whiteColor;
+    crexLogo = CreateSpriteEntity({ 1293.0f, 58.0f, 178, 25 }, { 295.0f, 100.0f }, { g_crexLogoScale }, g_whiteColor, RenderLayer::Interface);
 
     // Developer Info
 
-    developerInfo.Id       = g_spriteId++;
-    developerInfo.Scale    = { g_developerInfoScale, g_developerInfoScale };
-    developerInfo.TexRect  = { 1487.0f, 54.0f, 178, 11 };
-    developerInfo.Size     = { (float)developerInfo.TexRect.Width, (float)developerInfo.TexRect.Height };
-    developerInfo.Color    = g_whiteColor;
+    developerInfo = CreateSpriteEntity({ 1487.0f, 54.0f, 178, 11 }, { 0.0f, 0.0f }, { g_developerInfoScale }, g_whiteColor, RenderLayer::Interface);
 
-    const float developerInfoX = g_gameWorkRes.X - (developerInfo.Size.X * developerInfo.Scale.X) - 15.0f;
-    const float developerInfoY = g_gameWorkRes.Y - (developerInfo.Size.Y * developerInfo.Scale.Y) - 15.0f;
+    const float developerInfoX = g_gameWorkRes.X - getEntitySize(developerInfo).X - 15.0f;
+    const float developerInfoY = g_gameWorkRes.Y - getEntitySize(developerInfo).Y - 15.0f;
 
-    developerInfo.Position = { developerInfoX, developerInfoY };
+    getEntityPosition(developerInfo) = { developerInfoX, developerInfoY };
 
     // Touch Hint
 
-    touchHint.Id       = g_spriteId++;
-    touchHint.Scale    = { g_touchHintScale, g_touchHintScale };
-    touchHint.TexRect  = { 1487.0f, 69.0f, 123, 11 };
-    touchHint.Size     = { (float)touchHint.TexRect.Width, (float)touchHint.TexRect.Height };
-    touchHint.Position = g_touchHintPos;
-    touchHint.Color    = g_whiteColor;
+    touchHint = CreateSpriteEntity({ 1487.0f, 69.0f, 123, 11 }, g_touchHintPos, { g_touchHintScale }, g_whiteColor, RenderLayer::Interface);
 
     // Cactus
 
     for (uint32_t index = 0; index < g_maxCactus; ++index)
     {
-        const uint32_t cactusRect = GenerateRandomNumRange(0, 4);
-        const float offset = 0.1f * GenerateRandomNumRange(7, 11);
-
-        cactus[index].Id       = g_spriteId++;
-        cactus[index].Scale    = { g_commonScale };
-        cactus[index].TexRect  = g_cactusRect[cactusRect];
-        cactus[index].Size     = { (float)cactus[index].TexRect.Width, (float)cactus[index].TexRect.Height };
-        cactus[index].Position = { (g_gameWorkRes.X + 200.0f) * (index + 1), 0.0f };
-        cactus[index].Color    = g_objectsColor;
-
-        SetObjectAboveGround(cactus[index]);
-        UpdateVertexData(cactus[index]);
+        const uint32_t cactusClip = cactusClips[GenerateRandomNumRange(0, 4)];
+
+        // Tinted by the layer, the quads keep their color
+        cactus[index] = CreateGpuSpriteEntity(g_obstacleSprites, cactusClip, { 0.0f, 0.0f }, { g_commonScale }, g_whiteColor);
+        addCollider(cactus[index], { 0.0f, 0.0f }, { 1.0f, 1.0f }, (uint32_t)CollisionLayer::Obstacle, (uint32_t)CollisionLayer::Player);
+
+        SetRespawnBounds(cactus[index]);
+        PlaceObstacle(cactus[index], (g_gameWorkRes.X + 200.0f) * (index + 1));
     }
 
     // Game Over
 
-    gameOver.Id       = g_spriteId++;
-    gameOver.Scale    = { g_commonScale };
-    gameOver.TexRect  = { 1293.0f, 28.0f, 381, 21 };
-    gameOver.Size     = { (float)gameOver.TexRect.Width, (float)gameOver.TexRect.Height };
-    gameOver.Position = { -g_gameWorkRes.X, 0.0f };
-    gameOver.Color    = g_objectsColor;
+    gameOver = CreateSpriteEntity({ 1293.0f, 28.0f, 381, 21 }, { -g_gameWorkRes.X, 0.0f }, { g_commonScale }, g_objectsColor, RenderLayer::Interface);
 
     // Retry button
 
-    retry.Id       = g_spriteId++;
-    retry.Scale    = { g_commonScale };
-    retry.TexRect  = { 3.0f, 3.0f, 68, 60 };
-    retry.Size     = { (float)retry.TexRect.Width, (float)retry.TexRect.Height };
-    retry.Position = { -g_gameWorkRes.X, 0.0f };
-    retry.Color    = g_objectsColor;
+    retry = CreateSpriteEntity({ 3.0f, 3.0f, 68, 60 }, { -g_gameWorkRes.X, 0.0f }, { g_commonScale }, g_objectsColor, RenderLayer::Interface);
+    addCollider(retry, { 0.0f, 0.0f }, { 1.0f, 1.0f }, (uint32_t)CollisionLayer::Interface, 0);
 
     // High Score Indicator
 
-    highIndicator.Id       = g_spriteId++;
-    highIndicator.Scale    = { g_scoreIndicatorScale };
-    highIndicator.TexRect  = { 1494.0f, 2.0f, 38, 21 };
-    highIndicator.Size     = { (float)highIndicator.TexRect.Width, (float)highIndicator.TexRect.Height };
-    highIndicator.Position = { g_highIndicatorPos.X, -g_gameWorkRes.Y };
-    highIndicator.Color    = g_objectsColor;
+    const Vec2 highIndicatorPos = { g_highIndicatorPos.X, -g_gameWorkRes.Y };
+    highIndicator = CreateSpriteEntity({ 1494.0f, 2.0f, 38, 21 }, highIndicatorPos, { g_scoreIndicatorScale }, g_objectsColor, RenderLayer::Interface);
 
-    // High Score Indicator
+    // Pterodactyl
+
+    const Vec2 pterodactylPos = { g_gameWorkRes.X * (float)GenerateRandomNumRange(2, 6), 470.0f };
 
-    pterodactyl.Id       = g_spriteId++;
-    pterodactyl.Scale    = { g_commonScale };
-    pterodactyl.TexRect  = { 264.0f, 6.0f, 84, 72 };
-    pterodactyl.Size     = { (float)pterodactyl.TexRect.Width, (float)pterodactyl.TexRect.Height };
-    pterodactyl.Position = { g_gameWorkRes.X * (float)GenerateRandomNumRange(2, 6), 470.0f };
-    pterodactyl.Color    = g_objectsColor;
-
-    UpdateVertexData(dino);
-    UpdateVertexData(ground);
-    UpdateVertexData(crexLogo);
-    UpdateVertexData(developerInfo);
-    UpdateVertexData(touchHint);
-    UpdateVertexData(gameOver);
-    UpdateVertexData(retry);
-    UpdateVertexData(highIndicator);
-    UpdateVertexData(moon);
-    UpdateVertexData(pterodactyl);
+    pterodactyl = CreateGpuSpriteEntity(g_obstacleSprites, pterodactylStill, pterodactylPos, { g_commonScale }, g_whiteColor);
+    addCollider(pterodactyl, { 0.0f, 0.0f }, { 1.0f, 1.0f }, (uint32_t)CollisionLayer::Obstacle, (uint32_t)CollisionLayer::Player);
+
+    SetRespawnBounds(pterodactyl);
 }
 
-void UpdateVertexData(const BatchedSprite& sprite)
+EntityId CreateSpriteEntity(const Rect2D& texRect, const Vec2& position, const Vec2& scale, const uint32_t color,
+                            const RenderLayer& layer, const float depth)
 {
-    const Vec2 workResScale = gfxGetWorkResScale();
+    const EntityId entity = createEntity();
 
-    const float texWidth  = (float)g_spritesTex.Width;
-    const float texHeight = (float)g_spritesTex.Height;
+    addTransform(entity, position, scale);
+    addSprite(entity, *g_spritesTex, texRect, color, (uint32_t)layer, depth);
 
-    // Setup position and size based on the work resolution
-    // This is a personal design for me as it stands for "uniform resolution" in 2D rendering
+    return entity;
+}
 
-    const float posX = sprite.Position.X * workResScale.X;
-    const float posY = sprite.Position.Y * workResScale.Y;
-    const float posSizeX = (sprite.Position.X + sprite.Size.X * sprite.Scale.X) * workResScale.X;
-    const float posSizeY = (sprite.Position.Y + sprite.Size.Y * sprite.Scale.Y) * workResScale.Y;
+EntityId CreateGpuSpriteEntity(GpuSpriteLayer& layer, const uint32_t clip, const Vec2& position, const Vec2& scale, const uint32_t color)
+{
+    const EntityId entity = createEntity();
 
-    // Normalize texture coordinates
+    // Spawned standing still, SetScrollSpeed gives it its line
+    addTransform(entity, position, scale);
+    addGpuSprite(entity, layer, clip, { 0.0f, 0.0f }, color);
 
-    const float texWidthX  = sprite.TexRect.X / texWidth;
-    const float texHeightY = sprite.TexRect.Y / texHeight;
+    return entity;
+}
 
-    const float texWidthOffsetX  = (sprite.TexRect.X + sprite.TexRect.Width) / texWidth;
-    const float texHeightOffsetY = (sprite.TexRect.Y + sprite.TexRect.Height) / texHeight;
+void SetupCollisionMasks()
+{
+    // Every region the dino and the obstacles can show, the sprites' transparent margins no longer count as hits
+    ScratchScope scratch(getScratchArena());
+    const Allocator allocator = getScratchAllocator();
 
-    float r, g, b, a;
-    DwordToColorNormalized(sprite.Color, r, g, b, a);
+    Rect2D* regions = AllocateArray<Rect2D>(allocator, g_animations.FrameCount);
+    uint32_t regionCount = 0;
 
-    // Batch vertices by id
+    for (uint32_t index = 0; index < g_animations.FrameCount; ++index) {
+        regions[regionCount++] = g_animations.Frames[index].Region;
+    }
 
-    g_spritesVertices[ 4 * sprite.Id + 0 ] = { { posX    , posY    , 0.0f }, { r, g, b, a }, { texWidthX      , texHeightY       } };
-    g_spritesVertices[ 4 * sprite.Id + 1 ] = { { posSizeX, posSizeY, 0.0f }, { r, g, b, a }, { texWidthOffsetX, texHeightOffsetY } };
-    g_spritesVertices[ 4 * sprite.Id + 2 ] = { { posX    , posSizeY, 0.0f }, { r, g, b, a }, { texWidthX      , texHeightOffsetY } };
-    g_spritesVertices[ 4 * sprite.Id + 3 ] = { { posSizeX, posY    , 0.0f }, { r, g, b, a }, { texWidthOffsetX, texHeightY       } };
-}
+    gfxCreateCollisionMaskAtlas(*g_spritesTex, regions, regionCount, g_collisionMasks);
+    setEntityCollisionMasks(&g_collisionMasks);
 
-void SetupIndexData()
-{
-    for (uint32_t index = 0; index < g_maxSprites; ++index)
-    {
-        // Batch indices by id
-
-        g_spritesIndices[ 6 * index + 0 ] = 4 * index + 0;
-        g_spritesIndices[ 6 * index + 1 ] = 4 * index + 1;
-        g_spritesIndices[ 6 * index + 2 ] = 4 * index + 2;
-        g_spritesIndices[ 6 * index + 3 ] = 4 * index + 0;
-        g_spritesIndices[ 6 * index + 4 ] = 4 * index + 3;
-        g_spritesIndices[ 6 * index + 5 ] = 4 * index + 1;
-    }
+    FreeArray(allocator, regions);
 }
 
-void FlushBufferData()
+void SetObjectAboveGround(const EntityId object)
 {
-    gfxUpdateVertexBuffer(g_spritesVertices, g_vertexBufferSize, g_spritesBuffer);
+    const float groundBottom = getEntityPosition(ground).Y + getEntitySize(ground).Y;
+    const float objSize = getEntitySize(object).Y;
+
+    getEntityPosition(object).Y = groundBottom - objSize;
 }
 
-void SetupAnimations()
+void SetRespawnBounds(const EntityId object)
 {
-    // C-Rex Idle
-    dinoIdle.FrameStep = 1.0f;
-    dinoIdle.Frames.push_back({ 1680.0f, 5.0f, 81, 92 });
-
-    // C-Rex Running
-    dinoRun.FrameStep = 0.1f;
-    dinoRun.Frames.push_back({ 1857.0f, 5.0f, 80, 86 });
-    dinoRun.Frames.push_back({ 1945.0f, 5.0f, 80, 86 });
-
-    // C-Rex Duck Running
-    dinoDuckRun.FrameStep = 0.1f;
-    dinoDuckRun.Frames.push_back({ 2211.0f, 39.0f, 110, 52 });
-    dinoDuckRun.Frames.push_back({ 2329.0f, 39.0f, 110, 52 });
-
-    // C-Rex Dead
-    dinoDied.FrameStep = 1.0f;
-    dinoDied.Frames.push_back({ 2033.0f, 5.0f, 80, 86 });
-
-    // Pterodactyl default
-    pterodactylAnim.FrameStep = 0.1f;
-    pterodactylAnim.Frames.push_back({ 264.0f, 6.0f, 84, 72 });
-    pterodactylAnim.Frames.push_back({ 356.0f, 6.0f, 84, 72 });
+    // Reported once the whole sprite went past the left border
+    setEntityBounds(object, { -getEntitySize(object).X, -FLT_MAX }, { FLT_MAX, FLT_MAX }, BoundsMode::Respawn);
 }
 
-void SetObjectAboveGround(BatchedSprite& object)
+void PlaceObstacle(const EntityId object, const float positionX)
 {
-    const float groundBottom = ground.Position.Y + ground.Size.Y * ground.Scale.Y;
-    const float objSize = object.Size.Y * object.Scale.Y;
+    const float groundBottom = getEntityPosition(ground).Y + getEntitySize(ground).Y;
+    const Vec2 position = { positionX, groundBottom - getEntitySize(object).Y };
 
-    object.Position.Y = groundBottom - objSize;
+    setEntityMotion(object, position, GetScrollingVelocity(object));
 }
 
-void UpdateSpriteAnimation(BatchedSprite& sprite, const Animation& animation, float& timer, uint32_t& index)
+void RespawnObject(const EntityId object)
 {
-    if (timer > animation.FrameStep)
+    if (object == pterodactyl)
     {
-        timer = 0.0f;
-        ++index;
-    }
+        const Vec2 pterodactylPos = { g_gameWorkRes.X * (float)GenerateRandomNumRange(2, 6), getEntityPosition(pterodactyl).Y };
+        setEntityMotion(pterodactyl, pterodactylPos, GetScrollingVelocity(pterodactyl));
 
-    if (index > animation.Frames.size() - 1) {
-        index = 0;
+        return;
     }
 
-    sprite.TexRect = animation.Frames.at(index);
-    sprite.Size = { (float)sprite.TexRect.Width, (float)sprite.TexRect.Height };
-}
-
-uint32_t GenerateRandomNumRange(const uint32_t min, const uint32_t max)
-{
-    return min + (rand() % max);
-}
+    for (uint32_t index = 0; index < g_maxClouds; ++index)
+    {
+        if (object == clouds[index])
+        {
+            // Randomly regenerate the Y position of the cloud
+            const float cloudsRangeY = (float)GenerateRandomNumRange(g_cloudsMaxUpRange, g_cloudsMaxDownRange);
+            setEntityMotion(object, { g_gameWorkRes.X, cloudsRangeY }, GetScrollingVelocity(object));
 
-bool HasAABBCollided(const BatchedSprite& lhe, const BatchedSprite& rhe, const Vec2 lheRectThreshold, const Vec2 rheRectThreshold)
-{
-    const Vec2 pos1 = lhe.Position;
-    const Vec2 pos2 = rhe.Position;
-    const Vec2 size1 = Vec2(lhe.Size.X * lhe.Scale.X, lhe.Size.Y * lhe.Scale.Y) * lheRectThreshold;
-    const Vec2 size2 = Vec2(rhe.Size.X * rhe.Scale.X, rhe.Size.Y * rhe.Scale.Y) * rheRectThreshold;
+            return;
+        }
+    }
 
-    if (pos1.X < pos2.X + size2.X && pos1.X + size1.X > pos2.X &&	// Horizontal check
-        pos1.Y < pos2.Y + size2.Y && pos1.Y + size1.Y > pos2.Y)		// Vertical check
+    for (uint32_t index = 0; index < g_maxCactus; ++index)
     {
-        return true;
-    }
+        if (object == cactus[index])
+        {
+            setEntityGpuClip(object, cactusClips[GenerateRandomNumRange(0, 4)]);
 
-    return false;
+            // Cactus come in different widths
+            SetRespawnBounds(object);
+            PlaceObstacle(object, (g_gameWorkRes.X + 200.0f) * g_maxCactus);
+
+            return;
+        }
+    }
 }
 
-bool CheckTouchAgainstSprite(const BatchedSprite& sprite)
+void SetScrollVelocity(const bool isScrolling)
 {
-    const TouchScreenId id = TouchScreenId::Touch;
-
-    const float touchX = getTouchScreenX(id) * g_gameWorkRes.X;
-    const float touchY = getTouchScreenY(id) * g_gameWorkRes.Y;
-
-    // Same as AABB collision, but with touchscreen props
-
-    const Vec2 pos1 = sprite.Position;
-    const Vec2 pos2 = { touchX, touchY };
-    const Vec2 size1 = { sprite.Size.X * sprite.Scale.X, sprite.Size.Y * sprite.Scale.Y };
-    const Vec2 size2 = { 1.0f, 1.0f };
-
-    if (pos1.X < pos2.X + size2.X && pos1.X + size1.X > pos2.X &&	// Horizontal check
-        pos1.Y < pos2.Y + size2.Y && pos1.Y + size1.Y > pos2.Y)		// Vertical check
-    {
-        return true;
+    // Every GPU mover gets a new line when the speed changes, so only starting and stopping do it here
+    if (isScrolling != (g_scrollSpeed > 0.0f)) {
+        SetScrollSpeed(isScrolling ? g_objectsSpeed * g_objectsVelocity : 0.0f);
     }
-
-    return false;
 }
 
-void RestartObjectsPosition()
+void SetScrollSpeed(const float speed)
 {
-    SetObjectAboveGround(dino);
+    const bool wasScrolling = g_scrollSpeed > 0.0f;
+    g_scrollSpeed = speed;
 
-    for (uint32_t index = 0; index < g_maxCactus; ++index)
-    {
-        const float offset = 0.1f * GenerateRandomNumRange(7, 11);
-        cactus[index].Position.X = (g_gameWorkRes.X + 200.0f) * (index + 1);// * offset;
-    }
+    getEntityVelocity(ground).X = -speed;
 
-    pterodactyl.Position.X = g_gameWorkRes.X * (float)GenerateRandomNumRange(2, 6);
-}
+    for (uint32_t index = 0; index < g_maxClouds; ++index) {
+        setEntityMotion(clouds[index], getEntityPosition(clouds[index]), GetScrollingVelocity(clouds[index]));
+    }
 
-void Uint32ToStr(const uint32_t integer, char* buffer, const uint32_t size)
-{
-    // Max size of 99 char's array in this project
-    if (size > 99) {
-        return;
+    for (uint32_t index = 0; index < g_maxCactus; ++index) {
+        setEntityMotion(cactus[index], getEntityPosition(cactus[index]), GetScrollingVelocity(cactus[index]));
     }
 
-    char format[6];
-    sprintf(format, "%s%d%s", "%0", size, "d");
+    setEntityMotion(pterodactyl, getEntityPosition(pterodactyl), GetScrollingVelocity(pterodactyl));
 
-    sprintf(buffer, format, integer);
+    // The wings rest while the game is paused
+    if (wasScrolling != (speed > 0.0f)) {
+        setEntityGpuClip(pterodactyl, (speed > 0.0f) ? pterodactylAnim : pterodactylStill);
+    }
 }
 
-void SetupBitmapText(BitmapText& text, const Vec2& position, const Vec2& scale, const uint32_t glyphCount, const Rect2D& base)
+Vec2 GetScrollingVelocity(const EntityId object)
 {
-    text.GlyphCount  = glyphCount;
-    text.GlyphOffset = base.Width;
-    text.BaseRect    = base;
+    if (g_scrollSpeed <= 0.0f) {
+        return { 0.0f, 0.0f };
+    }
 
-    text.Glyphs = new BatchedSprite[glyphCount];
+    // The pterodactyl flies towards the dino a bit faster than the ground scrolls
+    if (object == pterodactyl) {
+        return { -(g_scrollSpeed + g_objectsSpeed * 0.15f), 0.0f };
+    }
 
-    for (uint32_t index = 0; index < glyphCount; ++index)
+    for (uint32_t index = 0; index < g_maxClouds; ++index)
     {
-        const Vec2 finalPos = { position.X + ((base.Width * scale.X) * index), position.Y };
-
-        text.Glyphs[index].Id       = g_spriteId++;
-        text.Glyphs[index].Position = finalPos;
-        text.Glyphs[index].TexRect  = base;
-        text.Glyphs[index].Scale    = scale;
-        text.Glyphs[index].Size     = { (float)base.Width, (float)base.Height };
-        text.Glyphs[index].Color    = g_objectsColor;
-
-        UpdateVertexData(text.Glyphs[index]);
+        if (object == clouds[index]) {
+            return { -g_cloudsSpeed, 0.0f };
+        }
     }
+
+    return { -g_scrollSpeed, 0.0f };
 }
 
-void DestroyBitmapText(BitmapText& text)
+uint32_t GenerateRandomNumRange(const uint32_t min, const uint32_t max)
 {
-    text.GlyphCount = 0;
-    text.GlyphOffset = 0;
-
-    delete[] text.Glyphs;
+    return min + (rand() % max);
 }
 
-void SetBitmapTextString(BitmapText& text, const char* buffer, const uint32_t size)
+bool CheckTouchAgainstSprite(const EntityId sprite)
 {
-    if (size > text.GlyphCount) {
-        return;
-    }
+    const TouchScreenId id = TouchScreenId::Touch;
 
-    for (uint32_t index = 0; index < size; ++index)
-    {
-        int32_t number = (int32_t)buffer[index] - '0';
+    const float touchX = getTouchScreenX(id) * g_gameWorkRes.X;
+    const float touchY = getTouchScreenY(id) * g_gameWorkRes.Y;
 
-        if (number < 0 || number > 9) {
-            continue;
-        }
+    // A one unit box under the finger against the interface colliders
+    const ScreenRect touchBox = { touchX, touchX + 1.0f, touchY + 1.0f, touchY };
 
-        text.Glyphs[index].TexRect.X = text.BaseRect.X + (number * text.GlyphOffset);
-        UpdateVertexData(text.Glyphs[index]);
-    }
-}
+    EntityId touched[8];
+    const uint32_t touchedCount = overlapEntities(touchBox, (uint32_t)CollisionLayer::Interface, touched, 8);
 
-void SetBitmapTextVerticalPos(BitmapText& text, const float position)
-{
-    for (uint32_t index = 0; index < text.GlyphCount; ++index) {
-        text.Glyphs[index].Position.Y = position;
-        UpdateVertexData(text.Glyphs[index]);
+    for (uint32_t index = 0; index < touchedCount; ++index)
+    {
+        if (touched[index] == sprite) {
+            return true;
+        }
     }
+
+    return false;
 }
 
-void SetBitmapTextVerticalColor(BitmapText& text, const uint32_t color)
+void RestartObjectsPosition()
 {
-    for (uint32_t index = 0; index < text.GlyphCount; ++index) {
-        text.Glyphs[index].Color = color;
-        UpdateVertexData(text.Glyphs[index]);
+    SetObjectAboveGround(dino);
+
+    for (uint32_t index = 0; index < g_maxCactus; ++index) {
+        PlaceObstacle(cactus[index], (g_gameWorkRes.X + 200.0f) * (index + 1));
     }
+
+    const Vec2 pterodactylPos = { g_gameWorkRes.X * (float)GenerateRandomNumRange(2, 6), getEntityPosition(pterodactyl).Y };
+    setEntityMotion(pterodactyl, pterodactylPos, GetScrollingVelocity(pterodactyl));
 }
 
 float Lerp(const float lhe, const float rhe, const float delta)
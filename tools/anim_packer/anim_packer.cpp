@@ -0,0 +1,148 @@
+// Animation Packer
+// Packs sprite animation clips into one binary file, frames of every clip end up in a single contiguous pool.
+//
+// Build (host):
+//   g++ -std=c++14 -O2 -I../../app/src/main/cpp/ThirdParty anim_packer.cpp -o anim_packer
+//
+// Usage:
+//   anim_packer <atlas.png> <clips.txt> <output.anim>
+//
+// The output layout is read by Engine/animation.cpp, keep both in sync.
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_STATIC
+#include "stb_image/stb_image.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+constexpr const uint32_t g_animationMagic = 0x4D494E41;    // "ANIM"
+constexpr const uint32_t g_animationVersion = 1;
+constexpr const uint32_t g_clipNameLength = 16;
+
+typedef struct {
+    char Name[g_clipNameLength];
+    uint16_t FirstFrame;
+    uint16_t FrameCount;
+    float FrameTime;
+    uint32_t Mode;      // 0 loop, 1 once
+} ClipRecord;
+
+typedef struct {
+    uint16_t X;
+    uint16_t Y;
+    uint16_t Width;
+    uint16_t Height;
+} FrameRecord;
+
+int main(int argc, char** argv)
+{
+    if (argc < 4) {
+        printf("Usage: %s <atlas.png> <clips.txt> <output.anim>\n", argv[0]);
+        return 1;
+    }
+
+    // Only the size is needed, UVs are normalized against it at load time
+    int32_t atlasWidth = 0;
+    int32_t atlasHeight = 0;
+
+    if (!stbi_info(argv[1], &atlasWidth, &atlasHeight, nullptr)) {
+        printf("Failed to load %s\n", argv[1]);
+        return 1;
+    }
+
+    FILE* clips = fopen(argv[2], "r");
+
+    if (clips == nullptr) {
+        printf("Failed to open %s\n", argv[2]);
+        return 1;
+    }
+
+    std::vector<ClipRecord> clipRecords;
+    std::vector<FrameRecord> frameRecords;
+    char line[256];
+
+    while (fgets(line, sizeof(line), clips))
+    {
+        char name[64];
+        char mode[16];
+        float frameTime;
+
+        uint32_t x, y, width, height;
+
+        if (sscanf(line, "clip %63s %15s %f", name, mode, &frameTime) == 3)
+        {
+            if (strlen(name) >= g_clipNameLength) {
+                printf("Clip name %s is longer than %u characters\n", name, g_clipNameLength - 1);
+                return 1;
+            }
+
+            if (strcmp(mode, "loop") != 0 && strcmp(mode, "once") != 0) {
+                printf("Clip %s has an unknown mode %s\n", name, mode);
+                return 1;
+            }
+
+            ClipRecord record;
+            memset(&record, 0, sizeof(record));
+
+            strcpy(record.Name, name);
+            record.FirstFrame = (uint16_t)frameRecords.size();
+            record.FrameTime  = frameTime;
+            record.Mode       = (strcmp(mode, "once") == 0) ? 1 : 0;
+
+            clipRecords.push_back(record);
+        }
+
+        else if (sscanf(line, "%u %u %u %u", &x, &y, &width, &height) == 4)
+        {
+            if (clipRecords.empty()) {
+                printf("Frame %u %u %u %u comes before any clip\n", x, y, width, height);
+                return 1;
+            }
+
+            if (x + width > (uint32_t)atlasWidth || y + height > (uint32_t)atlasHeight) {
+                printf("Frame %u %u %u %u is outside the atlas\n", x, y, width, height);
+                return 1;
+            }
+
+            frameRecords.push_back({ (uint16_t)x, (uint16_t)y, (uint16_t)width, (uint16_t)height });
+            clipRecords.back().FrameCount++;
+        }
+
+        // Anything else is a comment or a blank line
+    }
+
+    fclose(clips);
+
+    for (const ClipRecord& record : clipRecords)
+    {
+        if (record.FrameCount == 0) {
+            printf("Clip %s has no frames\n", record.Name);
+            return 1;
+        }
+
+        printf("Clip %s -> %u frames, %.2fs per frame, %s\n", record.Name, record.FrameCount, record.FrameTime,
+               record.Mode ? "once" : "loop");
+    }
+
+    FILE* output = fopen(argv[3], "wb");
+
+    if (output == nullptr) {
+        printf("Failed to create %s\n", argv[3]);
+        return 1;
+    }
+
+    const uint32_t header[] = { g_animationMagic, g_animationVersion, (uint32_t)clipRecords.size(), (uint32_t)frameRecords.size(),
+                                (uint32_t)atlasWidth, (uint32_t)atlasHeight };
+
+    fwrite(header, sizeof(header), 1, output);
+    fwrite(clipRecords.data(), sizeof(ClipRecord), clipRecords.size(), output);
+    fwrite(frameRecords.data(), sizeof(FrameRecord), frameRecords.size(), output);
+    fclose(output);
+
+    printf("%zu clips, %zu frames\n", clipRecords.size(), frameRecords.size());
+
+    return 0;
+}
\ No newline at end of file
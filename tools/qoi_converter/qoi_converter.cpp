@@ -0,0 +1,276 @@
+// QOI Converter
+// Re-encodes PNG textures as QOI, which the engine decodes several times faster than PNG at a similar size.
+//
+// Build (host):
+//   g++ -std=c++14 -O2 -I../../app/src/main/cpp/ThirdParty -I../../app/src/main/cpp/Engine
+//       qoi_converter.cpp ../../app/src/main/cpp/Engine/qoi.cpp -o qoi_converter
+//
+// Usage:
+//   qoi_converter <input.png> <output.qoi>
+//   qoi_converter --bench <input.png> <input.qoi> [iterations = 50]
+//
+// The benchmark decodes both files from memory with stbi_load_from_memory and the engine decoder,
+// so the numbers match what CreateTexture2D pays at startup.
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_STATIC
+#include "stb_image/stb_image.h"
+
+#include "qoi.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+constexpr const uint8_t g_opIndex = 0x00;
+constexpr const uint8_t g_opDiff  = 0x40;
+constexpr const uint8_t g_opLuma  = 0x80;
+constexpr const uint8_t g_opRun   = 0xC0;
+constexpr const uint8_t g_opRGB   = 0xFE;
+constexpr const uint8_t g_opRGBA  = 0xFF;
+constexpr const uint32_t g_maxRun = 62;
+
+typedef struct {
+    uint8_t R, G, B, A;
+} Pixel;
+
+bool operator==(const Pixel& lhe, const Pixel& rhe)
+{
+    return lhe.R == rhe.R && lhe.G == rhe.G && lhe.B == rhe.B && lhe.A == rhe.A;
+}
+
+uint32_t HashPixel(const Pixel& pixel)
+{
+    return (pixel.R * 3 + pixel.G * 5 + pixel.B * 7 + pixel.A * 11) % g_qoiIndexSize;
+}
+
+void WriteBigEndian32(std::vector<uint8_t>& output, const uint32_t value)
+{
+    output.push_back((uint8_t)(value >> 24));
+    output.push_back((uint8_t)(value >> 16));
+    output.push_back((uint8_t)(value >> 8));
+    output.push_back((uint8_t)value);
+}
+
+std::vector<uint8_t> EncodeQoi(const Pixel* pixels, const uint32_t width, const uint32_t height, const uint8_t channels)
+{
+    std::vector<uint8_t> output;
+    output.reserve(g_qoiHeaderSize + width * height * 5 + g_qoiPaddingSize);
+
+    WriteBigEndian32(output, g_qoiMagic);
+    WriteBigEndian32(output, width);
+    WriteBigEndian32(output, height);
+    output.push_back(channels);
+    output.push_back(0);    // sRGB with linear alpha
+
+    Pixel index[g_qoiIndexSize];
+    memset(index, 0, sizeof(index));
+
+    Pixel previous = { 0, 0, 0, 255 };
+    uint32_t run = 0;
+
+    const uint32_t count = width * height;
+
+    for (uint32_t position = 0; position < count; ++position)
+    {
+        const Pixel& pixel = pixels[position];
+
+        if (pixel == previous)
+        {
+            ++run;
+
+            if (run == g_maxRun || position + 1 == count) {
+                output.push_back(g_opRun | (uint8_t)(run - 1));
+                run = 0;
+            }
+
+            continue;
+        }
+
+        if (run > 0) {
+            output.push_back(g_opRun | (uint8_t)(run - 1));
+            run = 0;
+        }
+
+        const uint32_t hash = HashPixel(pixel);
+
+        if (index[hash] == pixel) {
+            output.push_back(g_opIndex | (uint8_t)hash);
+        }
+
+        else
+        {
+            index[hash] = pixel;
+
+            if (pixel.A == previous.A)
+            {
+                const int8_t deltaR = (int8_t)(pixel.R - previous.R);
+                const int8_t deltaG = (int8_t)(pixel.G - previous.G);
+                const int8_t deltaB = (int8_t)(pixel.B - previous.B);
+
+                const int8_t deltaRG = (int8_t)(deltaR - deltaG);
+                const int8_t deltaBG = (int8_t)(deltaB - deltaG);
+
+                if (deltaR >= -2 && deltaR <= 1 && deltaG >= -2 && deltaG <= 1 && deltaB >= -2 && deltaB <= 1) {
+                    output.push_back(g_opDiff | (uint8_t)((deltaR + 2) << 4 | (deltaG + 2) << 2 | (deltaB + 2)));
+                }
+
+                else if (deltaG >= -32 && deltaG <= 31 && deltaRG >= -8 && deltaRG <= 7 && deltaBG >= -8 && deltaBG <= 7) {
+                    output.push_back(g_opLuma | (uint8_t)(deltaG + 32));
+                    output.push_back((uint8_t)((deltaRG + 8) << 4 | (deltaBG + 8)));
+                }
+
+                else {
+                    output.push_back(g_opRGB);
+                    output.push_back(pixel.R);
+                    output.push_back(pixel.G);
+                    output.push_back(pixel.B);
+                }
+            }
+
+            else {
+                output.push_back(g_opRGBA);
+                output.push_back(pixel.R);
+                output.push_back(pixel.G);
+                output.push_back(pixel.B);
+                output.push_back(pixel.A);
+            }
+        }
+
+        previous = pixel;
+    }
+
+    for (uint32_t index = 0; index < g_qoiPaddingSize - 1; ++index) {
+        output.push_back(0);
+    } output.push_back(1);
+
+    return output;
+}
+
+bool ReadFile(const char* path, std::vector<uint8_t>& data)
+{
+    FILE* file = fopen(path, "rb");
+
+    if (!file) {
+        fprintf(stderr, "Unable to open %s\n", path);
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    data.resize((size_t)ftell(file));
+    fseek(file, 0, SEEK_SET);
+
+    const bool isRead = fread(data.data(), 1, data.size(), file) == data.size();
+    fclose(file);
+
+    return isRead;
+}
+
+int Convert(const char* inputPath, const char* outputPath)
+{
+    int32_t width, height, channels;
+    uint8_t* pixels = stbi_load(inputPath, &width, &height, &channels, 4);
+
+    if (!pixels) {
+        fprintf(stderr, "Unable to decode %s: %s\n", inputPath, stbi_failure_reason());
+        return 1;
+    }
+
+    const std::vector<uint8_t> encoded = EncodeQoi((const Pixel*)pixels, (uint32_t)width, (uint32_t)height,
+                                                   (channels == 3) ? 3 : 4);
+
+    // Round trip through the engine decoder before anything gets shipped
+    QoiDecoder decoder;
+    std::vector<uint8_t> decoded(4 * (size_t)width * height);
+
+    const bool isValid = CreateQoiDecoder(encoded.data(), (uint32_t)encoded.size(), decoder) &&
+                         DecodeQoiPixels(decoder, decoded.data(), (uint32_t)(width * height)) == (uint32_t)(width * height) &&
+                         memcmp(decoded.data(), pixels, decoded.size()) == 0;
+
+    stbi_image_free(pixels);
+
+    if (!isValid) {
+        fprintf(stderr, "Round trip mismatch for %s\n", inputPath);
+        return 1;
+    }
+
+    FILE* file = fopen(outputPath, "wb");
+
+    if (!file) {
+        fprintf(stderr, "Unable to create %s\n", outputPath);
+        return 1;
+    }
+
+    fwrite(encoded.data(), 1, encoded.size(), file);
+    fclose(file);
+
+    printf("%s: %dx%d, %u bytes\n", outputPath, width, height, (uint32_t)encoded.size());
+    return 0;
+}
+
+int Benchmark(const char* pngPath, const char* qoiPath, const uint32_t iterations)
+{
+    std::vector<uint8_t> png, qoi;
+
+    if (!ReadFile(pngPath, png) || !ReadFile(qoiPath, qoi)) {
+        return 1;
+    }
+
+    typedef std::chrono::high_resolution_clock Clock;
+
+    // PNG, the path CreateTexture2D used before
+    int32_t width = 0, height = 0;
+    const Clock::time_point pngStart = Clock::now();
+
+    for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+        stbi_image_free(stbi_load_from_memory(png.data(), (int32_t)png.size(), &width, &height, nullptr, 4));
+    }
+
+    const double pngSeconds = std::chrono::duration<double>(Clock::now() - pngStart).count();
+
+    // QOI, decoded straight into the destination buffer
+    std::vector<uint8_t> pixels(4 * (size_t)width * height);
+    const Clock::time_point qoiStart = Clock::now();
+
+    for (uint32_t iteration = 0; iteration < iterations; ++iteration)
+    {
+        QoiDecoder decoder;
+
+        if (!CreateQoiDecoder(qoi.data(), (uint32_t)qoi.size(), decoder) ||
+            decoder.Header.Width != (uint32_t)width || decoder.Header.Height != (uint32_t)height) {
+            fprintf(stderr, "%s doesn't match %s\n", qoiPath, pngPath);
+            return 1;
+        }
+
+        DecodeQoiPixels(decoder, pixels.data(), (uint32_t)(width * height));
+    }
+
+    const double qoiSeconds = std::chrono::duration<double>(Clock::now() - qoiStart).count();
+    const double megapixels = (double)width * height * iterations / 1000000.0;
+
+    printf("%dx%d, %u iterations\n", width, height, iterations);
+    printf("  png  %8u bytes  %8.3f ms/decode  %8.1f MP/s\n", (uint32_t)png.size(), 1000.0 * pngSeconds / iterations, megapixels / pngSeconds);
+    printf("  qoi  %8u bytes  %8.3f ms/decode  %8.1f MP/s\n", (uint32_t)qoi.size(), 1000.0 * qoiSeconds / iterations, megapixels / qoiSeconds);
+    printf("  speedup %.2fx\n", pngSeconds / qoiSeconds);
+
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc >= 4 && strcmp(argv[1], "--bench") == 0) {
+        const uint32_t iterations = (argc >= 5) ? (uint32_t)atoi(argv[4]) : 50;
+        return Benchmark(argv[2], argv[3], (iterations > 0) ? iterations : 1);
+    }
+
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <input.png> <output.qoi>\n", argv[0]);
+        fprintf(stderr, "       %s --bench <input.png> <input.qoi> [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    return Convert(argv[1], argv[2]);
+}
\ No newline at end of file
@@ -0,0 +1,421 @@
+// SDF Font
+// Turns the glyphs of a BMFont page into a signed distance field atlas, so one small texture draws sharp text at any scale
+// and the engine can add outlines and shadows in the pixel shader.
+//
+// Build (host):
+//   g++ -std=c++14 -O2 -I../../app/src/main/cpp/ThirdParty sdf_font.cpp -o sdf_font
+//
+// Usage:
+//   sdf_font <font.fnt> <page.png> <output.fnt> <output.qoi> [spread = 4] [downsample = 1] [upsample = 1] [atlas width = 256]
+//
+// The source page is thresholded at half alpha. Large renders are shrunk by the downsample factor, small pixel art is
+// magnified by the upsample factor first (nearest, so corners stay square). Spread is the distance range in output texels
+// on each side of the edge, glyphs get that much padding and the engine reads it from the "sdf" line of the descriptor.
+// The atlas holds the distance in every channel, 128 is the edge, the engine imports it as luminance-alpha.
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_STATIC
+#include "stb_image/stb_image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+constexpr const uint32_t g_qoiIndexSize = 64;
+constexpr const uint32_t g_maxRun = 62;
+
+typedef struct {
+    uint32_t Id;
+    int32_t X, Y, Width, Height;
+    int32_t OffsetX, OffsetY, Advance;
+    int32_t Page;
+    std::vector<uint8_t> Field;     // Output texels, padding included
+    int32_t FieldWidth, FieldHeight;
+    int32_t AtlasX, AtlasY;
+} Glyph;
+
+typedef struct {
+    uint32_t First, Second;
+    int32_t Amount;
+} Kerning;
+
+int32_t ReadValue(const char* line, const char* key, const int32_t fallback = 0)
+{
+    char pattern[32];
+    snprintf(pattern, sizeof(pattern), " %s=", key);
+
+    const char* found = strstr(line, pattern);
+    return found ? (int32_t)strtol(found + strlen(pattern), nullptr, 10) : fallback;
+}
+
+bool StartsWith(const char* line, const char* tag)
+{
+    const size_t length = strlen(tag);
+    return strncmp(line, tag, length) == 0 && (line[length] == ' ' || line[length] == '\t');
+}
+
+// Metrics keep the sign when they are scaled down, -1 / 4 has to stay below zero
+int32_t ScaleMetric(const int32_t value, const int32_t upsample, const int32_t downsample)
+{
+    return (int32_t)floor((double)value * upsample / downsample + 0.5);
+}
+
+// Brute force over the neighbourhood the spread can reach, fine for a host tool and exact on pixel art
+void BuildField(Glyph& glyph, const uint8_t* pixels, const int32_t pageWidth, const int32_t spread,
+                const int32_t downsample, const int32_t upsample)
+{
+    // Work grid: the source region magnified by upsample, one output texel is downsample work cells wide
+    const int32_t workWidth  = glyph.Width * upsample;
+    const int32_t workHeight = glyph.Height * upsample;
+
+    std::vector<uint8_t> inside(workWidth * workHeight);
+
+    for (int32_t y = 0; y < workHeight; ++y)
+    {
+        for (int32_t x = 0; x < workWidth; ++x)
+        {
+            const int32_t sourceX = glyph.X + x / upsample;
+            const int32_t sourceY = glyph.Y + y / upsample;
+
+            inside[y * workWidth + x] = pixels[(sourceY * pageWidth + sourceX) * 4 + 3] >= 128;
+        }
+    }
+
+    glyph.FieldWidth  = (workWidth + downsample - 1) / downsample + 2 * spread;
+    glyph.FieldHeight = (workHeight + downsample - 1) / downsample + 2 * spread;
+    glyph.Field.assign(glyph.FieldWidth * glyph.FieldHeight, 0);
+
+    const int32_t radius = spread * downsample;
+
+    for (int32_t texelY = 0; texelY < glyph.FieldHeight; ++texelY)
+    {
+        for (int32_t texelX = 0; texelX < glyph.FieldWidth; ++texelX)
+        {
+            // Texel center in work cells, the padding sits outside the region
+            const double centerX = (texelX - spread + 0.5) * downsample;
+            const double centerY = (texelY - spread + 0.5) * downsample;
+
+            const int32_t cellX = (int32_t)floor(centerX);
+            const int32_t cellY = (int32_t)floor(centerY);
+
+            const bool isInside = cellX >= 0 && cellY >= 0 && cellX < workWidth && cellY < workHeight &&
+                                  inside[cellY * workWidth + cellX];
+
+            double closest = (double)radius;
+
+            for (int32_t y = cellY - radius; y <= cellY + radius; ++y)
+            {
+                for (int32_t x = cellX - radius; x <= cellX + radius; ++x)
+                {
+                    const bool cell = x >= 0 && y >= 0 && x < workWidth && y < workHeight && inside[y * workWidth + x];
+
+                    if (cell == isInside) {
+                        continue;
+                    }
+
+                    // Distance to the nearest point of the opposite cell, edges lie between cells
+                    const double dx = std::max(std::max((double)x - centerX, centerX - (x + 1.0)), 0.0);
+                    const double dy = std::max(std::max((double)y - centerY, centerY - (y + 1.0)), 0.0);
+
+                    closest = std::min(closest, sqrt(dx * dx + dy * dy));
+                }
+            }
+
+            const double distance = (isInside ? closest : -closest) / radius;     // -1 to 1 across the spread
+            glyph.Field[texelY * glyph.FieldWidth + texelX] = (uint8_t)std::min(std::max(128.0 + distance * 127.0, 0.0), 255.0);
+        }
+    }
+}
+
+// Shelves of decreasing height, returns the atlas height rounded up to a power of two
+int32_t PackGlyphs(std::vector<Glyph*>& glyphs, const int32_t atlasWidth)
+{
+    std::sort(glyphs.begin(), glyphs.end(), [](const Glyph* lhe, const Glyph* rhe) {
+        return lhe->FieldHeight > rhe->FieldHeight;
+    });
+
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t shelfHeight = 0;
+
+    for (Glyph* glyph : glyphs)
+    {
+        if (x + glyph->FieldWidth > atlasWidth) {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+
+        glyph->AtlasX = x;
+        glyph->AtlasY = y;
+
+        x += glyph->FieldWidth;
+        shelfHeight = std::max(shelfHeight, glyph->FieldHeight);
+    }
+
+    int32_t height = 1;
+
+    while (height < y + shelfHeight) {
+        height *= 2;
+    }
+
+    return height;
+}
+
+void WriteBigEndian32(std::vector<uint8_t>& output, const uint32_t value)
+{
+    output.push_back((uint8_t)(value >> 24));
+    output.push_back((uint8_t)(value >> 16));
+    output.push_back((uint8_t)(value >> 8));
+    output.push_back((uint8_t)value);
+}
+
+// Greyscale RGBA, only runs, index hits and full pixels are needed for it
+std::vector<uint8_t> EncodeQoi(const std::vector<uint8_t>& field, const uint32_t width, const uint32_t height)
+{
+    std::vector<uint8_t> output = { 'q', 'o', 'i', 'f' };
+
+    WriteBigEndian32(output, width);
+    WriteBigEndian32(output, height);
+    output.push_back(4);
+    output.push_back(0);
+
+    uint8_t index[g_qoiIndexSize];
+    memset(index, 0, sizeof(index));
+
+    uint8_t previous = 0;
+    bool hasPrevious = false;
+    uint32_t run = 0;
+
+    for (size_t texel = 0; texel < field.size(); ++texel)
+    {
+        const uint8_t value = field[texel];
+
+        // The decoder starts from opaque black, which a grey pixel never equals
+        if (hasPrevious && value == previous)
+        {
+            if (++run == g_maxRun) {
+                output.push_back((uint8_t)(0xC0 | (run - 1)));
+                run = 0;
+            }
+
+            continue;
+        }
+
+        if (run > 0) {
+            output.push_back((uint8_t)(0xC0 | (run - 1)));
+            run = 0;
+        }
+
+        const uint32_t hash = (value * 3 + value * 5 + value * 7 + value * 11) % g_qoiIndexSize;
+
+        if (index[hash] == value && value != 0) {
+            output.push_back((uint8_t)hash);
+        } else {
+            output.push_back(0xFF);
+            output.push_back(value);
+            output.push_back(value);
+            output.push_back(value);
+            output.push_back(value);
+        }
+
+        index[hash] = value;
+        previous = value;
+        hasPrevious = true;
+    }
+
+    if (run > 0) {
+        output.push_back((uint8_t)(0xC0 | (run - 1)));
+    }
+
+    const uint8_t padding[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+    output.insert(output.end(), padding, padding + sizeof(padding));
+
+    return output;
+}
+
+const char* GetFileName(const char* path)
+{
+    const char* slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 5) {
+        printf("Usage: %s <font.fnt> <page.png> <output.fnt> <output.qoi> [spread = 4] [downsample = 1] [upsample = 1] [atlas width = 256]\n", argv[0]);
+        return 1;
+    }
+
+    const int32_t spread     = (argc > 5) ? atoi(argv[5]) : 4;
+    const int32_t downsample = (argc > 6) ? atoi(argv[6]) : 1;
+    const int32_t upsample   = (argc > 7) ? atoi(argv[7]) : 1;
+    const int32_t atlasWidth = (argc > 8) ? atoi(argv[8]) : 256;
+
+    if (spread < 1 || downsample < 1 || upsample < 1 || atlasWidth < 1) {
+        printf("Spread, downsample, upsample and atlas width must be positive\n");
+        return 1;
+    }
+
+    FILE* descriptor = fopen(argv[1], "r");
+
+    if (descriptor == nullptr) {
+        printf("Failed to open %s\n", argv[1]);
+        return 1;
+    }
+
+    int32_t pageWidth = 0;
+    int32_t pageHeight = 0;
+
+    uint8_t* pixels = stbi_load(argv[2], &pageWidth, &pageHeight, nullptr, 4);
+
+    if (pixels == nullptr) {
+        printf("Failed to load %s\n", argv[2]);
+        return 1;
+    }
+
+    std::vector<Glyph> glyphs;
+    std::vector<Kerning> kernings;
+
+    int32_t lineHeight = 0;
+    int32_t base = 0;
+    char face[128] = "";
+    char line[512];
+
+    while (fgets(line, sizeof(line), descriptor))
+    {
+        if (StartsWith(line, "info"))
+        {
+            const char* found = strstr(line, "face=\"");
+
+            if (found) {
+                sscanf(found + 6, "%127[^\"]", face);
+            }
+        }
+
+        else if (StartsWith(line, "common"))
+        {
+            lineHeight = ReadValue(line, "lineHeight");
+            base = ReadValue(line, "base");
+        }
+
+        else if (StartsWith(line, "char"))
+        {
+            Glyph glyph;
+
+            glyph.Id      = (uint32_t)ReadValue(line, "id");
+            glyph.X       = ReadValue(line, "x");
+            glyph.Y       = ReadValue(line, "y");
+            glyph.Width   = ReadValue(line, "width");
+            glyph.Height  = ReadValue(line, "height");
+            glyph.OffsetX = ReadValue(line, "xoffset");
+            glyph.OffsetY = ReadValue(line, "yoffset");
+            glyph.Advance = ReadValue(line, "xadvance");
+            glyph.Page    = ReadValue(line, "page");
+
+            if (glyph.Page != 0) {
+                printf("Glyph %u is on page %d, only the first page is converted\n", glyph.Id, glyph.Page);
+                continue;
+            }
+
+            if (glyph.X + glyph.Width > pageWidth || glyph.Y + glyph.Height > pageHeight) {
+                printf("Glyph %u is outside the page, skipped\n", glyph.Id);
+                continue;
+            }
+
+            glyph.FieldWidth = glyph.FieldHeight = 0;
+            glyph.AtlasX = glyph.AtlasY = 0;
+
+            glyphs.push_back(glyph);
+        }
+
+        else if (StartsWith(line, "kerning"))
+        {
+            kernings.push_back({ (uint32_t)ReadValue(line, "first"), (uint32_t)ReadValue(line, "second"), ReadValue(line, "amount") });
+        }
+    }
+
+    fclose(descriptor);
+
+    std::vector<Glyph*> packed;
+
+    for (Glyph& glyph : glyphs)
+    {
+        // Blank glyphs only carry their advance
+        if (glyph.Width > 0 && glyph.Height > 0) {
+            BuildField(glyph, pixels, pageWidth, spread, downsample, upsample);
+            packed.push_back(&glyph);
+        }
+    }
+
+    stbi_image_free(pixels);
+
+    const int32_t atlasHeight = PackGlyphs(packed, atlasWidth);
+    std::vector<uint8_t> atlas(atlasWidth * atlasHeight, 0);
+
+    for (const Glyph* glyph : packed)
+    {
+        for (int32_t y = 0; y < glyph->FieldHeight; ++y) {
+            memcpy(&atlas[(glyph->AtlasY + y) * atlasWidth + glyph->AtlasX], &glyph->Field[y * glyph->FieldWidth], glyph->FieldWidth);
+        }
+    }
+
+    const std::vector<uint8_t> image = EncodeQoi(atlas, atlasWidth, atlasHeight);
+    FILE* imageFile = fopen(argv[4], "wb");
+
+    if (imageFile == nullptr) {
+        printf("Failed to create %s\n", argv[4]);
+        return 1;
+    }
+
+    fwrite(image.data(), 1, image.size(), imageFile);
+    fclose(imageFile);
+
+    FILE* output = fopen(argv[3], "w");
+
+    if (output == nullptr) {
+        printf("Failed to create %s\n", argv[3]);
+        return 1;
+    }
+
+    // Metrics are in atlas texels, the padding is folded into the offsets so layouts don't change
+    fprintf(output, "info face=\"%s\" size=%d unicode=1 padding=%d,%d,%d,%d spacing=0,0\n", face,
+            ScaleMetric(lineHeight, upsample, downsample), spread, spread, spread, spread);
+    fprintf(output, "common lineHeight=%d base=%d scaleW=%d scaleH=%d pages=1 packed=0\n",
+            ScaleMetric(lineHeight, upsample, downsample), ScaleMetric(base, upsample, downsample), atlasWidth, atlasHeight);
+    fprintf(output, "page id=0 file=\"%s\"\n", GetFileName(argv[4]));
+    fprintf(output, "sdf spread=%d\n", spread);
+    fprintf(output, "chars count=%u\n", (uint32_t)glyphs.size());
+
+    for (const Glyph& glyph : glyphs)
+    {
+        const bool isBlank = glyph.FieldWidth == 0;
+
+        fprintf(output, "char id=%u x=%d y=%d width=%d height=%d xoffset=%d yoffset=%d xadvance=%d page=0 chnl=15\n",
+                glyph.Id, glyph.AtlasX, glyph.AtlasY, glyph.FieldWidth, glyph.FieldHeight,
+                ScaleMetric(glyph.OffsetX, upsample, downsample) - (isBlank ? 0 : spread),
+                ScaleMetric(glyph.OffsetY, upsample, downsample) - (isBlank ? 0 : spread),
+                ScaleMetric(glyph.Advance, upsample, downsample));
+    }
+
+    if (!kernings.empty())
+    {
+        fprintf(output, "kernings count=%u\n", (uint32_t)kernings.size());
+
+        for (const Kerning& kerning : kernings) {
+            fprintf(output, "kerning first=%u second=%u amount=%d\n", kerning.First, kerning.Second,
+                    ScaleMetric(kerning.Amount, upsample, downsample));
+        }
+    }
+
+    fclose(output);
+
+    printf("%u glyphs, %u kernings -> %dx%d atlas, %u bytes\n", (uint32_t)glyphs.size(), (uint32_t)kernings.size(),
+           atlasWidth, atlasHeight, (uint32_t)image.size());
+
+    return 0;
+}
@@ -0,0 +1,321 @@
+// Sprite Mesher
+// Traces the alpha of atlas regions into tight convex polygons, so sprites stop rasterizing their transparent corners.
+//
+// Build (host):
+//   g++ -std=c++14 -O2 -I../../app/src/main/cpp/ThirdParty sprite_mesher.cpp -o sprite_mesher
+//
+// Usage:
+//   sprite_mesher <atlas.png> <regions.txt> <output.mesh> [vertex budget = 8] [alpha threshold = 0]
+//
+// The output layout is read by Engine/sprite_mesh.cpp, keep both in sync.
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_STATIC
+#include "stb_image/stb_image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+constexpr const uint32_t g_meshMagic = 0x48534D53;    // "SMSH"
+constexpr const uint32_t g_meshVersion = 1;
+constexpr const uint32_t g_maxMeshVertices = 8;
+constexpr const float g_minAreaGain = 0.1f;          // Below 10% savings the plain quad is kept
+
+typedef struct {
+    double X;
+    double Y;
+} Point;
+
+typedef struct {
+    float X;
+    float Y;
+    uint32_t Width;
+    uint32_t Height;
+    uint32_t VertexCount;
+    float Vertices[g_maxMeshVertices][2];
+} MeshRecord;
+
+double CrossZ(const Point& origin, const Point& lhe, const Point& rhe)
+{
+    return (lhe.X - origin.X) * (rhe.Y - origin.Y) - (lhe.Y - origin.Y) * (rhe.X - origin.X);
+}
+
+double PolygonArea(const std::vector<Point>& polygon)
+{
+    double area = 0.0;
+
+    for (size_t index = 0; index < polygon.size(); ++index)
+    {
+        const Point& current = polygon[index];
+        const Point& next = polygon[(index + 1) % polygon.size()];
+
+        area += current.X * next.Y - next.X * current.Y;
+    }
+
+    return fabs(area) * 0.5;
+}
+
+// Andrew's monotone chain, counter-clockwise without collinear points
+std::vector<Point> ConvexHull(std::vector<Point> points)
+{
+    std::sort(points.begin(), points.end(), [](const Point& lhe, const Point& rhe) {
+        return lhe.X < rhe.X || (lhe.X == rhe.X && lhe.Y < rhe.Y);
+    });
+
+    if (points.size() < 3) {
+        return points;
+    }
+
+    std::vector<Point> hull(2 * points.size());
+    size_t count = 0;
+
+    for (size_t index = 0; index < points.size(); ++index)
+    {
+        while (count >= 2 && CrossZ(hull[count - 2], hull[count - 1], points[index]) <= 0.0) {
+            --count;
+        }
+
+        hull[count++] = points[index];
+    }
+
+    for (size_t index = points.size() - 1, lower = count + 1; index-- > 0;)
+    {
+        while (count >= lower && CrossZ(hull[count - 2], hull[count - 1], points[index]) <= 0.0) {
+            --count;
+        }
+
+        hull[count++] = points[index];
+    }
+
+    hull.resize(count - 1);
+    return hull;
+}
+
+bool IntersectLines(const Point& a0, const Point& a1, const Point& b0, const Point& b1, Point& result)
+{
+    const double denom = (a1.X - a0.X) * (b1.Y - b0.Y) - (a1.Y - a0.Y) * (b1.X - b0.X);
+
+    if (fabs(denom) < 1e-9) {
+        return false;
+    }
+
+    const double t = ((b0.X - a0.X) * (b1.Y - b0.Y) - (b0.Y - a0.Y) * (b1.X - b0.X)) / denom;
+    result = { a0.X + t * (a1.X - a0.X), a0.Y + t * (a1.Y - a0.Y) };
+
+    return true;
+}
+
+// Removes edges of the convex hull by extending both neighbour edges until they meet.
+// The polygon only grows, so it keeps covering every opaque pixel.
+bool ReduceHull(std::vector<Point>& hull, const uint32_t budget, const double width, const double height)
+{
+    while (hull.size() > budget)
+    {
+        const size_t count = hull.size();
+
+        size_t bestEdge = count;
+        double bestGrowth = 0.0;
+        Point bestPoint = { 0.0, 0.0 };
+
+        for (size_t edge = 0; edge < count; ++edge)
+        {
+            // Edge goes from p1 to p2, the neighbours are p0 -> p1 and p2 -> p3
+            const Point& p0 = hull[(edge + count - 1) % count];
+            const Point& p1 = hull[edge];
+            const Point& p2 = hull[(edge + 1) % count];
+            const Point& p3 = hull[(edge + 2) % count];
+
+            Point apex;
+
+            if (!IntersectLines(p0, p1, p3, p2, apex)) {
+                continue;
+            }
+
+            // The apex has to lie beyond the removed edge, otherwise the neighbours diverge
+            if (CrossZ(p1, p2, apex) > 0.0) {
+                continue;
+            }
+
+            // Vertices leaving the region would sample neighbouring atlas sprites
+            if (apex.X < -1e-6 || apex.Y < -1e-6 || apex.X > width + 1e-6 || apex.Y > height + 1e-6) {
+                continue;
+            }
+
+            const double growth = fabs(CrossZ(p1, p2, apex)) * 0.5;
+
+            if (bestEdge == count || growth < bestGrowth) {
+                bestEdge = edge;
+                bestGrowth = growth;
+                bestPoint = apex;
+            }
+        }
+
+        if (bestEdge == count) {
+            return false;
+        }
+
+        hull[bestEdge] = bestPoint;
+        hull.erase(hull.begin() + (bestEdge + 1) % count);
+    }
+
+    return true;
+}
+
+bool BuildMesh(const uint8_t* pixels, const int32_t atlasWidth, MeshRecord& record, const uint32_t budget, const uint8_t threshold)
+{
+    std::vector<Point> points;
+
+    // The outermost opaque pixel corners of each row are enough to build the hull
+    for (uint32_t y = 0; y < record.Height; ++y)
+    {
+        int32_t first = -1;
+        int32_t last = -1;
+
+        for (uint32_t x = 0; x < record.Width; ++x)
+        {
+            const uint32_t atlasX = (uint32_t)record.X + x;
+            const uint32_t atlasY = (uint32_t)record.Y + y;
+
+            if (pixels[4 * (atlasY * atlasWidth + atlasX) + 3] > threshold)
+            {
+                if (first < 0) {
+                    first = (int32_t)x;
+                }
+
+                last = (int32_t)x;
+            }
+        }
+
+        if (first >= 0)
+        {
+            points.push_back({ (double)first, (double)y });
+            points.push_back({ (double)first, (double)y + 1.0 });
+            points.push_back({ (double)last + 1.0, (double)y });
+            points.push_back({ (double)last + 1.0, (double)y + 1.0 });
+        }
+    }
+
+    const double width = (double)record.Width;
+    const double height = (double)record.Height;
+
+    std::vector<Point> hull = ConvexHull(points);
+
+    if (hull.size() < 3 || !ReduceHull(hull, budget, width, height)) {
+        return false;
+    }
+
+    if (PolygonArea(hull) > (1.0 - g_minAreaGain) * width * height) {
+        return false;
+    }
+
+    record.VertexCount = (uint32_t)hull.size();
+
+    for (uint32_t index = 0; index < record.VertexCount; ++index)
+    {
+        record.Vertices[index][0] = (float)(hull[index].X / width);
+        record.Vertices[index][1] = (float)(hull[index].Y / height);
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 4) {
+        printf("Usage: %s <atlas.png> <regions.txt> <output.mesh> [vertex budget = 8] [alpha threshold = 0]\n", argv[0]);
+        return 1;
+    }
+
+    const uint32_t budget = (argc > 4) ? (uint32_t)atoi(argv[4]) : g_maxMeshVertices;
+    const uint8_t threshold = (argc > 5) ? (uint8_t)atoi(argv[5]) : 0;
+
+    if (budget < 3 || budget > g_maxMeshVertices) {
+        printf("Vertex budget must be between 3 and %d\n", g_maxMeshVertices);
+        return 1;
+    }
+
+    int32_t atlasWidth = 0;
+    int32_t atlasHeight = 0;
+
+    uint8_t* pixels = stbi_load(argv[1], &atlasWidth, &atlasHeight, nullptr, 4);
+
+    if (pixels == nullptr) {
+        printf("Failed to load %s\n", argv[1]);
+        return 1;
+    }
+
+    FILE* regions = fopen(argv[2], "r");
+
+    if (regions == nullptr) {
+        printf("Failed to open %s\n", argv[2]);
+        return 1;
+    }
+
+    std::vector<MeshRecord> records;
+    char line[256];
+
+    double quadArea = 0.0;
+    double meshArea = 0.0;
+
+    while (fgets(line, sizeof(line), regions))
+    {
+        MeshRecord record;
+        memset(&record, 0, sizeof(record));
+
+        if (sscanf(line, "%f %f %u %u", &record.X, &record.Y, &record.Width, &record.Height) != 4) {
+            continue;   // Comment or blank line
+        }
+
+        if (record.X + record.Width > atlasWidth || record.Y + record.Height > atlasHeight) {
+            printf("Region %.0f %.0f %u %u is outside the atlas, skipped\n", record.X, record.Y, record.Width, record.Height);
+            continue;
+        }
+
+        const double area = (double)record.Width * record.Height;
+
+        if (!BuildMesh(pixels, atlasWidth, record, budget, threshold)) {
+            printf("Region %.0f %.0f %u %u keeps its quad\n", record.X, record.Y, record.Width, record.Height);
+            continue;
+        }
+
+        std::vector<Point> polygon;
+
+        for (uint32_t index = 0; index < record.VertexCount; ++index) {
+            polygon.push_back({ record.Vertices[index][0] * (double)record.Width, record.Vertices[index][1] * (double)record.Height });
+        }
+
+        quadArea += area;
+        meshArea += PolygonArea(polygon);
+
+        printf("Region %.0f %.0f %u %u -> %u vertices, %.1f%% of the quad\n", record.X, record.Y, record.Width, record.Height,
+               record.VertexCount, 100.0 * PolygonArea(polygon) / area);
+
+        records.push_back(record);
+    }
+
+    fclose(regions);
+    stbi_image_free(pixels);
+
+    FILE* output = fopen(argv[3], "wb");
+
+    if (output == nullptr) {
+        printf("Failed to create %s\n", argv[3]);
+        return 1;
+    }
+
+    const uint32_t header[] = { g_meshMagic, g_meshVersion, (uint32_t)records.size() };
+
+    fwrite(header, sizeof(header), 1, output);
+    fwrite(records.data(), sizeof(MeshRecord), records.size(), output);
+    fclose(output);
+
+    if (quadArea > 0.0) {
+        printf("%zu meshes, %.1f%% of the quad pixels remain\n", records.size(), 100.0 * meshArea / quadArea);
+    }
+
+    return 0;
+}